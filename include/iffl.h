@@ -10,9 +10,28 @@
 //! @brief Includes all other header that are part of Intrusive Flat Forward List library
 //!        If you want to include only list and not allocator then include iffl_list.h.
 //!        If you want to include everything then simply include this header.
+//!        Headers that depend on platform specific APIs are not included here,
+//!        and have to be included explicitly:
+//!        - iffl_mapped_file.h - memory resource that keeps buffer in a file mapping.
+//!        - iffl_io.h - helpers that read and write lists to file descriptors.
+//!        - iffl_shm_ring.h - ring buffer that passes elements between processes.
+//!        - iffl_coroutine.h - coroutines that pass batches between pipeline stages.
+//!          Requires C++20 coroutines.
+//!        - iffl_numa.h - NUMA memory resource and NUMA aware parallel algorithms.
+//!        - iffl_constexpr_list.h - lists built at compile time.
+//!          Requires __builtin_bit_cast.
 //!
 
 #include <iffl_config.h>
 #include <iffl_common.h>
 #include <iffl_list.h>
+#include <iffl_traits_builder.h>
+#include <iffl_small_list.h>
+#include <iffl_static_list.h>
+#include <iffl_variant_list.h>
+#include <iffl_nested_list.h>
+#include <iffl_aligned_view.h>
+#include <iffl_compact.h>
 #include <iffl_allocator.h>
+#include <iffl_concurrent.h>
+#include <iffl_parallel.h>
@@ -0,0 +1,465 @@
+#pragma once
+
+//!
+//! @file iffl_aligned_view.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements flat_forward_list_aligned_view, a view
+//!        that gives out aligned references to elements of a list that
+//!        is not aligned, and flat_forward_list_realign, that copies such
+//!        list to an aligned container.
+//!
+//! @details When caller does not align elements, traits use alignment 1,
+//!          and every access to a field goes through a pointer annotated
+//!          with FFL_UNALIGNED. Depending on the platform, that either
+//!          compiles to byte-wise loads, or is slow when element crosses a
+//!          cache line.
+//!
+//!          flat_forward_list_aligned_view checks address of each element
+//!          when iterator is dereferenced. If element is aligned for T, then
+//!          iterator returns reference to the element in the buffer.
+//!          Otherwise it copies element to an aligned buffer, and returns
+//!          reference to the copy. Elements that are not larger than
+//!          INLINE_SIZE are copied to a buffer inside of the iterator.
+//!          Larger elements are copied to a scratch buffer owned by the view.
+//!          Scratch buffer is allocated first time a large element needs a
+//!          copy, and is reused for all following elements.
+//!
+//! @code
+//! iffl::flat_forward_list_aligned_view<entry, unaligned_entry_traits> aligned{ view };
+//! for (entry const &e : aligned) {
+//!     // e is aligned for entry
+//! }
+//! @endcode
+//!
+//!          Copy is made once per element, so it pays off when loop reads
+//!          several fields of the element. References are read only, because
+//!          changes to a copy are not written back to the buffer.
+//!
+//!          When list is used more than once, it is cheaper to convert it
+//!          with flat_forward_list_realign. It walks the list once to
+//!          calculate size of the aligned buffer, allocates it, and then
+//!          copies each element once, adding padding and setting offsets
+//!          to the next element. parallel_realign in iffl_parallel.h does
+//!          the same on a set of threads.
+//!
+//! @code
+//! iffl::flat_forward_list<entry> aligned{ iffl::flat_forward_list_realign(view) };
+//! @endcode
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#include <array>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @class flat_forward_list_aligned_view
+//! @brief View that returns references to elements aligned for T.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam INLINE_SIZE - elements that are not larger than this
+//! are copied to a buffer in the iterator.
+//! @details View is not copyable, and it is not safe to use it
+//! from multiple threads, because iterators share the scratch buffer.
+//! Reference returned by an iterator is valid until iterator is
+//! changed or destroyed. Reference to a copy in the scratch buffer is
+//! valid until the next large element is copied.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          size_t INLINE_SIZE = 64>
+class flat_forward_list_aligned_view final {
+public:
+    //!
+    //! @typedef view_type
+    //! @brief Type of the view over elements that might be unaligned
+    //!
+    using view_type = flat_forward_list_view<T, TT>;
+    //!
+    //! @typedef traits
+    //! @brief Element type traits
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that reads traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef view_iterator
+    //! @brief Iterator of the view over elements that might be unaligned
+    //!
+    using view_iterator = typename view_type::const_iterator;
+    //!
+    //! @brief Alignment of references that iterators return
+    //!
+    constexpr static size_t const alignment{ alignof(T) };
+
+    //!
+    //! @class iterator
+    //! @brief Input iterator that returns aligned references
+    //!
+    class iterator final {
+    public:
+        //!
+        //! @typedef iterator_category
+        //! @brief References point to a buffer in the iterator, so
+        //! this is an input iterator.
+        //!
+        using iterator_category = std::input_iterator_tag;
+        //!
+        //! @typedef value_type
+        //! @brief Element value type
+        //!
+        using value_type = T;
+        //!
+        //! @typedef difference_type
+        //! @brief Element pointers difference type
+        //!
+        using difference_type = ptrdiff_t;
+        //!
+        //! @typedef pointer
+        //! @brief Pointer to element type
+        //!
+        using pointer = T const *;
+        //!
+        //! @typedef reference
+        //! @brief Reference to the element type
+        //!
+        using reference = T const &;
+        //!
+        //! @brief Constructs end iterator
+        //!
+        iterator() noexcept = default;
+        //!
+        //! @brief Constructs iterator
+        //! @param owner - view that owns scratch buffer
+        //! @param it - iterator that points to an element
+        //!
+        iterator(flat_forward_list_aligned_view *owner, view_iterator const &it) noexcept
+            : owner_{ owner }
+            , it_{ it } {
+        }
+        //!
+        //! @returns reference to the element, or to its aligned copy
+        //!
+        reference operator*() const noexcept {
+            return *get();
+        }
+        //!
+        //! @returns pointer to the element, or to its aligned copy
+        //!
+        pointer operator->() const noexcept {
+            return get();
+        }
+        //!
+        //! @brief Moves iterator to the next element
+        //! @returns reference to this iterator
+        //!
+        iterator &operator++() noexcept {
+            ++it_;
+            location_ = location::unknown;
+            return *this;
+        }
+        //!
+        //! @brief Moves iterator to the next element
+        //! @returns copy of the iterator before it was moved
+        //!
+        iterator operator++(int) noexcept {
+            iterator tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+        //!
+        //! @param other - iterator we are comparing to
+        //! @returns true if both iterators point to the same element
+        //!
+        bool operator== (iterator const &other) const noexcept {
+            return it_ == other.it_;
+        }
+        //!
+        //! @param other - iterator we are comparing to
+        //! @returns true if iterators point to different elements
+        //!
+        bool operator!= (iterator const &other) const noexcept {
+            return it_ != other.it_;
+        }
+        //!
+        //! @returns iterator that points to the element in the buffer
+        //!
+        view_iterator base() const noexcept {
+            return it_;
+        }
+        //!
+        //! @returns true if element is not aligned, and iterator
+        //! returns reference to a copy.
+        //!
+        bool is_copy() const noexcept {
+            get();
+            return location::in_place != location_;
+        }
+
+    private:
+        //!
+        //! @enum location
+        //! @brief Tells where reference points to
+        //!
+        enum class location {
+            //! Element was not dereferenced yet
+            unknown,
+            //! Element is aligned, and reference points to the buffer
+            in_place,
+            //! Reference points to a copy in the iterator
+            inline_copy,
+            //! Reference points to a copy in the scratch buffer
+            scratch_copy,
+        };
+        //!
+        //! @brief Copies element on the first dereference if
+        //! it is not aligned.
+        //! @returns pointer to the element, or to the aligned copy.
+        //! @details Pointer to the inline copy is computed on each call,
+        //! so it stays correct when iterator is copied.
+        //!
+        pointer get() const noexcept {
+            char const *const element{ it_.get_ptr() };
+            if (location::unknown == location_) {
+                if (roundup_ptr_to_alignment<T>(element) == element) {
+                    location_ = location::in_place;
+                } else {
+                    size_t const element_size{ traits_traits::get_size(element).size };
+                    if (element_size <= INLINE_SIZE) {
+                        copy_data(inline_buffer_.data(), element, element_size);
+                        location_ = location::inline_copy;
+                    } else {
+                        copy_data(owner_->scratch(element_size), element, element_size);
+                        location_ = location::scratch_copy;
+                    }
+                }
+            }
+            switch (location_) {
+            case location::inline_copy:
+                return reinterpret_cast<pointer>(inline_buffer_.data());
+            case location::scratch_copy:
+                return reinterpret_cast<pointer>(owner_->scratch_.get());
+            default:
+                return reinterpret_cast<pointer>(element);
+            }
+        }
+        //!
+        //! @brief View that owns the scratch buffer
+        //!
+        flat_forward_list_aligned_view *owner_{ nullptr };
+        //!
+        //! @brief Iterator that points to the element in the buffer
+        //!
+        view_iterator it_;
+        //!
+        //! @brief Tells where reference points to
+        //!
+        mutable location location_{ location::unknown };
+        //!
+        //! @brief Aligned copy of a small element
+        //!
+        alignas(T) mutable std::array<char, INLINE_SIZE> inline_buffer_;
+    };
+
+    //!
+    //! @brief Constructs aligned view
+    //! @param view - view over elements that might be unaligned
+    //! @param resource - memory resource used to allocate scratch buffer
+    //!
+    explicit flat_forward_list_aligned_view(view_type const &view,
+                                            FFL_PMR::memory_resource *resource = FFL_PMR::get_default_resource()) noexcept
+        : view_{ view }
+        , scratch_{ nullptr, scratch_deleter{ resource, 0 } } {
+    }
+
+    flat_forward_list_aligned_view(flat_forward_list_aligned_view const &) = delete;
+    flat_forward_list_aligned_view &operator= (flat_forward_list_aligned_view const &) = delete;
+    //!
+    //! @returns iterator that points to the first element
+    //!
+    iterator begin() noexcept {
+        return iterator{ this, view_.cbegin() };
+    }
+    //!
+    //! @returns iterator that points past the last element
+    //!
+    iterator end() noexcept {
+        return iterator{ this, view_.cend() };
+    }
+    //!
+    //! @returns view over elements that might be unaligned
+    //!
+    view_type const &view() const noexcept {
+        return view_;
+    }
+    //!
+    //! @returns size of the scratch buffer. It is 0 until a
+    //! large element needs a copy.
+    //!
+    size_t scratch_capacity() const noexcept {
+        return scratch_.get_deleter().size;
+    }
+
+private:
+    //!
+    //! @struct scratch_deleter
+    //! @brief Returns scratch buffer to the memory resource
+    //!
+    struct scratch_deleter {
+        //!
+        //! @brief Memory resource that allocated buffer
+        //!
+        FFL_PMR::memory_resource *resource;
+        //!
+        //! @brief Buffer size
+        //!
+        size_t size;
+        //!
+        //! @brief Deallocates buffer
+        //! @param buffer - buffer we are deallocating
+        //!
+        void operator() (char *buffer) const noexcept {
+            resource->deallocate(buffer, size, alignment);
+        }
+    };
+    //!
+    //! @brief Grows scratch buffer if it is smaller than size
+    //! @param size - size of the element we are copying
+    //! @returns scratch buffer
+    //! @details Iterators call it from noexcept methods, so
+    //! failure to allocate terminates the application.
+    //!
+    char *scratch(size_t size) {
+        scratch_deleter &deleter{ scratch_.get_deleter() };
+        if (deleter.size < size) {
+            size_t const new_size{ roundup_size_to_alignment(std::max(size, deleter.size * 2), alignment) };
+            scratch_.reset();
+            deleter.size = 0;
+            scratch_.reset(static_cast<char *>(deleter.resource->allocate(new_size, alignment)));
+            deleter.size = new_size;
+        }
+        return scratch_.get();
+    }
+    //!
+    //! @brief View over elements that might be unaligned
+    //!
+    view_type view_;
+    //!
+    //! @brief Buffer for copies of large elements
+    //!
+    std::unique_ptr<char, scratch_deleter> scratch_;
+};
+
+//!
+//! @brief Calculates size of the buffer for elements copied
+//! to a list with traits TT.
+//! @tparam TT - traits of the list we are copying to
+//! @tparam I - iterator of the list we are copying from
+//! @param first - first element we are copying
+//! @param end - element after the last element we are copying
+//! @returns size of the buffer. Elements are padded to TT alignment,
+//! except the last element.
+//!
+template <typename TT,
+          typename I>
+size_t flat_forward_list_realigned_size(I const &first,
+                                        I const &end) noexcept {
+    using value_type = std::remove_const_t<typename I::value_type>;
+    using traits_traits = flat_forward_list_traits_traits<value_type, TT>;
+    size_t size{ 0 };
+    for (I cur = first; cur != end; ++cur) {
+        size = traits_traits::roundup_to_alignment(size) +
+               I::traits_traits::get_size(cur.get_ptr()).size;
+    }
+    return size;
+}
+
+//!
+//! @brief Copies elements to a buffer with padding for traits TT.
+//! @tparam TT - traits of the list we are copying to
+//! @tparam I - iterator of the list we are copying from
+//! @param first - first element we are copying
+//! @param end - element after the last element we are copying
+//! @param buffer - aligned buffer of the size returned by
+//! flat_forward_list_realigned_size
+//! @param ends_list - true if last element we are copying is the
+//! last element of the list.
+//! @returns pointer to the last copied element
+//! @details Padding is filled with zeroes. If TT has offset to the
+//! next element, then it is set for each copied element, and it is
+//! 0 for the last element of the list.
+//!
+template <typename TT,
+          typename I>
+char *flat_forward_list_realign_copy(I const &first,
+                                     I const &end,
+                                     char *buffer,
+                                     bool ends_list) noexcept {
+    using value_type = std::remove_const_t<typename I::value_type>;
+    using traits_traits = flat_forward_list_traits_traits<value_type, TT>;
+    char *last{ nullptr };
+    for (I cur = first; cur != end;) {
+        size_t const element_size{ I::traits_traits::get_size(cur.get_ptr()).size };
+        copy_data(buffer, cur.get_ptr(), element_size);
+        last = buffer;
+        ++cur;
+        bool const is_last{ ends_list && cur == end };
+        size_t const next_offset{ is_last ? 0 : traits_traits::roundup_to_alignment(element_size) };
+        if constexpr (traits_traits::has_next_offset_v) {
+            traits_traits::set_next_offset(last, next_offset);
+        }
+        if (!is_last) {
+            zero_buffer(last + element_size, next_offset - element_size);
+        }
+        buffer += next_offset;
+    }
+    return last;
+}
+
+//!
+//! @brief Copies elements of a list that is not aligned to a list
+//! aligned for traits TT.
+//! @tparam T - element type
+//! @tparam STT - traits of the list we are copying from. Usually they
+//! have alignment 1, and read elements with unaligned pointers.
+//! @tparam TT - traits of the list we are copying to
+//! @tparam A - allocator type
+//! @param view - validated list we are copying from
+//! @param a - allocator of the new list
+//! @returns new list. Buffer is just large enough for all elements.
+//! @throw std::bad_alloc if buffer allocation fails
+//!
+template <typename T,
+          typename STT,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+flat_forward_list<T, TT, A> flat_forward_list_realign(flat_forward_list_view<T, STT> const &view,
+                                                      A const &a = A{}) {
+    using list_type = flat_forward_list<T, TT, A>;
+    using allocator_type_traits = typename list_type::allocator_type_traits;
+    if (view.empty()) {
+        return list_type{ a };
+    }
+    size_t const buffer_size{ flat_forward_list_realigned_size<TT>(view.cbegin(), view.cend()) };
+    typename list_type::allocator_type allocator{ a };
+    char *const buffer{ allocator_type_traits::allocate(allocator, buffer_size) };
+    FFL_CODDING_ERROR_IF(nullptr == buffer);
+    char *const last{ flat_forward_list_realign_copy<TT>(view.cbegin(), view.cend(), buffer, true) };
+    return list_type{ attach_buffer{}, buffer, last, buffer + buffer_size, std::move(allocator) };
+}
+
+} // namespace iffl
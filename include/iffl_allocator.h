@@ -14,6 +14,9 @@
 #include <iffl_config.h>
 #include <iffl_common.h>
 
+#include <atomic>
+#include <memory>
+
 //!
 //! @namespace iffl
 //! @brief intrusive flat forward list
@@ -259,7 +262,7 @@ private:
 //! Thread safety:
 //!
 //! This class is not thread safe and cannot be used to perform concurent 
-//! allocations from multiple threads.
+//! allocations from multiple threads. See concurrent_input_buffer_memory_resource.
 //!
 class input_buffer_memory_resource
     : public FFL_PMR::memory_resource {
@@ -348,4 +351,193 @@ private:
     size_t buffer_size_{ 0 };
 };
 
+//!
+//! @class concurrent_input_buffer_memory_resource
+//! @brief Thread safe variant of input_buffer_memory_resource.
+//! @details Same as input_buffer_memory_resource this memory resource
+//! hands out a buffer owned by someone else, and deallocation does not
+//! free the buffer. Ownership of the buffer is an atomic flag, so
+//! containers on different threads can allocate from the same resource.
+//! An allocation fails with std::bad_alloc while buffer is owned by
+//! another container, and succeeds again once that container deallocates
+//! buffer. Deallocation on one thread happens before the next allocation
+//! on another thread, so next owner sees data written by the previous one.
+//!
+//! In partitioned mode buffer is split into partition_count sub-buffers
+//! of the same size. Each allocation takes ownership of any free partition
+//! that is large enough, so several workers can fill disjoint parts of
+//! the buffer in parallel.
+//!
+//! Sample usage:
+//!
+//! @code
+//! void build_result(char *buffer, size_t buffer_size, size_t worker_count) {
+//!     iffl::concurrent_input_buffer_memory_resource buffer_memory_resource{ buffer, buffer_size, worker_count };
+//!     <on each worker>
+//!         iffl::pmr_flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl{ &buffer_memory_resource };
+//!         ffl.resize_buffer(buffer_memory_resource.partition_size());
+//!         while (ffl.try_push_back(<data>, <data_size>)) {
+//!         }
+//!         <hand off content of the partition>
+//! }
+//! @endcode
+//!
+//! Thread safety:
+//!
+//! Allocations and deallocations can be performed concurrently from
+//! multiple threads.
+//!
+class concurrent_input_buffer_memory_resource
+    : public FFL_PMR::memory_resource {
+
+public:
+    //!
+    //! @brief Constructs memory resource with information
+    //! about buffer that should be used for allocation
+    //! @param buffer - pointer to the buffer that we will return on allocation
+    //! @param buffer_size - size of the buffer
+    //! @param partition_count - number of sub-buffers that can be owned
+    //! by different containers at the same time.
+    //! @param partition_alignment - each partition size is rounded down to
+    //! this alignment so every partition starts at an aligned offset.
+    //! @throw std::bad_alloc if partition_count is greater than 1 and
+    //! allocating partition state fails.
+    //!
+    explicit concurrent_input_buffer_memory_resource(void *buffer,
+                                                     size_t buffer_size,
+                                                     size_t partition_count = 1,
+                                                     size_t partition_alignment = alignof(std::max_align_t))
+        : buffer_{ buffer }
+        , partition_count_{ buffer ? partition_count : 0 } {
+        FFL_CODDING_ERROR_IF(buffer && 0 == partition_count);
+        FFL_CODDING_ERROR_IF(0 == partition_alignment);
+        if (1 < partition_count_) {
+            partition_size_ = (buffer_size / partition_count_) / partition_alignment * partition_alignment;
+            used_partitions_.reset(new std::atomic<bool>[partition_count_]);
+            for (size_t idx = 0; idx < partition_count_; ++idx) {
+                used_partitions_[idx].store(false, std::memory_order_relaxed);
+            }
+        } else if (1 == partition_count_) {
+            partition_size_ = buffer_size;
+        }
+    }
+
+    //!
+    //! @brief Destructor verifies that there are no outstanding allocations
+    //!
+    ~concurrent_input_buffer_memory_resource() noexcept {
+        validate_no_busy_blocks();
+    }
+
+    //!
+    //! @brief Can be used to query number of outstanding allocations
+    //! @return number of outstanding allocations
+    //!
+    size_t get_busy_blocks_count() const noexcept {
+        size_t count{ 0 };
+        for (size_t idx = 0; idx < partition_count_; ++idx) {
+            if (partition_flag(idx).load(std::memory_order_acquire)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    //!
+    //! @brief Triggers fail fast if there are outstanding allocations
+    //!
+    void validate_no_busy_blocks() const noexcept {
+        FFL_CODDING_ERROR_IF(0 < get_busy_blocks_count());
+    }
+
+    //!
+    //! @return number of partitions
+    //!
+    size_t partition_count() const noexcept {
+        return partition_count_;
+    }
+
+    //!
+    //! @return size of each partition
+    //!
+    size_t partition_size() const noexcept {
+        return partition_size_;
+    }
+
+    //!
+    //! @param idx - index of the partition
+    //! @return pointer to the partition
+    //!
+    char *partition(size_t idx) const noexcept {
+        FFL_CODDING_ERROR_IF_NOT(idx < partition_count_);
+        return static_cast<char *>(buffer_) + idx * partition_size_;
+    }
+
+protected:
+
+    //!
+    //! @brief Overrides memory resource virtual method that performs allocation.
+    //! @param bytes - number of bytes to be allocated.
+    //! @param alignment - alignment requirements for the allocated buffer.
+    //! @throws std::bad_alloc if allocation fails
+    //! @return On success return a pointer to a free partition.
+    //!         On failure throws std::bad_alloc.
+    //!
+    void* do_allocate(size_t bytes, [[maybe_unused]] size_t alignment) override {
+        if (bytes <= partition_size_) {
+            for (size_t idx = 0; idx < partition_count_; ++idx) {
+                std::atomic<bool> &used{ partition_flag(idx) };
+                bool expected{ false };
+                if (!used.load(std::memory_order_relaxed) &&
+                    used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return partition(idx);
+                }
+            }
+        }
+        throw std::bad_alloc{};
+    }
+    //!
+    //! @brief Overrides memory resource virtual method that performs deallocation.
+    //! @param p - pointer to the user buffer that is deallocated.
+    //! @param bytes - buffer size. Mast match to the size that was allocated.
+    //! @param alignment - alignment of the buffer. Must match to alignment at allocation time.
+    //! @return void. Checks that deallocated buffer is one of the partitions,
+    //! and that partition was allocated. Triggers fail fast if check does not pass.
+    //!
+    void do_deallocate(void* p, size_t bytes, [[maybe_unused]] size_t alignment) noexcept override {
+        FFL_CODDING_ERROR_IF_NOT(buffer_ <= p && bytes <= partition_size_);
+        size_t const offset{ static_cast<size_t>(static_cast<char *>(p) - static_cast<char *>(buffer_)) };
+        size_t const idx{ partition_size_ ? offset / partition_size_ : 0 };
+        FFL_CODDING_ERROR_IF_NOT(idx < partition_count_ && partition(idx) == p);
+        bool const was_used{ partition_flag(idx).exchange(false, std::memory_order_release) };
+        FFL_CODDING_ERROR_IF_NOT(was_used);
+    }
+
+    //!
+    //! @brief Validates that two memory resources are equivalent.
+    //!        For this class they must be equal.
+    //! @param other - reference to the other memory resource.
+    //! @return true if other memory resource is the same object,
+    //!         and false otherwise.
+    //!
+    bool do_is_equal(memory_resource const & other) const noexcept override {
+        return (&other == this);
+    }
+
+private:
+    std::atomic<bool> &partition_flag(size_t idx) noexcept {
+        return used_partitions_ ? used_partitions_[idx] : used_;
+    }
+
+    std::atomic<bool> const &partition_flag(size_t idx) const noexcept {
+        return used_partitions_ ? used_partitions_[idx] : used_;
+    }
+
+    std::atomic<bool> used_{ false };
+    std::unique_ptr<std::atomic<bool>[]> used_partitions_;
+    void *buffer_{ nullptr };
+    size_t partition_count_{ 0 };
+    size_t partition_size_{ 0 };
+};
+
 } // namespace iffl
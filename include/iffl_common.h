@@ -110,6 +110,25 @@
 #define FFL_ALLIGNED_FREE(PTR) _aligned_free(PTR)
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+//!
+//! @brief Hints processor to bring memory at address P to the cache
+//!
+#define FFL_PREFETCH(P) __builtin_prefetch(P)
+#elif defined(_M_IX86) || defined(_M_X64)
+#include <xmmintrin.h>
+//!
+//! @brief In MSVC define to intrinsics that prefetches memory
+//! at address P to all levels of the cache
+//!
+#define FFL_PREFETCH(P) _mm_prefetch(reinterpret_cast<char const *>(P), _MM_HINT_T0)
+#else
+//!
+//! @brief Prefetch is a no-op on other platforms
+//!
+#define FFL_PREFETCH(P) ((void)(P))
+#endif
+
 //!
 //! @brief Fail fast with error code.
 //! @param EC - fail fast error code
@@ -0,0 +1,318 @@
+#pragma once
+
+//!
+//! @file iffl_compact.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements encoder and decoder of a compact
+//!        representation of a flat forward list, that is used to store
+//!        lists on disk, or to send them over the network.
+//!
+//! @details In memory every element has padding to the alignment, and
+//!          types with offset to the next element keep a full size
+//!          offset. Compact representation drops both:
+//!
+//!          - varint number of elements
+//!          - varint size of the buffer that decoder allocates. Elements
+//!            are padded to alignment, except the last element.
+//!          - one byte with compact_flags
+//!          - for each element, varint element size followed by
+//!            element bytes. With compact_flags::shared_prefix, varint
+//!            number of leading bytes shared with the previous element,
+//!            varint number of remaining bytes, and remaining bytes.
+//!
+//!          Varint is LEB128: 7 bits per byte, least significant first.
+//!          Encoder writes elements with offset to the next element set
+//!          to 0, so elements with the same header share more bytes.
+//!          Shared prefix helps when list is sorted by a key that is
+//!          close to the beginning of the element, like extended
+//!          attributes sorted by name.
+//!
+//! @code
+//! std::vector<char> blob;
+//! iffl::flat_forward_list_compact_encode(iffl::flat_forward_list_view<entry>{ list }, blob);
+//! ...
+//! iffl::flat_forward_list<entry> decoded;
+//! if (!iffl::flat_forward_list_compact_decode(blob.data(), blob.data() + blob.size(), decoded)) {
+//!     // corrupted blob
+//! }
+//! @endcode
+//!
+//!          Decoder allocates buffer once, and writes each element once
+//!          to its final position. Input might come from an untrusted
+//!          source, so decoder checks bounds of every field, and validates
+//!          each element as it writes it. Size of the buffer is limited
+//!          by the caller, see compact_default_max_buffer_size.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+#include <iffl_aligned_view.h>
+
+#include <vector>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Tells how elements are encoded
+//!
+enum class compact_flags : unsigned char {
+    //!
+    //! @brief Each element is written as size and bytes
+    //!
+    none = 0,
+    //!
+    //! @brief Element bytes that match beginning of the
+    //! previous element are not written.
+    //!
+    shared_prefix = 1,
+};
+
+//!
+//! @brief Default limit of the buffer that decoder allocates.
+//! @details Each element takes at least one byte of input, and
+//! cannot be larger than the input, so input of N bytes can ask
+//! for a buffer of about N * N bytes. Decoder rejects input that
+//! asks for a buffer larger than the limit before it allocates.
+//! Callers that expect larger lists pass their own limit.
+//!
+constexpr size_t const compact_default_max_buffer_size{ 64 * 1024 * 1024 };
+
+//!
+//! @brief Appends varint to the buffer
+//! @param buffer - buffer we are appending to
+//! @param value - value we are encoding
+//! @throw std::bad_alloc if buffer cannot grow
+//!
+inline void compact_write_varint(std::vector<char> &buffer, size_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+//!
+//! @brief Reads varint from the buffer
+//! @param cur - current position in the buffer. On success it is
+//! moved past the varint.
+//! @param end - end of the buffer
+//! @param value - decoded value
+//! @returns false if varint does not fit in the buffer, or
+//! value does not fit in size_t.
+//!
+inline bool compact_read_varint(char const *&cur, char const *end, size_t &value) noexcept {
+    value = 0;
+    for (unsigned int shift = 0; cur < end; shift += 7) {
+        size_t const byte{ static_cast<unsigned char>(*cur) };
+        ++cur;
+        if (shift >= std::numeric_limits<size_t>::digits ||
+            ((byte & 0x7F) << shift) >> shift != (byte & 0x7F)) {
+            return false;
+        }
+        value |= (byte & 0x7F) << shift;
+        if (0 == (byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//!
+//! @brief Appends compact representation of a list to the buffer
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @param view - list we are encoding
+//! @param buffer - buffer we are appending to
+//! @param flags - tells how elements are encoded
+//! @throw std::bad_alloc if buffer cannot grow
+//!
+template <typename T,
+          typename TT>
+void flat_forward_list_compact_encode(flat_forward_list_view<T, TT> const &view,
+                                      std::vector<char> &buffer,
+                                      compact_flags flags = compact_flags::shared_prefix) {
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    bool const shared_prefix{ compact_flags::shared_prefix == flags };
+
+    compact_write_varint(buffer, view.size());
+    compact_write_varint(buffer, flat_forward_list_realigned_size<TT>(view.cbegin(), view.cend()));
+    buffer.push_back(static_cast<char>(flags));
+    //
+    // With offset to the next element, elements are copied
+    // to a scratch buffer, where offset is set to 0.
+    // Previous element stays in the other scratch buffer.
+    //
+    std::vector<char> element_copy;
+    std::vector<char> previous_copy;
+    char const *previous{ nullptr };
+    size_t previous_size{ 0 };
+    for (auto cur{ view.cbegin() }; cur != view.cend(); ++cur) {
+        char const *element{ cur.get_ptr() };
+        size_t const element_size{ traits_traits::get_size(element).size };
+        if constexpr (traits_traits::has_next_offset_v) {
+            element_copy.assign(element, element + element_size);
+            traits_traits::set_next_offset(element_copy.data(), 0);
+            element = element_copy.data();
+        }
+        size_t shared{ 0 };
+        if (shared_prefix) {
+            size_t const max_shared{ std::min(element_size, previous_size) };
+            while (shared < max_shared && element[shared] == previous[shared]) {
+                ++shared;
+            }
+            compact_write_varint(buffer, shared);
+        }
+        compact_write_varint(buffer, element_size - shared);
+        buffer.insert(buffer.end(), element + shared, element + element_size);
+
+        if constexpr (traits_traits::has_next_offset_v) {
+            element_copy.swap(previous_copy);
+            previous = previous_copy.data();
+        } else {
+            previous = element;
+        }
+        previous_size = element_size;
+    }
+}
+
+//!
+//! @brief Decodes compact representation of a list
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type
+//! @tparam F - type of the element validation functor.
+//! @param begin - beginning of the compact representation
+//! @param end - end of the compact representation
+//! @param list - container that receives elements
+//! @param max_buffer_size - largest buffer that decoder allocates.
+//! @param validate_element_fn - functor used to validate each element.
+//! @returns false if input is not a valid compact representation
+//! of a list, or if decoded list is larger than max_buffer_size.
+//! In that case container is not changed.
+//! @throw std::bad_alloc if buffer allocation fails
+//! @details Decoded list uses allocator of the container, and
+//! its buffer is just large enough for all elements.
+//!
+template <typename T,
+          typename TT,
+          typename A,
+          typename F = default_validate_element_fn<T, TT>>
+bool flat_forward_list_compact_decode(char const *begin,
+                                      char const *end,
+                                      flat_forward_list<T, TT, A> &list,
+                                      size_t max_buffer_size = compact_default_max_buffer_size,
+                                      F const &validate_element_fn = F{}) {
+    using list_type = flat_forward_list<T, TT, A>;
+    using traits_traits = typename list_type::traits_traits;
+    using allocator_type_traits = typename list_type::allocator_type_traits;
+
+    char const *cur{ begin };
+    size_t element_count{ 0 };
+    size_t buffer_size{ 0 };
+    if (!compact_read_varint(cur, end, element_count) ||
+        !compact_read_varint(cur, end, buffer_size) ||
+        cur == end) {
+        return false;
+    }
+    compact_flags const flags{ static_cast<compact_flags>(static_cast<unsigned char>(*cur++)) };
+    if (compact_flags::none != flags && compact_flags::shared_prefix != flags) {
+        return false;
+    }
+    bool const shared_prefix{ compact_flags::shared_prefix == flags };
+    if (0 == element_count || 0 == buffer_size) {
+        if (0 != element_count || 0 != buffer_size || cur != end) {
+            return false;
+        }
+        list_type empty_list{ list.get_allocator() };
+        list.swap(empty_list);
+        return true;
+    }
+    //
+    // Each element takes at least one byte of input, and
+    // cannot be larger than the input. That still lets input
+    // ask for a buffer quadratic in the input size, so buffer
+    // is also limited by the caller.
+    //
+    if (element_count > static_cast<size_t>(end - cur) ||
+        buffer_size > max_buffer_size ||
+        buffer_size / element_count > traits_traits::roundup_to_alignment(static_cast<size_t>(end - cur)) +
+                                      traits_traits::alignment) {
+        return false;
+    }
+
+    typename list_type::allocator_type allocator{ list.get_allocator() };
+    char *const buffer{ allocator_type_traits::allocate(allocator, buffer_size) };
+    FFL_CODDING_ERROR_IF(nullptr == buffer);
+    auto deallocate_buffer{ make_scope_guard([&allocator, buffer, buffer_size]() noexcept {
+        allocator_type_traits::deallocate(allocator, buffer, buffer_size);
+    }) };
+
+    char *previous{ nullptr };
+    size_t previous_size{ 0 };
+    size_t offset{ 0 };
+    for (size_t idx = 0; idx < element_count; ++idx) {
+        size_t shared{ 0 };
+        size_t remaining{ 0 };
+        if ((shared_prefix && !compact_read_varint(cur, end, shared)) ||
+            !compact_read_varint(cur, end, remaining) ||
+            shared > previous_size ||
+            remaining > static_cast<size_t>(end - cur) ||
+            offset > buffer_size ||
+            shared + remaining > buffer_size - offset) {
+            return false;
+        }
+        size_t const element_size{ shared + remaining };
+        if (element_size < traits_traits::minimum_size()) {
+            return false;
+        }
+        char *const element{ buffer + offset };
+        if (previous) {
+            zero_buffer(previous + previous_size, offset - (previous - buffer) - previous_size);
+            copy_data(element, previous, shared);
+        }
+        copy_data(element + shared, cur, remaining);
+        cur += remaining;
+        //
+        // Encoder writes offset to the next element set to 0,
+        // so element is validated as if it was the last
+        // element in the buffer. Decoder sets the offset when
+        // it decodes the next element.
+        //
+        if constexpr (traits_traits::has_next_offset_v) {
+            if (0 != traits_traits::get_next_offset(element)) {
+                return false;
+            }
+        }
+        if (traits_traits::get_size(element).size != element_size ||
+            !validate_element_fn(element_size, *reinterpret_cast<T const *>(element))) {
+            return false;
+        }
+        if constexpr (traits_traits::has_next_offset_v) {
+            if (previous) {
+                traits_traits::set_next_offset(previous, static_cast<size_t>(element - previous));
+            }
+        }
+        previous = element;
+        previous_size = element_size;
+        offset = traits_traits::roundup_to_alignment(offset + element_size);
+    }
+    if (cur != end ||
+        static_cast<size_t>(previous - buffer) + previous_size != buffer_size) {
+        return false;
+    }
+    deallocate_buffer.disarm();
+    list_type decoded{ attach_buffer{}, buffer, previous, buffer + buffer_size, std::move(allocator) };
+    list.swap(decoded);
+    return true;
+}
+
+} // namespace iffl
@@ -0,0 +1,1122 @@
+#pragma once
+
+//!
+//! @file iffl_concurrent.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements helpers that let multiple threads
+//!        build flat forward lists concurrently.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+#include <iffl_allocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Size of the cache line we use to keep
+//! frequently modified atomic counters apart.
+//!
+constexpr inline size_t const concurrent_cache_line_size{ 64 };
+
+//!
+//! @class concurrent_flat_forward_list_builder
+//! @brief Lets multiple producers append elements to a preallocated
+//! buffer without taking a lock.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @details Similar to input_buffer_memory_resource, builder does not own
+//! the buffer. Buffer must be aligned to the element alignment.
+//!
+//! Each producer reserves space for its element with a single atomic
+//! fetch-add, constructs element in place, and publishes it by adding
+//! reserved size to the published counter. Producers never touch each
+//! other's elements, so appends do not serialize beyond the two atomic
+//! additions.
+//!
+//! Reserved space is always padded to the element alignment. If element
+//! type has offset to the next element then producer sets it to the size
+//! of the reservation, and constructed element can be smaller than the
+//! requested size. If element type does not have offset to the next
+//! element then list is walked using element size, so padded size of
+//! the constructed element must match padded requested size.
+//!
+//! Elements are placed in the buffer in the order of reservations,
+//! and not in the order producers finished construction.
+//!
+//! Once all producers are done, finalize sets offset of the last
+//! element to 0, and returns a reference to the list that can be
+//! attached to a container with a compatible allocator or used in place.
+//!
+//! Sample usage:
+//!
+//! @code
+//! char *buffer{ std::allocator<char>{}.allocate(buffer_size) };
+//! iffl::concurrent_flat_forward_list_builder<FLAT_FORWARD_LIST_TEST> builder{ buffer, buffer_size };
+//! <on each producer thread>
+//!     if (!builder.try_emplace_back(element_size,
+//!                                   [](FLAT_FORWARD_LIST_TEST &e, size_t element_size) noexcept {
+//!                                       <construct element>
+//!                                   })) {
+//!         <buffer is full>
+//!     }
+//! <after all producers are done>
+//! auto list_ref{ builder.finalize() };
+//! iffl::flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl;
+//! ffl.attach(list_ref.data(), list_ref.last().get_ptr(), list_ref.data() + buffer_size);
+//! @endcode
+//!
+//! Thread safety:
+//!
+//! try_emplace_back can be called concurrently from any number of threads.
+//! finalize and reset must not run concurrently with any other method.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+class concurrent_flat_forward_list_builder final {
+public:
+    //!
+    //! @typedef value_type
+    //! @brief Element type
+    //!
+    using value_type = T;
+    //!
+    //! @typedef traits
+    //! @brief Element type traits
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that simplifies use of traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef ref_type
+    //! @brief Type of reference to the list finalize returns
+    //!
+    using ref_type = flat_forward_list_ref<T, TT>;
+
+    //!
+    //! @brief Constructs builder over a buffer.
+    //! @param buffer - pointer to the buffer aligned to the element alignment.
+    //! @param buffer_size - size of the buffer.
+    //!
+    concurrent_flat_forward_list_builder(char *buffer,
+                                         size_type buffer_size) noexcept
+        : buffer_begin_{ buffer }
+        , buffer_size_{ buffer ? buffer_size : 0 } {
+        FFL_CODDING_ERROR_IF(buffer && roundup_ptr_to_alignment(buffer, traits_traits::alignment) != buffer);
+    }
+
+    concurrent_flat_forward_list_builder(concurrent_flat_forward_list_builder const &) = delete;
+    concurrent_flat_forward_list_builder &operator=(concurrent_flat_forward_list_builder const &) = delete;
+
+    //!
+    //! @brief Constructs new element at the end of the list if it fits
+    //! in the remaining buffer.
+    //! @tparam F - type of a functor
+    //! @param element_size - number of bytes required for the new element.
+    //! @param fn - a functor used to construct new element.
+    //! Functor is called with a reference to the element and element size.
+    //! Functor must not throw.
+    //! @returns true if element was added and false if buffer does not
+    //! have enough space for the element.
+    //! @details Once a call fails because buffer is full, all following
+    //! calls fail too.
+    //!
+    template <typename F>
+    [[nodiscard]] bool try_emplace_back(size_type element_size,
+                                        F const &fn) noexcept {
+        FFL_CODDING_ERROR_IF(element_size < traits_traits::minimum_size());
+        size_type const reserved_size{ traits_traits::roundup_to_alignment(element_size) };
+        size_type const offset{ reserved_.fetch_add(reserved_size, std::memory_order_relaxed) };
+        //
+        // Last element in the buffer does not have to be padded
+        //
+        if (buffer_size_ < offset || buffer_size_ - offset < element_size) {
+            return false;
+        }
+
+        char *cur{ buffer_begin_ + offset };
+        fn(*traits_traits::ptr_to_t(cur), element_size);
+        //
+        // After element was constructed it cannot be larger than
+        // size requested for this element.
+        //
+        size_with_padding_t const cur_element_size{ traits_traits::get_size(cur) };
+        FFL_CODDING_ERROR_IF(element_size < cur_element_size.size);
+        if constexpr (traits_traits::has_next_offset_v) {
+            traits_traits::set_next_offset(cur, reserved_size);
+        } else {
+            //
+            // There is no way to skip unused part of the reservation
+            //
+            FFL_CODDING_ERROR_IF(cur_element_size.size_padded() != reserved_size);
+        }
+
+        published_.fetch_add(reserved_size, std::memory_order_release);
+        return true;
+    }
+
+    //!
+    //! @brief Constructs new element at the end of the list if it fits
+    //! in the remaining buffer, and copies data to the element.
+    //! @param init_buffer_size - number of bytes to copy.
+    //! @param init_buffer - buffer with element data.
+    //! @returns true if element was added and false if buffer does not
+    //! have enough space for the element.
+    //!
+    [[nodiscard]] bool try_push_back(size_type init_buffer_size,
+                                     char const *init_buffer) noexcept {
+        return try_emplace_back(init_buffer_size,
+                                [init_buffer_size, init_buffer](T &buffer,
+                                                                size_type element_size) noexcept {
+                                    FFL_CODDING_ERROR_IF_NOT(init_buffer_size == element_size);
+                                    copy_data(reinterpret_cast<char *>(&buffer), init_buffer, element_size);
+                                });
+    }
+
+    //!
+    //! @brief Links published elements into a list.
+    //! @returns reference to the list. Reference buffer covers the
+    //! whole builder buffer.
+    //! @details All producers must be done before calling this method.
+    //! Walks elements in the buffer, so cost is O(number of elements).
+    //! Can be called again after more elements were added.
+    //!
+    ref_type finalize() noexcept {
+        size_type const published{ published_.load(std::memory_order_acquire) };
+        size_type const reserved{ reserved_.load(std::memory_order_relaxed) };
+        //
+        // If buffer is not full then every reservation must be published,
+        // otherwise some producer is still constructing element
+        //
+        FFL_CODDING_ERROR_IF(reserved < buffer_size_ && reserved != published);
+
+        char *last{ nullptr };
+        size_type offset{ 0 };
+        while (offset < published) {
+            last = buffer_begin_ + offset;
+            if constexpr (traits_traits::has_next_offset_v) {
+                offset += traits_traits::get_next_offset(last);
+            } else {
+                offset += traits_traits::get_size(last).size_padded();
+            }
+        }
+        FFL_CODDING_ERROR_IF(offset != published);
+
+        if constexpr (traits_traits::has_next_offset_v) {
+            if (last) {
+                traits_traits::set_next_offset(last, 0);
+            }
+        }
+        return ref_type{ buffer_begin_, last, buffer_begin_ + buffer_size_ };
+    }
+
+    //!
+    //! @brief Discards all elements.
+    //! @details All producers must be done before calling this method.
+    //!
+    void reset() noexcept {
+        reserved_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_relaxed);
+    }
+
+    //!
+    //! @returns pointer to the buffer
+    //!
+    char *data() const noexcept {
+        return buffer_begin_;
+    }
+
+    //!
+    //! @returns size of the buffer
+    //!
+    size_type total_capacity() const noexcept {
+        return buffer_size_;
+    }
+
+    //!
+    //! @returns number of bytes used by published elements
+    //! including padding of the last element.
+    //!
+    size_type published_size() const noexcept {
+        return published_.load(std::memory_order_acquire);
+    }
+
+private:
+    //!
+    //! @typedef size_with_padding_t
+    //! @brief Size of element with padding
+    //!
+    using size_with_padding_t = typename traits_traits::size_with_padding_t;
+
+    //!
+    //! @brief Pointer to the buffer
+    //!
+    char *buffer_begin_{ nullptr };
+    //!
+    //! @brief Size of the buffer
+    //!
+    size_type buffer_size_{ 0 };
+    //!
+    //! @brief Offset of the next reservation.
+    //! Can grow past the buffer size when buffer is full.
+    //!
+    alignas(concurrent_cache_line_size) std::atomic<size_type> reserved_{ 0 };
+    //!
+    //! @brief Total size of published elements.
+    //!
+    alignas(concurrent_cache_line_size) std::atomic<size_type> published_{ 0 };
+};
+
+//!
+//! @brief Concatenates lists into a single list.
+//! @tparam I - type of iterator over flat_forward_list containers.
+//! @param first - iterator to the first list.
+//! @param end - iterator past the last list.
+//! @returns list that contains elements of all lists in the order.
+//! Returned list uses allocator copied from the first list.
+//! @throw std::bad_alloc if allocating new buffer fails.
+//! @details Use it to merge lists built by different threads, each
+//! with its own flat_forward_list. Buffer for the result is allocated once,
+//! and each list is copied with a single copy. The only elements we modify
+//! are the last elements of each list, which are now followed by the first
+//! element of the next list.
+//!
+template <typename I>
+auto flat_forward_list_concatenate(I first, I end) {
+    using list_type = std::decay_t<decltype(*first)>;
+    using traits_traits = typename list_type::traits_traits;
+
+    if (first == end) {
+        return list_type{};
+    }
+    //
+    // Every list but the last one is followed by
+    // another list, so it must be padded
+    //
+    size_t total_size{ 0 };
+    for (I cur = first; cur != end; ++cur) {
+        total_size = traits_traits::roundup_to_alignment(total_size) + cur->used_capacity();
+    }
+
+    list_type result{ first->get_allocator() };
+    if (0 == total_size) {
+        return result;
+    }
+    result.resize_buffer(total_size);
+    auto const buffer{ result.detach() };
+
+    char *prev_last{ nullptr };
+    size_t offset{ 0 };
+    for (I cur = first; cur != end; ++cur) {
+        if (cur->empty()) {
+            continue;
+        }
+        offset = traits_traits::roundup_to_alignment(offset);
+        copy_data(buffer.begin + offset, cur->data(), cur->used_capacity());
+        if constexpr (traits_traits::has_next_offset_v) {
+            if (prev_last) {
+                traits_traits::set_next_offset(prev_last, static_cast<size_t>(buffer.begin + offset - prev_last));
+            }
+        }
+        prev_last = buffer.begin + offset + (cur->clast().get_ptr() - cur->data());
+        offset += cur->used_capacity();
+    }
+
+    result.attach(buffer.begin, prev_last, buffer.end);
+    return result;
+}
+
+//!
+//! @class flat_forward_list_shards
+//! @brief Carves a single buffer into shards, so each thread can
+//! build its own list, and stitches shards into one list without
+//! copying elements.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type of the resulting container
+//! @details Each shard is a pmr_flat_forward_list that uses
+//! input_buffer_memory_resource over its part of the buffer. Shards
+//! cannot grow past the shard capacity, so producers should use try_*
+//! methods that return false when shard is full.
+//!
+//! stitch returns a container that owns the whole buffer.
+//! If element type has offset to the next element then stitching sets
+//! offset of the last element in each shard to the first element of
+//! the next non-empty shard, and unused capacity of shards becomes gaps
+//! between elements. Otherwise gaps cannot be skipped, so each shard is
+//! moved down to the end of the previous shard with a single move.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_shards<FLAT_FORWARD_LIST_TEST> shards{ thread_count, 64 * 1024 };
+//! <on thread idx>
+//!     while (shards.shard(idx).try_push_back(<data_size>, <data>)) {
+//!     }
+//! <after all threads are done>
+//! iffl::flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl{ shards.stitch() };
+//! @endcode
+//!
+//! Thread safety:
+//!
+//! Different threads can modify different shards concurrently.
+//! stitch must not run concurrently with any other method.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class flat_forward_list_shards final {
+public:
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that simplifies use of traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef list_type
+    //! @brief Type of the container stitch returns
+    //!
+    using list_type = flat_forward_list<T, TT, A>;
+    //!
+    //! @typedef shard_type
+    //! @brief Type of the container for a shard
+    //!
+    using shard_type = pmr_flat_forward_list<T, TT>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator
+    //!
+    using allocator_type = typename list_type::allocator_type;
+    //!
+    //! @typedef allocator_type_traits
+    //! @brief Type of allocator traits
+    //!
+    using allocator_type_traits = std::allocator_traits<allocator_type>;
+
+    //!
+    //! @brief Allocates buffer for all shards.
+    //! @param shard_count - number of shards.
+    //! @param shard_capacity - capacity of each shard. Rounded up
+    //! to the element alignment.
+    //! @param a - allocator used for the buffer.
+    //! @throw std::bad_alloc if allocating buffer fails.
+    //!
+    flat_forward_list_shards(size_type shard_count,
+                             size_type shard_capacity,
+                             A const &a = A{})
+        : alloc_{ a }
+        , shard_capacity_{ traits_traits::roundup_to_alignment(shard_capacity) }
+        , buffer_size_{ shard_count * shard_capacity_ } {
+        FFL_CODDING_ERROR_IF(0 == shard_count || 0 == shard_capacity);
+        buffer_ = allocator_type_traits::allocate(alloc_, buffer_size_);
+        auto deallocate_buffer{ make_scope_guard([this]() noexcept {
+            release_shards();
+        }) };
+        shards_.reserve(shard_count);
+        for (size_type idx = 0; idx < shard_count; ++idx) {
+            shards_.emplace_back(std::make_unique<shard_state>(buffer_ + idx * shard_capacity_, shard_capacity_));
+        }
+        deallocate_buffer.disarm();
+    }
+
+    flat_forward_list_shards(flat_forward_list_shards const &) = delete;
+    flat_forward_list_shards &operator=(flat_forward_list_shards const &) = delete;
+
+    //!
+    //! @brief Frees buffer unless it was stitched
+    //!
+    ~flat_forward_list_shards() noexcept {
+        release_shards();
+    }
+
+    //!
+    //! @returns number of shards
+    //!
+    size_type shard_count() const noexcept {
+        return shards_.size();
+    }
+
+    //!
+    //! @returns capacity of each shard
+    //!
+    size_type shard_capacity() const noexcept {
+        return shard_capacity_;
+    }
+
+    //!
+    //! @param idx - index of the shard
+    //! @returns container for the shard
+    //!
+    shard_type &shard(size_type idx) noexcept {
+        FFL_CODDING_ERROR_IF_NOT(idx < shards_.size());
+        return shards_[idx]->list;
+    }
+
+    //!
+    //! @brief Links shards into a single list.
+    //! @returns container that owns the buffer of all shards.
+    //! @details After this call object does not have any shards.
+    //! When element has offset to the next element, cost is
+    //! O(number of shards), and elements stay in place, except
+    //! the first non-empty shard that is moved to the beginning
+    //! of the buffer when shards before it are empty.
+    //! Otherwise shards are moved to close gaps between them.
+    //!
+    list_type stitch() noexcept {
+        char *prev_last{ nullptr };
+        char *dest{ buffer_ };
+        for (std::unique_ptr<shard_state> &s : shards_) {
+            if (s->list.empty()) {
+                continue;
+            }
+            char *shard_begin{ s->list.data() };
+            char *shard_last{ s->list.last().get_ptr() };
+            size_type const used_capacity{ s->list.used_capacity() };
+            if constexpr (traits_traits::has_next_offset_v) {
+                if (prev_last) {
+                    traits_traits::set_next_offset(prev_last, static_cast<size_t>(shard_begin - prev_last));
+                } else if (shard_begin != buffer_) {
+                    //
+                    // List must start at the beginning of the buffer
+                    //
+                    move_data(buffer_, shard_begin, used_capacity);
+                    shard_last = buffer_ + (shard_last - shard_begin);
+                }
+                prev_last = shard_last;
+            } else {
+                dest = buffer_ + traits_traits::roundup_to_alignment(static_cast<size_type>(dest - buffer_));
+                if (dest != shard_begin) {
+                    move_data(dest, shard_begin, used_capacity);
+                }
+                prev_last = dest + (shard_last - shard_begin);
+                dest += used_capacity;
+            }
+        }
+        //
+        // Return shard buffers to their memory resources. Shards
+        // do not own memory, so that does not free anything.
+        //
+        for (std::unique_ptr<shard_state> &s : shards_) {
+            s->release();
+        }
+        shards_.clear();
+
+        list_type result{ alloc_ };
+        result.attach(buffer_, prev_last, buffer_ + buffer_size_);
+        buffer_ = nullptr;
+        buffer_size_ = 0;
+        return result;
+    }
+
+private:
+
+    //!
+    //! @brief Container for a shard and memory resource
+    //! it is using
+    //!
+    struct shard_state {
+        //!
+        //! @brief Constructs shard over a part of the buffer
+        //! @param buffer - pointer to the beginning of the shard.
+        //! @param buffer_size - shard size.
+        //!
+        shard_state(char *buffer, size_type buffer_size)
+            : resource{ buffer, buffer_size }
+            , list{ &resource } {
+            list.resize_buffer(buffer_size);
+        }
+        //!
+        //! @brief Detaches buffer from container, and
+        //! returns it to the memory resource.
+        //!
+        void release() noexcept {
+            auto const buffer{ list.detach() };
+            if (buffer.begin) {
+                resource.deallocate(buffer.begin, static_cast<size_type>(buffer.end - buffer.begin));
+            }
+        }
+        //!
+        //! @brief Memory resource over part of the buffer
+        //!
+        input_buffer_memory_resource resource;
+        //!
+        //! @brief Shard container
+        //!
+        shard_type list;
+    };
+
+    //!
+    //! @brief Destroys shards, and frees buffer
+    //!
+    void release_shards() noexcept {
+        shards_.clear();
+        if (buffer_) {
+            allocator_type_traits::deallocate(alloc_, buffer_, buffer_size_);
+            buffer_ = nullptr;
+            buffer_size_ = 0;
+        }
+    }
+
+    //!
+    //! @brief Allocator used for the buffer
+    //!
+    allocator_type alloc_;
+    //!
+    //! @brief Capacity of each shard
+    //!
+    size_type shard_capacity_{ 0 };
+    //!
+    //! @brief Size of the buffer
+    //!
+    size_type buffer_size_{ 0 };
+    //!
+    //! @brief Buffer for all shards
+    //!
+    char *buffer_{ nullptr };
+    //!
+    //! @brief Shards
+    //!
+    std::vector<std::unique_ptr<shard_state>> shards_;
+};
+
+//!
+//! @class snapshot_flat_forward_list
+//! @brief Container with a single writer that appends elements, and
+//! any number of readers that scan immutable snapshots without locks.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type used for buffers
+//! @details Writer appends elements in place while buffer has enough
+//! capacity, and publishes offset of the new last element. Bytes of
+//! published elements are never modified after that. When buffer is
+//! full writer allocates a larger buffer, copies elements, publishes
+//! the new buffer through an atomic pointer, and retires the old buffer.
+//!
+//! A reader calls get_snapshot to get a view over elements that were
+//! published at that moment. Snapshot protects its buffer with a hazard
+//! pointer, so writer does not free retired buffer while any snapshot
+//! is using it. Writer frees retired buffers that are not protected
+//! every time it retires a buffer, and when reclaim is called.
+//!
+//! Because published bytes never change, writer sets offset to the next
+//! element of each element when the element is appended. The last element
+//! of a snapshot has offset pointing past its end rather than 0. View
+//! iterators handle that, but to pass a snapshot to code that expects
+//! the last element to have 0 offset copy it to a flat_forward_list.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::snapshot_flat_forward_list<FLAT_FORWARD_LIST_TEST> list;
+//! <writer thread>
+//!     list.emplace_back(element_size, [](FLAT_FORWARD_LIST_TEST &e, size_t element_size) noexcept {
+//!                                          <construct element>
+//!                                      });
+//! <reader threads>
+//!     auto const snapshot{ list.get_snapshot() };
+//!     for (FLAT_FORWARD_LIST_TEST const &e : snapshot.view()) {
+//!         <process element>
+//!     }
+//! @endcode
+//!
+//! Thread safety:
+//!
+//! get_snapshot, and methods of snapshot can be called from any thread
+//! concurrently with the writer. All other methods must be called only
+//! by the writer. All snapshots must be destroyed before the container.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class snapshot_flat_forward_list final {
+public:
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that simplifies use of traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef view_type
+    //! @brief Type of the snapshot view
+    //!
+    using view_type = flat_forward_list_view<T, TT>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator
+    //!
+    using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<char>;
+    //!
+    //! @typedef allocator_type_traits
+    //! @brief Type of allocator traits
+    //!
+    using allocator_type_traits = std::allocator_traits<allocator_type>;
+
+private:
+
+    //!
+    //! @brief Buffer, and offset of the last element
+    //! published in this buffer.
+    //!
+    struct buffer_state {
+        //!
+        //! @brief Pointer to the buffer
+        //!
+        char *begin{ nullptr };
+        //!
+        //! @brief Size of the buffer
+        //!
+        size_type capacity{ 0 };
+        //!
+        //! @brief Offset of the last published element,
+        //! or npos if there are no elements.
+        //!
+        std::atomic<size_type> last_offset{ npos };
+    };
+
+    //!
+    //! @brief Hazard pointer record owned by a snapshot
+    //!
+    struct reader_slot {
+        //!
+        //! @brief Buffer that snapshot is using
+        //!
+        std::atomic<buffer_state *> hazard{ nullptr };
+        //!
+        //! @brief true if a snapshot owns this record
+        //!
+        std::atomic<bool> in_use{ true };
+        //!
+        //! @brief Next record. Records are never removed
+        //! from the list until container is destroyed.
+        //!
+        reader_slot *next{ nullptr };
+    };
+
+public:
+
+    //!
+    //! @class snapshot
+    //! @brief Keeps buffer of a snapshot alive, and provides
+    //! view over the elements.
+    //!
+    class snapshot final {
+    public:
+        //!
+        //! @brief Constructs empty snapshot
+        //!
+        snapshot() noexcept = default;
+        //!
+        //! @brief Move constructor
+        //! @param other - snapshot we are moving from
+        //!
+        snapshot(snapshot &&other) noexcept
+            : slot_{ std::exchange(other.slot_, nullptr) }
+            , view_{ std::exchange(other.view_, view_type{}) } {
+        }
+        //!
+        //! @brief Move assignment operator
+        //! @param other - snapshot we are moving from
+        //! @returns reference to this object
+        //!
+        snapshot &operator=(snapshot &&other) noexcept {
+            if (this != &other) {
+                release();
+                slot_ = std::exchange(other.slot_, nullptr);
+                view_ = std::exchange(other.view_, view_type{});
+            }
+            return *this;
+        }
+        snapshot(snapshot const &) = delete;
+        snapshot &operator=(snapshot const &) = delete;
+        //!
+        //! @brief Destructor releases hazard pointer
+        //!
+        ~snapshot() noexcept {
+            release();
+        }
+        //!
+        //! @returns view over elements of the snapshot
+        //!
+        view_type const &view() const noexcept {
+            return view_;
+        }
+        //!
+        //! @brief Releases hazard pointer. After this
+        //! call view is empty.
+        //!
+        void release() noexcept {
+            if (slot_) {
+                slot_->hazard.store(nullptr, std::memory_order_release);
+                slot_->in_use.store(false, std::memory_order_release);
+                slot_ = nullptr;
+            }
+            view_ = view_type{};
+        }
+
+    private:
+        friend class snapshot_flat_forward_list;
+        //!
+        //! @brief Constructs snapshot
+        //! @param slot - hazard pointer record
+        //! @param view - view over published elements
+        //!
+        snapshot(reader_slot *slot, view_type const &view) noexcept
+            : slot_{ slot }
+            , view_{ view } {
+        }
+        //!
+        //! @brief Hazard pointer record
+        //!
+        reader_slot *slot_{ nullptr };
+        //!
+        //! @brief View over elements
+        //!
+        view_type view_;
+    };
+
+    //!
+    //! @brief Constructs empty container
+    //! @param a - allocator used for buffers
+    //!
+    explicit snapshot_flat_forward_list(A const &a = A{}) noexcept
+        : alloc_{ a } {
+    }
+
+    snapshot_flat_forward_list(snapshot_flat_forward_list const &) = delete;
+    snapshot_flat_forward_list &operator=(snapshot_flat_forward_list const &) = delete;
+
+    //!
+    //! @brief Destructor frees all buffers. Fails fast if
+    //! there are snapshots that are still alive.
+    //!
+    ~snapshot_flat_forward_list() noexcept {
+        reader_slot *slot{ slots_.load(std::memory_order_acquire) };
+        while (slot) {
+            FFL_CODDING_ERROR_IF(slot->in_use.load(std::memory_order_acquire));
+            reader_slot *next{ slot->next };
+            delete slot;
+            slot = next;
+        }
+        for (buffer_state *state : retired_) {
+            free_buffer_state(state);
+        }
+        free_buffer_state(current_.load(std::memory_order_relaxed));
+    }
+
+    //!
+    //! @brief Returns snapshot of the published elements.
+    //! @returns snapshot that protects buffer from being freed.
+    //! @throw std::bad_alloc if allocating a hazard pointer record fails.
+    //! @details Can be called from any thread.
+    //!
+    snapshot get_snapshot() const {
+        reader_slot *slot{ acquire_slot() };
+        buffer_state *state{ current_.load(std::memory_order_seq_cst) };
+        for (;;) {
+            slot->hazard.store(state, std::memory_order_seq_cst);
+            //
+            // If writer has not replaced buffer after we published
+            // hazard pointer, then writer will see it before freeing
+            //
+            buffer_state *const current{ current_.load(std::memory_order_seq_cst) };
+            if (current == state) {
+                break;
+            }
+            state = current;
+        }
+        if (nullptr == state) {
+            return snapshot{ slot, view_type{} };
+        }
+        size_type const last_offset{ state->last_offset.load(std::memory_order_acquire) };
+        if (npos == last_offset) {
+            return snapshot{ slot, view_type{} };
+        }
+        char const *last{ state->begin + last_offset };
+        return snapshot{ slot,
+                         view_type{ state->begin,
+                                    last,
+                                    last + traits_traits::get_size(last).size_padded() } };
+    }
+
+    //!
+    //! @brief Constructs new element at the end of the list.
+    //! @tparam F - type of a functor
+    //! @param element_size - number of bytes required for the new element.
+    //! @param fn - a functor used to construct new element.
+    //! @throw std::bad_alloc if allocating new buffer fails.
+    //!        Any exceptions that might be raised by the functor.
+    //!        If functor raises then container remains in the state as if
+    //!        call did not happen.
+    //!
+    template <typename F>
+    void emplace_back(size_type element_size,
+                      F const &fn) {
+        if (remaining_capacity() < traits_traits::roundup_to_alignment(element_size)) {
+            grow(traits_traits::roundup_to_alignment(element_size));
+        }
+        bool const result{ try_emplace_back(element_size, fn) };
+        FFL_CODDING_ERROR_IF_NOT(result);
+    }
+
+    //!
+    //! @brief Constructs new element at the end of the list if it fits
+    //! in the existing buffer.
+    //! @tparam F - type of a functor
+    //! @param element_size - number of bytes required for the new element.
+    //! @param fn - a functor used to construct new element.
+    //! @returns true if element was added, and false if buffer does not
+    //! have enough capacity.
+    //!
+    template <typename F>
+    [[nodiscard]] bool try_emplace_back(size_type element_size,
+                                        F const &fn) {
+        FFL_CODDING_ERROR_IF(element_size < traits_traits::minimum_size());
+        if (remaining_capacity() < traits_traits::roundup_to_alignment(element_size)) {
+            return false;
+        }
+        buffer_state *state{ current_.load(std::memory_order_relaxed) };
+        char *cur{ state->begin + used_size_ };
+        //
+        // Readers do not look past the last published element,
+        // so we are free to construct element in place
+        //
+        fn(*traits_traits::ptr_to_t(cur), element_size);
+        size_with_padding_t const cur_element_size{ traits_traits::get_size(cur) };
+        FFL_CODDING_ERROR_IF(element_size < cur_element_size.size);
+        if constexpr (traits_traits::has_next_offset_v) {
+            traits_traits::set_next_offset(cur, cur_element_size.size_padded());
+        }
+        state->last_offset.store(used_size_, std::memory_order_release);
+        used_size_ += cur_element_size.size_padded();
+        ++size_;
+        return true;
+    }
+
+    //!
+    //! @brief Copies element to the end of the list.
+    //! @param init_buffer_size - number of bytes to copy.
+    //! @param init_buffer - buffer with element data.
+    //! @throw std::bad_alloc if allocating new buffer fails.
+    //!
+    void push_back(size_type init_buffer_size,
+                   char const *init_buffer) {
+        emplace_back(init_buffer_size,
+                     [init_buffer_size, init_buffer](T &buffer,
+                                                     size_type element_size) noexcept {
+                         FFL_CODDING_ERROR_IF_NOT(init_buffer_size == element_size);
+                         copy_data(reinterpret_cast<char *>(&buffer), init_buffer, element_size);
+                     });
+    }
+
+    //!
+    //! @brief Makes sure buffer has at least requested capacity.
+    //! @param capacity - required capacity.
+    //! @throw std::bad_alloc if allocating new buffer fails.
+    //!
+    void reserve(size_type capacity) {
+        if (total_capacity() < capacity) {
+            grow(capacity - used_size_);
+        }
+    }
+
+    //!
+    //! @brief Frees retired buffers that are not used by any snapshot.
+    //! @returns number of buffers that are still retired.
+    //!
+    size_type reclaim() noexcept {
+        auto const is_protected{ [this](buffer_state *state) noexcept {
+            for (reader_slot *slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+                if (slot->hazard.load(std::memory_order_seq_cst) == state) {
+                    return true;
+                }
+            }
+            return false;
+        } };
+        auto const end{ std::remove_if(retired_.begin(),
+                                       retired_.end(),
+                                       [this, &is_protected](buffer_state *state) noexcept {
+                                           if (is_protected(state)) {
+                                               return false;
+                                           }
+                                           free_buffer_state(state);
+                                           return true;
+                                       }) };
+        retired_.erase(end, retired_.end());
+        return retired_.size();
+    }
+
+    //!
+    //! @returns number of elements
+    //!
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    //!
+    //! @returns true if container has no elements
+    //!
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+
+    //!
+    //! @returns number of bytes used by elements including padding
+    //!
+    size_type used_capacity() const noexcept {
+        return used_size_;
+    }
+
+    //!
+    //! @returns size of the current buffer
+    //!
+    size_type total_capacity() const noexcept {
+        buffer_state const *state{ current_.load(std::memory_order_relaxed) };
+        return state ? state->capacity : 0;
+    }
+
+    //!
+    //! @returns number of retired buffers that are not freed yet
+    //!
+    size_type retired_count() const noexcept {
+        return retired_.size();
+    }
+
+private:
+    //!
+    //! @typedef size_with_padding_t
+    //! @brief Size of element with padding
+    //!
+    using size_with_padding_t = typename traits_traits::size_with_padding_t;
+
+    //!
+    //! @returns capacity remaining after the last element
+    //!
+    size_type remaining_capacity() const noexcept {
+        return total_capacity() - used_size_;
+    }
+
+    //!
+    //! @brief Finds a free hazard pointer record, or adds a new one.
+    //! @returns hazard pointer record owned by the caller.
+    //! @throw std::bad_alloc if allocating a record fails.
+    //!
+    reader_slot *acquire_slot() const {
+        for (reader_slot *slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+            bool expected{ false };
+            if (!slot->in_use.load(std::memory_order_relaxed) &&
+                slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        reader_slot *slot{ new reader_slot };
+        slot->next = slots_.load(std::memory_order_relaxed);
+        while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_acq_rel)) {
+        }
+        return slot;
+    }
+
+    //!
+    //! @brief Moves elements to a larger buffer, publishes it,
+    //! and retires the old buffer.
+    //! @param required_capacity - capacity needed after the last element.
+    //! @throw std::bad_alloc if allocation fails.
+    //!
+    void grow(size_type required_capacity) {
+        buffer_state *old_state{ current_.load(std::memory_order_relaxed) };
+        size_type const old_capacity{ old_state ? old_state->capacity : 0 };
+        size_type const new_capacity{ std::max(old_capacity * 2, used_size_ + required_capacity) };
+
+        buffer_state *new_state{ new buffer_state };
+        auto free_new_state{ make_scope_guard([this, &new_state]() noexcept {
+            free_buffer_state(new_state);
+        }) };
+        new_state->begin = allocator_type_traits::allocate(alloc_, new_capacity);
+        new_state->capacity = new_capacity;
+        retired_.reserve(retired_.size() + 1);
+        if (old_state) {
+            copy_data(new_state->begin, old_state->begin, used_size_);
+            new_state->last_offset.store(old_state->last_offset.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+        }
+        free_new_state.disarm();
+
+        current_.store(new_state, std::memory_order_seq_cst);
+        if (old_state) {
+            retired_.push_back(old_state);
+            reclaim();
+        }
+    }
+
+    //!
+    //! @brief Frees buffer state and its buffer
+    //! @param state - state to free. Can be nullptr.
+    //!
+    void free_buffer_state(buffer_state *state) noexcept {
+        if (state) {
+            if (state->begin) {
+                allocator_type_traits::deallocate(alloc_, state->begin, state->capacity);
+            }
+            delete state;
+        }
+    }
+
+    //!
+    //! @brief Allocator used for buffers
+    //!
+    allocator_type alloc_;
+    //!
+    //! @brief Buffer readers take snapshots from
+    //!
+    std::atomic<buffer_state *> current_{ nullptr };
+    //!
+    //! @brief List of hazard pointer records
+    //!
+    mutable std::atomic<reader_slot *> slots_{ nullptr };
+    //!
+    //! @brief Buffers that were replaced, but might be
+    //! used by snapshots
+    //!
+    std::vector<buffer_state *> retired_;
+    //!
+    //! @brief Number of bytes used by elements. Only writer uses it.
+    //!
+    size_type used_size_{ 0 };
+    //!
+    //! @brief Number of elements. Only writer uses it.
+    //!
+    size_type size_{ 0 };
+};
+
+} // namespace iffl
@@ -0,0 +1,362 @@
+#pragma once
+
+//!
+//! @file iffl_constexpr_list.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements constexpr_flat_forward_list, a
+//!        flat forward list that is built at compile time.
+//!
+//! @details Static lookup tables are often built at startup by
+//!          calling push_back for each entry. make_constexpr_flat_forward_list
+//!          builds the same buffer at compile time, so table is placed in
+//!          the read-only data, and costs nothing at startup:
+//!
+//! @code
+//! constexpr auto table{ iffl::make_constexpr_flat_forward_list<entry, entry_traits>(
+//!     iffl::make_constexpr_flat_forward_list_element(entry{ 0, 1, 3 }, "abc"),
+//!     iffl::make_constexpr_flat_forward_list_element(entry{ 0, 2, 5 }, "hello")) };
+//! static_assert(table.validate());
+//! for (entry const &e : table.view()) {
+//! }
+//! @endcode
+//!
+//!          Each element is a header, followed by payload bytes.
+//!          Builder copies first traits::minimum_size() bytes of
+//!          the header, and all payload bytes, pads elements to the
+//!          alignment, and sets offsets to the next element.
+//!          Traits methods called by the builder must be constexpr, like
+//!          methods generated by flat_forward_list_traits_builder.
+//!          Header cannot have padding bytes in the first
+//!          traits::minimum_size() bytes, because their value is not
+//!          known at compile time.
+//!
+//!          Module uses __builtin_bit_cast to copy header bytes at
+//!          compile time, and is available only when compiler supports it.
+//!          It defines FFL_HAS_CONSTEXPR_LIST when it is available.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define FFL_HAS_BUILTIN_BIT_CAST
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1927
+#define FFL_HAS_BUILTIN_BIT_CAST
+#endif
+
+#if defined(FFL_HAS_BUILTIN_BIT_CAST)
+
+#include <array>
+
+//!
+//! @brief Defined when constexpr_flat_forward_list is available
+//!
+#define FFL_HAS_CONSTEXPR_LIST 1
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @struct constexpr_flat_forward_list_element
+//! @brief Describes an element of constexpr_flat_forward_list.
+//! @tparam T - element type
+//! @tparam PAYLOAD_SIZE - number of bytes that follow header
+//!
+template <typename T,
+          size_t PAYLOAD_SIZE>
+struct constexpr_flat_forward_list_element {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "element header must be trivially copyable");
+    //!
+    //! @brief Number of bytes that follow header
+    //!
+    constexpr static size_t const payload_size{ PAYLOAD_SIZE };
+    //!
+    //! @brief Element header. Builder sets offset to the next element.
+    //!
+    T header;
+    //!
+    //! @brief Bytes that follow header
+    //!
+    std::array<char, PAYLOAD_SIZE> payload;
+};
+
+//!
+//! @brief Creates description of an element without payload
+//! @tparam T - element type
+//! @param header - element header
+//! @returns element description
+//!
+template <typename T>
+constexpr constexpr_flat_forward_list_element<T, 0> make_constexpr_flat_forward_list_element(T const &header) noexcept {
+    return constexpr_flat_forward_list_element<T, 0>{ header, {} };
+}
+
+//!
+//! @brief Creates description of an element with payload
+//! @tparam T - element type
+//! @tparam PAYLOAD_SIZE - payload size
+//! @param header - element header
+//! @param payload - bytes that follow header. If it is a string
+//! literal then it includes terminating zero.
+//! @returns element description
+//!
+template <typename T,
+          size_t PAYLOAD_SIZE>
+constexpr constexpr_flat_forward_list_element<T, PAYLOAD_SIZE> make_constexpr_flat_forward_list_element(T const &header,
+                                                                                                         char const (&payload)[PAYLOAD_SIZE]) noexcept {
+    constexpr_flat_forward_list_element<T, PAYLOAD_SIZE> element{ header, {} };
+    for (size_t idx = 0; idx < PAYLOAD_SIZE; ++idx) {
+        element.payload[idx] = payload[idx];
+    }
+    return element;
+}
+
+//!
+//! @class constexpr_flat_forward_list
+//! @brief Buffer of N bytes with a flat forward list that is
+//! built at compile time.
+//! @tparam T - element type
+//! @tparam N - buffer size. Last element is not padded.
+//! @tparam TT - element type traits
+//!
+template <typename T,
+          size_t N,
+          typename TT = flat_forward_list_traits<T>>
+class constexpr_flat_forward_list {
+public:
+    //!
+    //! @typedef traits
+    //! @brief Element type traits
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that reads traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+
+    static_assert(traits_traits::minimum_size() <= sizeof(T),
+                  "minimum size cannot be larger than element header");
+    //!
+    //! @brief Copies elements to the buffer.
+    //! @tparam E - constexpr_flat_forward_list_element for each element.
+    //! @param elements - elements in the order they appear in the list.
+    //! @details Fails fast if size of an element reported by traits
+    //! is larger than header and payload, if it is smaller and element
+    //! does not have offset to the next element, or if the built list
+    //! does not pass validate. When constructor is evaluated at compile
+    //! time that fails compilation.
+    //!
+    template <typename... E>
+    constexpr explicit constexpr_flat_forward_list(E const &... elements) noexcept {
+        static_assert(sizeof...(E) > 0, "list must have at least one element");
+        size_t idx{ 0 };
+        (append_element(elements, ++idx == sizeof...(E)), ...);
+        FFL_CODDING_ERROR_IF_NOT(N == used_capacity_);
+        FFL_CODDING_ERROR_IF_NOT(validate());
+    }
+    //!
+    //! @returns view over elements in the buffer.
+    //!
+    flat_forward_list_view<T, TT> view() const noexcept {
+        return flat_forward_list_view<T, TT>{ buffer_.data(),
+                                              buffer_.data() + last_offset_,
+                                              buffer_.data() + N };
+    }
+    //!
+    //! @returns pointer to the buffer
+    //!
+    constexpr char const *data() const noexcept {
+        return buffer_.data();
+    }
+    //!
+    //! @returns buffer size
+    //!
+    constexpr static size_t used_capacity() noexcept {
+        return N;
+    }
+    //!
+    //! @returns number of elements
+    //!
+    constexpr size_t size() const noexcept {
+        return size_;
+    }
+    //!
+    //! @returns offset of the last element
+    //!
+    constexpr size_t last_offset() const noexcept {
+        return last_offset_;
+    }
+    //!
+    //! @brief Reads elements back from the buffer, and validates
+    //! them the same way flat_forward_list_validate does.
+    //! @returns true if buffer contains size() valid elements.
+    //!
+    constexpr bool validate() const noexcept {
+        size_t offset{ 0 };
+        size_t count{ 0 };
+        for (;;) {
+            size_t const remaining{ N - offset };
+            if (remaining < traits_traits::minimum_size()) {
+                return false;
+            }
+            T const e{ read_header(offset) };
+            size_t const element_size{ get_element_size(e) };
+            if (!traits_traits::validate(remaining, e) || element_size > remaining) {
+                return false;
+            }
+            ++count;
+            size_t next_offset{ 0 };
+            if constexpr (traits_traits::has_next_offset_v) {
+                next_offset = traits::get_next_offset(e);
+                if (0 != next_offset && (next_offset < element_size || next_offset >= remaining)) {
+                    return false;
+                }
+            } else if (offset != last_offset_) {
+                next_offset = traits_traits::roundup_to_alignment(element_size);
+            }
+            if (0 == next_offset) {
+                return offset == last_offset_ && count == size_;
+            }
+            offset += next_offset;
+        }
+    }
+
+private:
+    //!
+    //! @param e - element header
+    //! @returns size of the element reported by traits
+    //!
+    constexpr static size_t get_element_size(T const &e) noexcept {
+        if constexpr (traits_traits::has_fixed_size_v) {
+            unused_variable(e);
+            return traits_traits::fixed_size;
+        } else {
+            return traits::get_size(e);
+        }
+    }
+    //!
+    //! @brief Copies header of an element from the buffer.
+    //! Bytes past the end of the buffer are zero.
+    //! @param offset - offset of the element
+    //! @returns copy of the header
+    //!
+    constexpr T read_header(size_t offset) const noexcept {
+        std::array<unsigned char, sizeof(T)> image{};
+        for (size_t idx = 0; idx < sizeof(T) && offset + idx < N; ++idx) {
+            image[idx] = static_cast<unsigned char>(buffer_[offset + idx]);
+        }
+        return __builtin_bit_cast(T, image);
+    }
+    //!
+    //! @brief Copies element to the buffer after the last element.
+    //! @tparam PAYLOAD_SIZE - payload size
+    //! @param element - element description
+    //! @param is_last - true if this is the last element
+    //!
+    template <size_t PAYLOAD_SIZE>
+    constexpr void append_element(constexpr_flat_forward_list_element<T, PAYLOAD_SIZE> const &element,
+                                  bool is_last) noexcept {
+        size_t const header_size{ traits_traits::minimum_size() };
+        size_t const element_size{ header_size + PAYLOAD_SIZE };
+        size_t const offset{ traits_traits::roundup_to_alignment(used_capacity_) };
+        FFL_CODDING_ERROR_IF(offset + element_size > N);
+
+        T header{ element.header };
+        //
+        // Offset to the next element skips extra payload bytes.
+        // Without it readers find the next element using size
+        // reported by traits, so it must match the payload.
+        //
+        if constexpr (traits_traits::has_next_offset_v) {
+            FFL_CODDING_ERROR_IF(get_element_size(header) > element_size);
+        } else {
+            FFL_CODDING_ERROR_IF(get_element_size(header) != element_size);
+        }
+        if constexpr (traits_traits::has_next_offset_v) {
+            traits::set_next_offset(header, is_last ? 0 : traits_traits::roundup_to_alignment(element_size));
+        } else {
+            unused_variable(is_last);
+        }
+
+        auto const image{ __builtin_bit_cast(std::array<unsigned char, sizeof(T)>, header) };
+        for (size_t idx = 0; idx < header_size; ++idx) {
+            buffer_[offset + idx] = static_cast<char>(image[idx]);
+        }
+        for (size_t idx = 0; idx < PAYLOAD_SIZE; ++idx) {
+            buffer_[offset + header_size + idx] = element.payload[idx];
+        }
+        last_offset_ = offset;
+        used_capacity_ = offset + element_size;
+        ++size_;
+    }
+    //!
+    //! @brief Buffer with elements. Padding is zero.
+    //!
+    alignas(traits_traits::alignment) std::array<char, N> buffer_{};
+    //!
+    //! @brief Offset of the last element
+    //!
+    size_t last_offset_{ 0 };
+    //!
+    //! @brief Number of bytes used by elements
+    //!
+    size_t used_capacity_{ 0 };
+    //!
+    //! @brief Number of elements
+    //!
+    size_t size_{ 0 };
+};
+
+//!
+//! @brief Calculates size of the buffer for elements
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam PAYLOAD_SIZE - payload size of each element
+//! @returns buffer size. Last element is not padded.
+//!
+template <typename T,
+          typename TT,
+          size_t... PAYLOAD_SIZE>
+constexpr size_t constexpr_flat_forward_list_buffer_size() noexcept {
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    size_t used_capacity{ 0 };
+    for (size_t payload_size : { PAYLOAD_SIZE... }) {
+        used_capacity = traits_traits::roundup_to_alignment(used_capacity) +
+                        traits_traits::minimum_size() + payload_size;
+    }
+    return used_capacity;
+}
+
+//!
+//! @brief Builds a flat forward list
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam PAYLOAD_SIZE - payload size of each element
+//! @param elements - elements in the order they appear in the list.
+//! @returns buffer with the list, that is just large enough
+//! for all elements.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          size_t... PAYLOAD_SIZE>
+constexpr auto make_constexpr_flat_forward_list(constexpr_flat_forward_list_element<T, PAYLOAD_SIZE> const &... elements) noexcept {
+    return constexpr_flat_forward_list<T,
+                                       constexpr_flat_forward_list_buffer_size<T, TT, PAYLOAD_SIZE...>(),
+                                       TT>{ elements... };
+}
+
+} // namespace iffl
+
+#endif //FFL_HAS_BUILTIN_BIT_CAST
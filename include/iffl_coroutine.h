@@ -0,0 +1,535 @@
+#pragma once
+
+//!
+//! @file iffl_coroutine.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements C++20 coroutine types that
+//!        pass batches of elements between stages of a pipeline.
+//!
+//! @details Producer stage is a coroutine that returns
+//!          flat_forward_list_batch_generator and yields views over
+//!          batches of elements. Consumer stage co_awaits next batch.
+//!          Stages transfer control directly to each other, so a
+//!          pipeline of decoding, filtering and writing stages runs on
+//!          a single thread without a thread or a queue per stage.
+//!          Views point to buffers owned by the source. Yielding a batch
+//!          does not copy elements and does not allocate. Coroutine
+//!          frame is allocated once per stage, and can be allocated
+//!          from a memory resource.
+//!
+//!          Module is available only when compiler supports coroutines.
+//!          It defines FFL_HAS_COROUTINE when it is available.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+//!
+//! @brief Defined when coroutine types are available
+//!
+#define FFL_HAS_COROUTINE 1
+
+//!
+//! @brief Forces inlining of frame allocation functions
+//!
+#if defined(__GNUC__)
+#define FFL_COROUTINE_ALLOCATOR_INLINE __attribute__((always_inline))
+#else
+#define FFL_COROUTINE_ALLOCATOR_INLINE
+#endif
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @class coroutine_frame_allocator
+//! @brief Base class for promise types that lets caller allocate
+//! coroutine frame from a memory resource.
+//! @details Coroutine that wants its frame allocated from a memory
+//! resource takes std::allocator_arg_t and a pointer to the memory
+//! resource as its first two parameters. Pointer to the memory resource
+//! is stored after the frame, so frame is returned to the same
+//! memory resource. Other coroutines use global operator new.
+//! Member functions are not supported, because their first parameter
+//! is the object.
+//! Frame is freed with usual operator delete as the standard requires.
+//! GCC reports frame allocated with template placement operator new
+//! and freed with usual operator delete as -Wmismatched-new-delete.
+//! Allocation and deallocation functions are always inlined, so GCC
+//! matches calls to the memory resource and to global operators instead.
+//!
+class coroutine_frame_allocator {
+public:
+    //!
+    //! @brief Allocates frame with global operator new.
+    //! @param size - size of the frame.
+    //! @returns pointer to the frame.
+    //! @throw std::bad_alloc if allocation fails.
+    //!
+    FFL_COROUTINE_ALLOCATOR_INLINE static void *operator new(size_t size) {
+        return allocate(size, nullptr);
+    }
+    //!
+    //! @brief Allocates frame from memory resource.
+    //! @tparam ARGS - types of the remaining coroutine parameters.
+    //! @param size - size of the frame.
+    //! @param resource - memory resource.
+    //! @returns pointer to the frame.
+    //! @throw std::bad_alloc if allocation fails.
+    //!
+    template <typename... ARGS>
+    FFL_COROUTINE_ALLOCATOR_INLINE static void *operator new(size_t size,
+                                                             std::allocator_arg_t,
+                                                             FFL_PMR::memory_resource *resource,
+                                                             ARGS const &...) {
+        FFL_CODDING_ERROR_IF(nullptr == resource);
+        return allocate(size, resource);
+    }
+    //!
+    //! @brief Returns frame to the memory it was allocated from.
+    //! @param ptr - pointer to the frame.
+    //! @param size - size of the frame.
+    //!
+    FFL_COROUTINE_ALLOCATOR_INLINE static void operator delete(void *ptr, size_t size) noexcept {
+        size_t const resource_offset{ roundup_size_to_alignment(size, alignof(FFL_PMR::memory_resource *)) };
+        FFL_PMR::memory_resource *resource{ nullptr };
+        copy_data(reinterpret_cast<char *>(&resource),
+                  static_cast<char const *>(ptr) + resource_offset,
+                  sizeof(resource));
+        if (resource) {
+            resource->deallocate(ptr,
+                                 resource_offset + sizeof(resource),
+                                 __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+private:
+    static void *allocate(size_t size, FFL_PMR::memory_resource *resource) {
+        size_t const resource_offset{ roundup_size_to_alignment(size, alignof(FFL_PMR::memory_resource *)) };
+        size_t const allocation_size{ resource_offset + sizeof(resource) };
+        void *ptr{ resource ? resource->allocate(allocation_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                            : ::operator new(allocation_size) };
+        copy_data(static_cast<char *>(ptr) + resource_offset,
+                  reinterpret_cast<char const *>(&resource),
+                  sizeof(resource));
+        return ptr;
+    }
+};
+
+//!
+//! @class flat_forward_list_batch_generator
+//! @brief Return type of a coroutine that yields views over batches
+//! of elements.
+//! @tparam V - type of view. Usually flat_forward_list_view.
+//! @details Generator is lazy. Producer coroutine starts when consumer
+//! co_awaits next batch, and runs until it yields a batch or returns.
+//! View stays valid until consumer co_awaits next batch, so producer
+//! can reuse its buffer once it is resumed.
+//! Exception raised by the producer is rethrown to the consumer from
+//! co_await.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_batch_generator<ea_view> read_eas(int fd) {
+//!     iffl::flat_forward_list_reader<FILE_FULL_EA_INFORMATION> reader{ 64 * 1024 };
+//!     for (auto view{ reader.read_next(fd) }; !view.empty(); view = reader.read_next(fd)) {
+//!         co_yield view;
+//!     }
+//! }
+//!
+//! iffl::flat_forward_list_task process_eas(int fd) {
+//!     auto batches{ read_eas(fd) };
+//!     while (ea_view const *batch = co_await batches.next()) {
+//!         for (auto const &e : *batch) {
+//!             <process element>
+//!         }
+//!     }
+//! }
+//!
+//! process_eas(fd).run();
+//! @endcode
+//!
+template <typename V>
+class flat_forward_list_batch_generator final {
+public:
+    //!
+    //! @typedef view_type
+    //! @brief Type of view generator yields
+    //!
+    using view_type = V;
+
+    //!
+    //! @class promise_type
+    //! @brief Promise of the producer coroutine.
+    //!
+    class promise_type : public coroutine_frame_allocator {
+    public:
+        //!
+        //! @returns generator that owns this coroutine.
+        //!
+        flat_forward_list_batch_generator get_return_object() noexcept {
+            return flat_forward_list_batch_generator{ handle::from_promise(*this) };
+        }
+        //!
+        //! @brief Producer does not start until consumer
+        //! asks for the first batch.
+        //!
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+        //!
+        //! @brief When producer returns, control goes back to
+        //! the consumer.
+        //!
+        auto final_suspend() const noexcept {
+            return resume_consumer{};
+        }
+        //!
+        //! @brief Stores batch and transfers control to the consumer.
+        //! @param view - view over the batch.
+        //!
+        auto yield_value(view_type const &view) noexcept {
+            view_ = view;
+            has_view_ = true;
+            return resume_consumer{};
+        }
+        //!
+        //! @brief Producer has no more batches.
+        //!
+        void return_void() const noexcept {
+        }
+        //!
+        //! @brief Stores exception so it can be rethrown to the consumer.
+        //!
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+
+    private:
+        friend class flat_forward_list_batch_generator;
+        //!
+        //! @brief Awaitable that suspends producer and resumes consumer.
+        //!
+        struct resume_consumer {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> producer) const noexcept {
+                return producer.promise().consumer_;
+            }
+            void await_resume() const noexcept {
+            }
+        };
+        //!
+        //! @brief Last yielded batch.
+        //!
+        view_type view_{};
+        //!
+        //! @brief Set when producer yielded a batch that consumer
+        //! did not receive yet.
+        //!
+        bool has_view_{ false };
+        //!
+        //! @brief Consumer that is waiting for the next batch.
+        //!
+        std::coroutine_handle<> consumer_{ std::noop_coroutine() };
+        //!
+        //! @brief Exception raised by the producer.
+        //!
+        std::exception_ptr exception_;
+    };
+
+    //!
+    //! @brief Awaitable returned by next.
+    //!
+    class next_awaitable {
+    public:
+        //!
+        //! @returns true if producer already completed.
+        //!
+        bool await_ready() const noexcept {
+            return producer_.done();
+        }
+        //!
+        //! @brief Resumes producer.
+        //! @param consumer - coroutine that waits for the batch.
+        //! @returns producer handle.
+        //!
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) const noexcept {
+            producer_.promise().consumer_ = consumer;
+            return producer_;
+        }
+        //!
+        //! @returns pointer to the view over next batch, or nullptr
+        //! if producer has no more batches.
+        //! @throw exception raised by the producer.
+        //!
+        view_type const *await_resume() const {
+            promise_type &promise{ producer_.promise() };
+            if (promise.exception_) {
+                std::rethrow_exception(std::exchange(promise.exception_, nullptr));
+            }
+            if (!promise.has_view_ || producer_.done()) {
+                return nullptr;
+            }
+            promise.has_view_ = false;
+            return &promise.view_;
+        }
+
+    private:
+        friend class flat_forward_list_batch_generator;
+
+        explicit next_awaitable(std::coroutine_handle<promise_type> producer) noexcept
+            : producer_{ producer } {
+        }
+
+        std::coroutine_handle<promise_type> producer_;
+    };
+
+    //!
+    //! @brief Default constructor creates generator that
+    //! does not own a coroutine.
+    //!
+    flat_forward_list_batch_generator() noexcept = default;
+    //!
+    //! @brief Move constructor.
+    //! @param other - generator we are taking coroutine from.
+    //!
+    flat_forward_list_batch_generator(flat_forward_list_batch_generator &&other) noexcept
+        : producer_{ std::exchange(other.producer_, nullptr) } {
+    }
+    //!
+    //! @brief Move assignment operator.
+    //! @param other - generator we are taking coroutine from.
+    //! @returns reference to this generator.
+    //!
+    flat_forward_list_batch_generator &operator=(flat_forward_list_batch_generator &&other) noexcept {
+        if (this != &other) {
+            destroy();
+            producer_ = std::exchange(other.producer_, nullptr);
+        }
+        return *this;
+    }
+
+    flat_forward_list_batch_generator(flat_forward_list_batch_generator const &) = delete;
+    flat_forward_list_batch_generator &operator=(flat_forward_list_batch_generator const &) = delete;
+    //!
+    //! @brief Destroys coroutine frame.
+    //!
+    ~flat_forward_list_batch_generator() noexcept {
+        destroy();
+    }
+    //!
+    //! @returns awaitable that resumes producer and returns
+    //! pointer to the view over next batch, or nullptr if producer
+    //! has no more batches.
+    //!
+    next_awaitable next() const noexcept {
+        FFL_CODDING_ERROR_IF(nullptr == producer_);
+        return next_awaitable{ producer_ };
+    }
+    //!
+    //! @returns true if producer completed.
+    //!
+    bool done() const noexcept {
+        return !producer_ || producer_.done();
+    }
+
+private:
+    //!
+    //! @typedef handle
+    //! @brief Handle of the producer coroutine
+    //!
+    using handle = std::coroutine_handle<promise_type>;
+
+    explicit flat_forward_list_batch_generator(handle producer) noexcept
+        : producer_{ producer } {
+    }
+
+    void destroy() noexcept {
+        if (producer_) {
+            producer_.destroy();
+            producer_ = nullptr;
+        }
+    }
+
+    handle producer_{ nullptr };
+};
+
+//!
+//! @class flat_forward_list_task
+//! @brief Return type of a coroutine that is the last stage
+//! of a pipeline.
+//! @details Task is lazy. It starts when run is called. Stages transfer
+//! control to each other, so run returns once the last stage completes,
+//! or once a stage suspends waiting for an event. In the later case
+//! whoever delivers the event resumes the stage.
+//!
+class flat_forward_list_task final {
+public:
+    //!
+    //! @class promise_type
+    //! @brief Promise of the last stage coroutine.
+    //!
+    class promise_type : public coroutine_frame_allocator {
+    public:
+        //!
+        //! @returns task that owns this coroutine.
+        //!
+        flat_forward_list_task get_return_object() noexcept {
+            return flat_forward_list_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        //!
+        //! @brief Coroutine does not start until run is called.
+        //!
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+        //!
+        //! @brief Coroutine stays suspended after it completes,
+        //! so run can check result.
+        //!
+        std::suspend_always final_suspend() const noexcept {
+            return {};
+        }
+        //!
+        //! @brief Coroutine completed.
+        //!
+        void return_void() const noexcept {
+        }
+        //!
+        //! @brief Stores exception so run can rethrow it.
+        //!
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+
+    private:
+        friend class flat_forward_list_task;
+        //!
+        //! @brief Exception raised by the coroutine.
+        //!
+        std::exception_ptr exception_;
+    };
+
+    //!
+    //! @brief Move constructor.
+    //! @param other - task we are taking coroutine from.
+    //!
+    flat_forward_list_task(flat_forward_list_task &&other) noexcept
+        : coroutine_{ std::exchange(other.coroutine_, nullptr) } {
+    }
+
+    flat_forward_list_task(flat_forward_list_task const &) = delete;
+    flat_forward_list_task &operator=(flat_forward_list_task const &) = delete;
+    flat_forward_list_task &operator=(flat_forward_list_task &&) = delete;
+    //!
+    //! @brief Destroys coroutine frame.
+    //!
+    ~flat_forward_list_task() noexcept {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+    }
+    //!
+    //! @brief Starts the coroutine.
+    //! @returns true if coroutine completed, and false if it is
+    //! suspended waiting for an event.
+    //! @throw exception raised by the coroutine.
+    //!
+    bool run() {
+        FFL_CODDING_ERROR_IF(nullptr == coroutine_ || coroutine_.done());
+        coroutine_.resume();
+        if (coroutine_.done() && coroutine_.promise().exception_) {
+            std::rethrow_exception(std::exchange(coroutine_.promise().exception_, nullptr));
+        }
+        return coroutine_.done();
+    }
+    //!
+    //! @returns true if coroutine completed.
+    //!
+    bool done() const noexcept {
+        return coroutine_.done();
+    }
+
+private:
+    explicit flat_forward_list_task(std::coroutine_handle<promise_type> coroutine) noexcept
+        : coroutine_{ coroutine } {
+    }
+
+    std::coroutine_handle<promise_type> coroutine_{ nullptr };
+};
+
+//!
+//! @brief Producer that yields batches read by a reader.
+//! @tparam R - type of reader. For instance flat_forward_list_reader
+//! from iffl_io.h.
+//! @tparam S - type of source reader is reading from.
+//! @param reader - reader. Must stay valid until generator is destroyed.
+//! @param source - source we are reading from, for instance fd_source.
+//! @returns generator that yields non-empty views returned by read_next,
+//! and completes when read_next returns an empty view.
+//! @details Reader reads next batch only after consumer is done with the
+//! previous one, so batches reuse reader's buffer.
+//!
+template <typename R,
+          typename S>
+flat_forward_list_batch_generator<typename R::view_type> reader_batches(R &reader,
+                                                                       S source) {
+    for (auto view{ reader.read_next(source) }; !view.empty(); view = reader.read_next(source)) {
+        co_yield view;
+    }
+}
+
+//!
+//! @brief Producer that yields batches read from a ring.
+//! @tparam R - type of ring. For instance shm_flat_forward_list_ring
+//! from iffl_shm_ring.h.
+//! @tparam I - type of idle functor.
+//! @param ring - ring. Must stay valid until generator is destroyed.
+//! @param idle - functor that is called when ring is empty. It returns
+//! false to stop the producer, and true to poll ring again. It can
+//! wait, yield the thread, or check if producer of the ring is done.
+//! @returns generator that yields non-empty views returned by try_read.
+//! @details Elements are released back to the ring once consumer
+//! co_awaits next batch, or once generator is destroyed.
+//!
+template <typename R,
+          typename I>
+flat_forward_list_batch_generator<typename R::view_type> ring_batches(R &ring,
+                                                                     I idle) {
+    for (;;) {
+        auto const view{ ring.try_read() };
+        if (view.empty()) {
+            if (!idle()) {
+                break;
+            }
+            continue;
+        }
+        auto release{ make_scope_guard([&ring]() noexcept {
+            ring.release();
+        }) };
+        co_yield view;
+    }
+}
+
+} // namespace iffl
+
+#endif
@@ -0,0 +1,1460 @@
+#pragma once
+
+//!
+//! @file iffl_io.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements helpers that read and write flat forward
+//!        lists to file descriptors.
+//!        This header depends on POSIX headers, and is not included by iffl.h.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#if __has_include(<unistd.h>)
+
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <system_error>
+#include <istream>
+
+//!
+//! @brief Defined when platform supports file descriptor helpers
+//!
+#define FFL_HAS_FD_IO 1
+
+//!
+//! @brief flat_forward_list_loader uses io_uring when FFL_USE_LIBURING
+//! is defined, and liburing header is available. Application has to link
+//! with liburing. Otherwise loader falls back to blocking pread.
+//!
+#if defined(FFL_USE_LIBURING) && __has_include(<liburing.h>)
+#include <liburing.h>
+#include <chrono>
+#include <thread>
+#define FFL_HAS_LIBURING 1
+#endif
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Writes buffer to the file at the given offset.
+//! @param fd - file descriptor opened for write.
+//! @param buffer - pointer to the buffer.
+//! @param buffer_size - size of the buffer.
+//! @param file_offset - offset in the file.
+//! @return 0 on success, and errno value on failure.
+//! @details Retries on partial writes and on EINTR.
+//!
+inline int write_to_fd(int fd,
+                       char const *buffer,
+                       size_t buffer_size,
+                       size_t file_offset) noexcept {
+    size_t written{ 0 };
+    while (written < buffer_size) {
+        ssize_t const result{ pwrite(fd,
+                                     buffer + written,
+                                     buffer_size - written,
+                                     static_cast<off_t>(file_offset + written)) };
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return errno;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return 0;
+}
+
+//!
+//! @brief Reads from the file at the given offset until buffer
+//! is full or end of file is reached.
+//! @param fd - file descriptor opened for read.
+//! @param buffer - pointer to the buffer.
+//! @param buffer_size - size of the buffer.
+//! @param file_offset - offset in the file.
+//! @param bytes_read - receives number of bytes read.
+//! @return 0 on success, and errno value on failure.
+//! @details Retries on partial reads and on EINTR.
+//!
+inline int read_from_fd(int fd,
+                        char *buffer,
+                        size_t buffer_size,
+                        size_t file_offset,
+                        size_t *bytes_read) noexcept {
+    *bytes_read = 0;
+    while (*bytes_read < buffer_size) {
+        ssize_t const result{ pread(fd,
+                                    buffer + *bytes_read,
+                                    buffer_size - *bytes_read,
+                                    static_cast<off_t>(file_offset + *bytes_read)) };
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return errno;
+        }
+        if (0 == result) {
+            break;
+        }
+        *bytes_read += static_cast<size_t>(result);
+    }
+    return 0;
+}
+
+//!
+//! @class flat_forward_list_writer
+//! @brief Append only writer that streams flat forward list to a file descriptor.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type used by the staging buffer
+//! @details Elements are constructed in a fixed size staging buffer using
+//! flat_forward_list::try_emplace_back, which never reallocates buffer.
+//! When next element does not fit, staging buffer is written to the file
+//! with a single pwrite, and a new segment starts.
+//!
+//! Last element of a segment does not know yet offset of the next element,
+//! so writer keeps it, moving it to the beginning of the staging buffer,
+//! and writes it again, now linked to the next element, as a part of the
+//! next segment. As a result after every write file contains a valid list,
+//! and writer never seeks back to patch elements it has already released.
+//!
+//! Memory use is bounded by the staging buffer size. If an element does not
+//! fit to the staging buffer along with the retained last element then buffer
+//! grows to fit it.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_writer<FLAT_FORWARD_LIST_TEST> writer{ fd, 64 * 1024 };
+//! for (;;) {
+//!     writer.push_back(<data_size>, <data>);
+//! }
+//! writer.flush();
+//! @endcode
+//!
+//! Destructor writes remaining elements, but it cannot report an error, so
+//! call flush explicitly before destroying writer.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class flat_forward_list_writer final {
+public:
+    //!
+    //! @typedef value_type
+    //! @brief Element value type
+    //!
+    using value_type = T;
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits
+    //! @brief Element traits type
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Element traits traits type
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef list_type
+    //! @brief Type of the staging buffer
+    //!
+    using list_type = flat_forward_list<T, TT, A>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator
+    //!
+    using allocator_type = typename list_type::allocator_type;
+
+    //!
+    //! @brief Constructs writer.
+    //! @param fd - file descriptor opened for write. Writer does not own it.
+    //! @param buffer_size - size of the staging buffer.
+    //! @param file_offset - offset in the file where list starts. Must be
+    //!                      aligned to the element alignment.
+    //! @param a - allocator used for the staging buffer.
+    //! @throw std::bad_alloc if allocating staging buffer fails
+    //!
+    flat_forward_list_writer(int fd,
+                             size_type buffer_size,
+                             size_type file_offset = 0,
+                             A const &a = A{})
+        : fd_{ fd }
+        , file_offset_{ file_offset }
+        , buffer_{ a } {
+        FFL_CODDING_ERROR_IF(0 == buffer_size);
+        FFL_CODDING_ERROR_IF_NOT(traits_traits::roundup_to_alignment(file_offset) == file_offset);
+        buffer_.resize_buffer(buffer_size);
+    }
+
+    flat_forward_list_writer(flat_forward_list_writer const &) = delete;
+    flat_forward_list_writer &operator=(flat_forward_list_writer const &) = delete;
+
+    //!
+    //! @brief Destructor writes elements that are still in the staging buffer.
+    //! Errors are ignored.
+    //!
+    ~flat_forward_list_writer() noexcept {
+        if (!buffer_.empty()) {
+            write_to_fd(fd_, buffer_.data(), buffer_.used_capacity(), file_offset_);
+        }
+    }
+
+    //!
+    //! @brief Constructs new element at the end of the list.
+    //! @tparam F - type of a functor
+    //! @param element_size - number of bytes required for the new element.
+    //! @param fn - a functor used to construct new element.
+    //! @throw std::system_error if writing segment fails.
+    //!        std::bad_alloc if element does not fit staging buffer, and
+    //!        growing buffer fails.
+    //!        Any exceptions that might be raised by the functor.
+    //!
+    template <typename F>
+    void emplace_back(size_type element_size, F const &fn) {
+        if (buffer_.try_emplace_back(element_size, fn)) {
+            return;
+        }
+        write_segment();
+        if (!buffer_.try_emplace_back(element_size, fn)) {
+            buffer_.emplace_back(element_size, fn);
+        }
+    }
+
+    //!
+    //! @brief Adds new element to the end of the list.
+    //! Element is initialized by copping provided buffer.
+    //! @param init_buffer_size - size of the buffer that will be used for initialization.
+    //! @param init_buffer - a pointer to the buffer. If pointer to the buffer is nullptr then
+    //!                      element data are zero initialized.
+    //! @throw std::system_error if writing segment fails.
+    //!        std::bad_alloc if element does not fit staging buffer, and
+    //!        growing buffer fails.
+    //!
+    void push_back(size_type init_buffer_size,
+                   char const *init_buffer = nullptr) {
+        emplace_back(init_buffer_size,
+                     [init_buffer_size, init_buffer](T &buffer,
+                                                     size_type element_size) {
+                         FFL_CODDING_ERROR_IF_NOT(init_buffer_size == element_size);
+                         if (init_buffer) {
+                             copy_data(reinterpret_cast<char *>(&buffer), init_buffer, element_size);
+                         } else {
+                             zero_buffer(reinterpret_cast<char *>(&buffer), element_size);
+                         }
+                     });
+    }
+
+    //!
+    //! @brief Writes all elements in the staging buffer to the file.
+    //! @throw std::system_error if write fails.
+    //! @details Last element stays in the staging buffer, and will be
+    //! written again once next element is linked to it.
+    //!
+    void flush() {
+        if (!buffer_.empty()) {
+            write_buffer();
+        }
+    }
+
+    //!
+    //! @returns Size of the list in the file, including elements
+    //! that are not written yet.
+    //!
+    size_type file_size() const noexcept {
+        return file_offset_ + buffer_.used_capacity();
+    }
+
+    //!
+    //! @returns Offset in the file where staging buffer will be written.
+    //!
+    size_type segment_offset() const noexcept {
+        return file_offset_;
+    }
+
+    //!
+    //! @returns View of the elements in the staging buffer.
+    //!
+    flat_forward_list_view<T, TT> staging_view() const noexcept {
+        return flat_forward_list_view<T, TT>{ buffer_ };
+    }
+
+private:
+
+    //!
+    //! @brief Writes staging buffer at the segment offset.
+    //! @throw std::system_error if write fails.
+    //!
+    void write_buffer() {
+        int const error{ write_to_fd(fd_, buffer_.data(), buffer_.used_capacity(), file_offset_) };
+        if (0 != error) {
+            throw std::system_error{ error, std::generic_category(), "flat_forward_list_writer write failed" };
+        }
+    }
+
+    //!
+    //! @brief Writes staging buffer, and starts a new segment
+    //! from the last element.
+    //! @throw std::system_error if write fails.
+    //!
+    void write_segment() {
+        if (buffer_.empty()) {
+            return;
+        }
+        write_buffer();
+        //
+        // Next segment starts at the last element.
+        // Elements before it are linked and will not change.
+        //
+        size_type const last_element_offset{ static_cast<size_type>(buffer_.last().get_ptr() - buffer_.data()) };
+        buffer_.erase(buffer_.begin(), buffer_.last());
+        file_offset_ += last_element_offset;
+    }
+
+    //!
+    //! @brief File descriptor we are writing to.
+    //!
+    int fd_{ -1 };
+    //!
+    //! @brief Offset in the file where staging buffer starts.
+    //!
+    size_type file_offset_{ 0 };
+    //!
+    //! @brief Staging buffer.
+    //!
+    list_type buffer_;
+};
+
+//!
+//! @typedef pmr_flat_forward_list_writer
+//! @brief Writer that uses polymorphic allocator for the staging buffer
+//! @tparam T - element type
+//! @tparam TT - element traits type
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+using pmr_flat_forward_list_writer = flat_forward_list_writer<T, TT, FFL_PMR::polymorphic_allocator<char>>;
+
+//!
+//! @class fd_source
+//! @brief Source of data for flat_forward_list_reader that reads
+//! from a file descriptor.
+//!
+class fd_source {
+public:
+    //!
+    //! @brief Constructs source.
+    //! @param fd - file descriptor opened for read. Source does not own it.
+    //!
+    explicit fd_source(int fd) noexcept
+        : fd_{ fd } {
+    }
+    //!
+    //! @brief Reads next chunk of data.
+    //! @param buffer - buffer that receives data.
+    //! @param buffer_size - maximum number of bytes we can read.
+    //! @return Number of bytes read, 0 at the end of file.
+    //! @throw std::system_error if read fails.
+    //!
+    size_t operator() (char *buffer, size_t buffer_size) const {
+        for (;;) {
+            ssize_t const result{ read(fd_, buffer, buffer_size) };
+            if (result >= 0) {
+                return static_cast<size_t>(result);
+            }
+            if (EINTR != errno) {
+                throw std::system_error{ errno, std::generic_category(), "fd_source read failed" };
+            }
+        }
+    }
+
+private:
+    //!
+    //! @brief File descriptor we are reading from.
+    //!
+    int fd_{ -1 };
+};
+
+//!
+//! @class istream_source
+//! @brief Source of data for flat_forward_list_reader that reads
+//! from a std::istream.
+//!
+class istream_source {
+public:
+    //!
+    //! @brief Constructs source.
+    //! @param is - stream we are reading from. Source does not own it.
+    //!
+    explicit istream_source(std::istream &is) noexcept
+        : is_{ &is } {
+    }
+    //!
+    //! @brief Reads next chunk of data.
+    //! @param buffer - buffer that receives data.
+    //! @param buffer_size - maximum number of bytes we can read.
+    //! @return Number of bytes read, 0 at the end of stream.
+    //! @throw std::system_error if stream is in a bad state.
+    //!
+    size_t operator() (char *buffer, size_t buffer_size) const {
+        is_->read(buffer, static_cast<std::streamsize>(buffer_size));
+        if (is_->bad()) {
+            throw std::system_error{ EIO, std::generic_category(), "istream_source read failed" };
+        }
+        return static_cast<size_t>(is_->gcount());
+    }
+
+private:
+    //!
+    //! @brief Stream we are reading from.
+    //!
+    std::istream *is_{ nullptr };
+};
+
+//!
+//! @brief Default limit of the buffer that reader grows to.
+//! @details Size of an element comes from an untrusted stream.
+//! Reader does not grow buffer above the limit, and reports
+//! element that does not fit in the limit as corruption.
+//! Callers that expect larger elements pass their own limit.
+//!
+constexpr size_t const reader_default_max_buffer_size{ 64 * 1024 * 1024 };
+
+//!
+//! @class flat_forward_list_reader
+//! @brief Streaming reader that hands out views over batches of complete
+//! elements read from a source.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type used by the buffer
+//! @details Reader reads source into a reusable buffer until buffer is full,
+//! validates it, and returns a view over complete elements. Element that
+//! did not fit in the buffer is moved to the beginning of the buffer when
+//! next batch is requested, and the rest of the buffer is filled from the
+//! source. Views remain valid until next call to read_next.
+//!
+//! Source is any functor with signature
+//! @code size_t (char *buffer, size_t buffer_size) @endcode
+//! that returns 0 at the end of stream. See fd_source and istream_source.
+//!
+//! Buffer grows only when a single element does not fit in it.
+//! Size of an element comes from the stream, so buffer does not grow
+//! above the limit passed to the constructor, and element that does
+//! not fit in that limit is reported as corruption, see
+//! reader_default_max_buffer_size.
+//!
+//! For element types that have next element offset reader stops at the
+//! element with next element offset 0. Data after that element are ignored.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_reader<FLAT_FORWARD_LIST_TEST> reader{ 64 * 1024 };
+//! iffl::fd_source source{ fd };
+//! for (auto view{ reader.read_next(source) }; !view.empty(); view = reader.read_next(source)) {
+//!     for (auto const &e : view) {
+//!         <process element>
+//!     }
+//! }
+//! if (reader.is_corrupted() || reader.pending_size()) {
+//!     <stream does not end with a valid list>
+//! }
+//! @endcode
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class flat_forward_list_reader final {
+public:
+    //!
+    //! @typedef value_type
+    //! @brief Element value type
+    //!
+    using value_type = T;
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits
+    //! @brief Element traits type
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Element traits traits type
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef view_type
+    //! @brief Type of the view over a batch of elements
+    //!
+    using view_type = flat_forward_list_view<T, TT>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator
+    //!
+    using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<char>;
+
+    //!
+    //! @brief Constructs reader.
+    //! @param buffer_size - initial size of the buffer.
+    //! @param a - allocator used for the buffer.
+    //! @param max_buffer_size - largest size buffer can grow to.
+    //! @throw std::bad_alloc if allocating buffer fails
+    //!
+    explicit flat_forward_list_reader(size_type buffer_size,
+                                      A const &a = A{},
+                                      size_type max_buffer_size = reader_default_max_buffer_size)
+        : buffer_(buffer_size, '\0', allocator_type{ a })
+        , max_buffer_size_{ max_buffer_size } {
+        FFL_CODDING_ERROR_IF(buffer_size < traits_traits::minimum_size());
+        FFL_CODDING_ERROR_IF(buffer_size > max_buffer_size);
+    }
+
+    flat_forward_list_reader(flat_forward_list_reader const &) = delete;
+    flat_forward_list_reader &operator=(flat_forward_list_reader const &) = delete;
+
+    //!
+    //! @brief Reads next batch of elements.
+    //! @tparam R - type of the source functor.
+    //! @param source - functor that reads data.
+    //! @return View over complete elements. Empty view when there are no
+    //! more elements. Use is_corrupted and pending_size to find if stream
+    //! ended with a valid list. Element larger than the buffer size limit
+    //! is reported as corruption.
+    //! @throw std::bad_alloc if buffer has to grow to fit an element, and
+    //!        allocation fails.
+    //!        Any exceptions raised by the source.
+    //!
+    template <typename R>
+    view_type read_next(R const &source) {
+        consume_batch();
+
+        for (;;) {
+            fill_buffer(source);
+
+            if (0 == filled_size_ || corrupted_) {
+                return view_type{};
+            }
+
+            char *const begin{ buffer_.data() };
+            auto const [is_valid, view] = flat_forward_list_validate<T, TT>(begin, begin + filled_size_);
+
+            if (!view.empty()) {
+                char const *const last{ view.last().get_ptr() };
+                size_type const last_offset{ static_cast<size_type>(last - begin) };
+                size_with_padding_t const last_size{ traits_traits::get_size(last) };
+                size_type const next_offset{ traits_traits::get_next_offset(last) };
+                //
+                // Element with next offset 0 terminates the list
+                //
+                if (traits_traits::has_next_offset_v && is_valid) {
+                    end_of_list_ = true;
+                    batch_size_ = filled_size_;
+                } else {
+                    batch_size_ = std::min(last_offset + next_offset, filled_size_);
+                }
+                return view_type{ begin, begin + last_offset, begin + last_offset + last_size.size };
+            }
+            //
+            // Buffer does not start with a complete element.
+            // Figure out if element is partial or corrupted.
+            //
+            size_type const required_size{ partial_element_size(begin) };
+            if (0 == required_size || required_size > max_buffer_size_) {
+                corrupted_ = true;
+                return view_type{};
+            }
+            if (source_drained_) {
+                return view_type{};
+            }
+            if (required_size > buffer_.size()) {
+                buffer_.resize(std::min(std::max(required_size, buffer_.size() * 2), max_buffer_size_));
+            }
+        }
+    }
+
+    //!
+    //! @brief Reads next batch of elements from a file descriptor.
+    //! @param fd - file descriptor opened for read.
+    //! @return View over complete elements.
+    //! @throw std::system_error if read fails.
+    //!
+    view_type read_next(int fd) {
+        return read_next(fd_source{ fd });
+    }
+
+    //!
+    //! @brief Reads next batch of elements from a stream.
+    //! @param is - stream we are reading from.
+    //! @return View over complete elements.
+    //! @throw std::system_error if stream is in a bad state.
+    //!
+    view_type read_next(std::istream &is) {
+        return read_next(istream_source{ is });
+    }
+
+    //!
+    //! @returns true if source does not have more data, and reader
+    //! returned all complete elements.
+    //!
+    bool eof() const noexcept {
+        return end_of_list_ || (source_drained_ && filled_size_ == batch_size_);
+    }
+
+    //!
+    //! @returns true if reader found an element that failed validation.
+    //!
+    bool is_corrupted() const noexcept {
+        return corrupted_;
+    }
+
+    //!
+    //! @returns Number of bytes read from the source that do
+    //! not belong to any returned element. After the source is drained a
+    //! non-zero value means that stream ends with a truncated element.
+    //!
+    size_type pending_size() const noexcept {
+        return end_of_list_ ? 0 : filled_size_ - batch_size_;
+    }
+
+    //!
+    //! @returns Offset in the stream of the first element of
+    //! the last returned batch.
+    //!
+    size_type stream_offset() const noexcept {
+        return stream_offset_;
+    }
+
+    //!
+    //! @returns Current buffer size.
+    //!
+    size_type buffer_size() const noexcept {
+        return buffer_.size();
+    }
+
+private:
+    //!
+    //! @typedef size_with_padding_t
+    //! @brief Vocabulary type used to describe size with padding
+    //!
+    using size_with_padding_t = typename traits_traits::size_with_padding_t;
+
+    //!
+    //! @brief Moves partial element that follows last returned
+    //! batch to the beginning of the buffer.
+    //!
+    void consume_batch() noexcept {
+        if (0 == batch_size_) {
+            return;
+        }
+        move_data(buffer_.data(), buffer_.data() + batch_size_, filled_size_ - batch_size_);
+        filled_size_ -= batch_size_;
+        stream_offset_ += batch_size_;
+        batch_size_ = 0;
+    }
+
+    //!
+    //! @brief Reads from source until buffer is full or
+    //! source is drained.
+    //! @tparam R - type of the source functor.
+    //! @param source - functor that reads data.
+    //!
+    template <typename R>
+    void fill_buffer(R const &source) {
+        while (!source_drained_ && !end_of_list_ && filled_size_ < buffer_.size()) {
+            size_type const bytes_read{ source(buffer_.data() + filled_size_, buffer_.size() - filled_size_) };
+            if (0 == bytes_read) {
+                source_drained_ = true;
+            }
+            filled_size_ += bytes_read;
+        }
+    }
+
+    //!
+    //! @brief Calculates how many bytes we need to have in the buffer
+    //! to validate element that did not pass validation.
+    //! @param element - pointer to the element at the beginning of the buffer.
+    //! @return Required size if element is not complete, and 0 if
+    //! element is complete, but did not pass validation.
+    //!
+    size_type partial_element_size(char const *element) const noexcept {
+        if (filled_size_ < traits_traits::minimum_size()) {
+            return traits_traits::minimum_size();
+        }
+        size_type required_size{ traits_traits::get_size(element).size };
+        if constexpr (traits_traits::has_next_offset_v) {
+            required_size = std::max(required_size, traits_traits::get_next_offset(element));
+        }
+        return required_size > filled_size_ ? required_size : 0;
+    }
+
+    //!
+    //! @brief Buffer we read data to.
+    //!
+    std::vector<char, allocator_type> buffer_;
+    //!
+    //! @brief Largest size buffer can grow to.
+    //!
+    size_type max_buffer_size_{ reader_default_max_buffer_size };
+    //!
+    //! @brief Number of bytes in the buffer that contain data.
+    //!
+    size_type filled_size_{ 0 };
+    //!
+    //! @brief Number of bytes at the beginning of the buffer used by the
+    //! last returned batch.
+    //!
+    size_type batch_size_{ 0 };
+    //!
+    //! @brief Offset in the stream of the buffer beginning.
+    //!
+    size_type stream_offset_{ 0 };
+    //!
+    //! @brief Source returned end of stream.
+    //!
+    bool source_drained_{ false };
+    //!
+    //! @brief We've returned element that terminates the list.
+    //!
+    bool end_of_list_{ false };
+    //!
+    //! @brief We've found element that failed validation.
+    //!
+    bool corrupted_{ false };
+};
+
+//!
+//! @typedef pmr_flat_forward_list_reader
+//! @brief Reader that uses polymorphic allocator for the buffer
+//! @tparam T - element type
+//! @tparam TT - element traits type
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+using pmr_flat_forward_list_reader = flat_forward_list_reader<T, TT, FFL_PMR::polymorphic_allocator<char>>;
+
+//!
+//! @brief Tells flat_forward_list_iovec if padding between
+//! elements should be exported.
+//!
+enum class iovec_padding {
+    //!
+    //! @brief Export bytes between elements, so receiver gets
+    //! the same layout as the sender.
+    //!
+    include,
+    //!
+    //! @brief Export only element data. Supported only for
+    //! element types without next element offset. Receiver must
+    //! use traits with alignment 1 to iterate the result.
+    //!
+    exclude,
+};
+
+//!
+//! @class flat_forward_list_iovec
+//! @brief Describes range of elements as an array of iovec
+//! that can be passed to writev or sendmsg.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @details Each iovec points to a contiguous run of bytes in the
+//! original buffer, so sending a range of elements does not require
+//! copying them to a staging buffer.
+//! Elements that are adjacent in the buffer are described by a single
+//! iovec.
+//!
+//! If last element in the range has a non-zero next element offset,
+//! for instance when range is a part of a larger list, then this element
+//! is copied to a buffer owned by this object, and its next element offset
+//! is set to 0, so receiver gets a valid list. All other elements are
+//! not copied.
+//!
+//! Object must outlive any use of the iovec array, and buffer that
+//! contains elements must not change until data are sent.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_iovec<FLAT_FORWARD_LIST_TEST> iov{ ffl.cbegin() + 2, ffl.cend() };
+//! int const error{ iov.write_to(fd) };
+//! // or
+//! msghdr msg{};
+//! msg.msg_iov = const_cast<iovec *>(iov.data());
+//! msg.msg_iovlen = iov.size();
+//! sendmsg(s, &msg, 0);
+//! @endcode
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+class flat_forward_list_iovec final {
+public:
+    //!
+    //! @typedef value_type
+    //! @brief Element value type
+    //!
+    using value_type = T;
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits
+    //! @brief Element traits type
+    //!
+    using traits = TT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Element traits traits type
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef const_iterator
+    //! @brief Type of iterators that describe a range
+    //!
+    using const_iterator = flat_forward_list_const_iterator<T, TT>;
+    //!
+    //! @typedef view_type
+    //! @brief Type of the view we can export
+    //!
+    using view_type = flat_forward_list_view<T, TT>;
+
+    flat_forward_list_iovec() = default;
+    flat_forward_list_iovec(flat_forward_list_iovec &&) = default;
+    flat_forward_list_iovec &operator=(flat_forward_list_iovec &&) = default;
+    flat_forward_list_iovec(flat_forward_list_iovec const &) = delete;
+    flat_forward_list_iovec &operator=(flat_forward_list_iovec const &) = delete;
+
+    //!
+    //! @brief Constructs iovec array for all elements of the view.
+    //! @param view - elements we are exporting.
+    //! @param padding - tells if padding between elements should be exported.
+    //! @throw std::bad_alloc if allocating iovec array fails
+    //!
+    explicit flat_forward_list_iovec(view_type const &view,
+                                     iovec_padding padding = iovec_padding::include) {
+        assign(view, padding);
+    }
+
+    //!
+    //! @brief Constructs iovec array for range of elements [first, end).
+    //! @param first - first element we are exporting.
+    //! @param end - element after the last element we are exporting.
+    //! @param padding - tells if padding between elements should be exported.
+    //! @throw std::bad_alloc if allocating iovec array fails
+    //!
+    flat_forward_list_iovec(const_iterator const &first,
+                            const_iterator const &end,
+                            iovec_padding padding = iovec_padding::include) {
+        assign(first, end, padding);
+    }
+
+    //!
+    //! @brief Replaces content with iovec array for all elements of the view.
+    //! @param view - elements we are exporting.
+    //! @param padding - tells if padding between elements should be exported.
+    //! @throw std::bad_alloc if allocating iovec array fails
+    //!
+    void assign(view_type const &view,
+                iovec_padding padding = iovec_padding::include) {
+        assign(view.cbegin(), view.cend(), padding);
+    }
+
+    //!
+    //! @brief Replaces content with iovec array for range of elements [first, end).
+    //! @param first - first element we are exporting.
+    //! @param end - element after the last element we are exporting.
+    //! @param padding - tells if padding between elements should be exported.
+    //! @throw std::bad_alloc if allocating iovec array fails
+    //! @details Stripping padding from a list of elements with next element offset
+    //! would leave offsets pointing to wrong locations, so it triggers fail fast.
+    //!
+    void assign(const_iterator const &first,
+                const_iterator const &end,
+                iovec_padding padding = iovec_padding::include) {
+        FFL_CODDING_ERROR_IF(traits_traits::has_next_offset_v && iovec_padding::exclude == padding);
+
+        clear();
+
+        for (const_iterator it{ first }; it != end;) {
+            char const *const element{ it.get_ptr() };
+            size_with_padding_t const element_size{ traits_traits::get_size(element) };
+            const_iterator next{ it };
+            ++next;
+
+            if (next == end) {
+                if constexpr (traits_traits::can_set_next_offset_v) {
+                    if (0 != traits_traits::get_next_offset(element)) {
+                        terminator_.assign(element, element + element_size.size);
+                        traits_traits::set_next_offset(terminator_.data(), 0);
+                        append(terminator_.data(), terminator_.size());
+                        break;
+                    }
+                }
+                append(element, element_size.size);
+            } else if (iovec_padding::exclude == padding) {
+                append(element, element_size.size);
+            } else {
+                append(element, static_cast<size_type>(next.get_ptr() - element));
+            }
+
+            it = next;
+        }
+    }
+
+    //!
+    //! @brief Removes all iovecs.
+    //!
+    void clear() noexcept {
+        iov_.clear();
+        terminator_.clear();
+        total_size_ = 0;
+    }
+
+    //!
+    //! @returns Pointer to the iovec array.
+    //!
+    iovec const *data() const noexcept {
+        return iov_.data();
+    }
+
+    //!
+    //! @returns Number of elements in the iovec array.
+    //!
+    size_type size() const noexcept {
+        return iov_.size();
+    }
+
+    //!
+    //! @returns true if iovec array is empty.
+    //!
+    bool empty() const noexcept {
+        return iov_.empty();
+    }
+
+    //!
+    //! @returns Number of bytes described by the iovec array.
+    //!
+    size_type total_size() const noexcept {
+        return total_size_;
+    }
+
+    //!
+    //! @brief Writes all bytes described by the iovec array to the file descriptor.
+    //! @param fd - file descriptor opened for write.
+    //! @return 0 on success, and errno value on failure.
+    //! @details Calls writev with at most IOV_MAX iovecs at a time, and
+    //! resumes after partial writes and on EINTR.
+    //!
+    int write_to(int fd) const noexcept {
+        size_type idx{ 0 };
+        size_type written_from_current{ 0 };
+        while (idx < iov_.size()) {
+            ssize_t result{ 0 };
+            if (0 == written_from_current) {
+                size_type const count{ std::min(iov_.size() - idx, max_iov_count) };
+                result = writev(fd, iov_.data() + idx, static_cast<int>(count));
+            } else {
+                result = write(fd,
+                               static_cast<char const *>(iov_[idx].iov_base) + written_from_current,
+                               iov_[idx].iov_len - written_from_current);
+            }
+            if (result < 0) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                return errno;
+            }
+            size_type bytes{ static_cast<size_type>(result) };
+            while (0 < bytes && idx < iov_.size()) {
+                size_type const remaining{ iov_[idx].iov_len - written_from_current };
+                if (bytes < remaining) {
+                    written_from_current += bytes;
+                    bytes = 0;
+                } else {
+                    bytes -= remaining;
+                    written_from_current = 0;
+                    ++idx;
+                }
+            }
+        }
+        return 0;
+    }
+
+private:
+    //!
+    //! @typedef size_with_padding_t
+    //! @brief Vocabulary type used to describe size with padding
+    //!
+    using size_with_padding_t = typename traits_traits::size_with_padding_t;
+
+    //!
+    //! @brief Maximum number of iovecs we pass to a single writev call
+    //!
+#if defined(IOV_MAX)
+    constexpr static size_type const max_iov_count{ IOV_MAX };
+#else
+    constexpr static size_type const max_iov_count{ 1024 };
+#endif
+
+    //!
+    //! @brief Adds run of bytes to the iovec array. If run starts
+    //! where previous run ends then extends previous run.
+    //! @param buffer - pointer to the beginning of the run.
+    //! @param length - length of the run.
+    //!
+    void append(char const *buffer, size_type length) {
+        if (!iov_.empty()) {
+            iovec &prev{ iov_.back() };
+            if (static_cast<char const *>(prev.iov_base) + prev.iov_len == buffer) {
+                prev.iov_len += length;
+                total_size_ += length;
+                return;
+            }
+        }
+        iov_.push_back(iovec{ const_cast<char *>(buffer), length });
+        total_size_ += length;
+    }
+
+    //!
+    //! @brief iovec array.
+    //!
+    std::vector<iovec> iov_;
+    //!
+    //! @brief Copy of the last element with next element offset set to 0.
+    //!
+    std::vector<char> terminator_;
+    //!
+    //! @brief Number of bytes described by iovec array.
+    //!
+    size_type total_size_{ 0 };
+};
+
+//!
+//! @class flat_forward_list_loader
+//! @brief Loads lists from many files, and attaches each file content
+//! to a container without copying it.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam A - allocator type used by the containers
+//! @details For each file loader allocates buffer of the file size using
+//! container allocator, and reads the whole file into it.
+//!
+//! When built with io_uring support (see FFL_USE_LIBURING) loader keeps up to
+//! queue depth reads in flight. Each buffer is validated with
+//! flat_forward_list_validate and handed to the callback as soon as its read
+//! completes, so validation and processing overlap with outstanding reads.
+//! If io_uring is not available or fails to initialize, then loader reads
+//! files one by one with pread.
+//!
+//! Callback has signature
+//! @code void (size_t file_index, int error, bool is_valid, flat_forward_list<T, TT, A> &list) @endcode
+//! - file_index - index of the file descriptor in the input array.
+//! - error - 0 on success, and errno value if read failed.
+//! - is_valid - result of the buffer validation.
+//! - list - container that owns the buffer. If buffer is not valid
+//!   container has no elements. Callback can move the container out.
+//!
+//! Callbacks are called on the thread that calls load, in the order
+//! reads complete.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::flat_forward_list_loader<FLAT_FORWARD_LIST_TEST> loader;
+//! std::vector<iffl::flat_forward_list<FLAT_FORWARD_LIST_TEST>> lists(fds.size());
+//! loader.load(fds.data(),
+//!             fds.size(),
+//!             [&lists](size_t file_index, int error, bool is_valid, auto &list) {
+//!                 if (0 == error && is_valid) {
+//!                     lists[file_index] = std::move(list);
+//!                 }
+//!             });
+//! @endcode
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class flat_forward_list_loader final {
+public:
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef list_type
+    //! @brief Type of the container we attach buffers to
+    //!
+    using list_type = flat_forward_list<T, TT, A>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator
+    //!
+    using allocator_type = typename list_type::allocator_type;
+    //!
+    //! @typedef allocator_type_traits
+    //! @brief Type of allocator traits
+    //!
+    using allocator_type_traits = std::allocator_traits<allocator_type>;
+
+    //!
+    //! @brief Constructs loader.
+    //! @param queue_depth - maximum number of reads in flight.
+    //! @param a - allocator used for buffers.
+    //!
+    explicit flat_forward_list_loader(unsigned int queue_depth = 32,
+                                      A const &a = A{}) noexcept
+        : queue_depth_{ queue_depth ? queue_depth : 1 }
+        , alloc_{ a } {
+#if defined(FFL_HAS_LIBURING)
+        ring_initialized_ = (0 == io_uring_queue_init(queue_depth_, &ring_, 0));
+#endif
+    }
+
+    flat_forward_list_loader(flat_forward_list_loader const &) = delete;
+    flat_forward_list_loader &operator=(flat_forward_list_loader const &) = delete;
+
+    //!
+    //! @brief Destructor releases io_uring
+    //!
+    ~flat_forward_list_loader() noexcept {
+#if defined(FFL_HAS_LIBURING)
+        if (ring_initialized_) {
+            io_uring_queue_exit(&ring_);
+        }
+#endif
+    }
+
+    //!
+    //! @returns true if loader submits reads through io_uring.
+    //!
+    bool uses_io_uring() const noexcept {
+#if defined(FFL_HAS_LIBURING)
+        return ring_initialized_;
+#else
+        return false;
+#endif
+    }
+
+    //!
+    //! @brief Loads list from each file.
+    //! @tparam F - type of the callback.
+    //! @param fds - array of file descriptors opened for read.
+    //! @param count - number of file descriptors.
+    //! @param fn - callback that is called once for every file.
+    //! @throw std::bad_alloc if allocating a buffer fails.
+    //!        std::system_error if io_uring fails.
+    //!        Any exceptions raised by the callback. Loader waits for
+    //!        reads in flight to complete before it rethrows.
+    //!
+    template <typename F>
+    void load(int const *fds, size_type count, F const &fn) {
+#if defined(FFL_HAS_LIBURING)
+        if (ring_initialized_) {
+            load_io_uring(fds, count, fn);
+            return;
+        }
+#endif
+        load_pread(fds, count, fn);
+    }
+
+private:
+
+    //!
+    //! @brief State of a single file read
+    //!
+    struct load_request {
+        size_type file_index{ 0 };
+        int fd{ -1 };
+        int error{ 0 };
+        char *buffer{ nullptr };
+        size_type buffer_size{ 0 };
+        size_type bytes_read{ 0 };
+    };
+
+    //!
+    //! @brief Allocates buffer of the file size.
+    //! @param request - request we are preparing.
+    //! @throw std::bad_alloc if allocating a buffer fails.
+    //!
+    void prepare_request(load_request &request) {
+        struct stat st {};
+        if (0 != fstat(request.fd, &st)) {
+            request.error = errno;
+            return;
+        }
+        request.buffer_size = static_cast<size_type>(st.st_size);
+        if (request.buffer_size) {
+            request.buffer = allocator_type_traits::allocate(alloc_, request.buffer_size);
+        }
+    }
+
+    //!
+    //! @brief Frees request buffer if container did not adopt it.
+    //! @param request - request we are releasing.
+    //!
+    void release_request(load_request &request) noexcept {
+        if (request.buffer) {
+            allocator_type_traits::deallocate(alloc_, request.buffer, request.buffer_size);
+            request.buffer = nullptr;
+        }
+    }
+
+    //!
+    //! @brief Validates buffer, attaches it to a container,
+    //! and calls callback.
+    //! @tparam F - type of the callback.
+    //! @param request - completed request.
+    //! @param fn - callback.
+    //!
+    template <typename F>
+    void complete_request(load_request &request, F const &fn) {
+        list_type list{ alloc_ };
+        bool is_valid{ true };
+        if (0 == request.error && request.buffer) {
+            //
+            // If file shrunk after we queried its size, then
+            // part of the buffer past bytes_read has no data.
+            //
+            auto const [valid, view] = flat_forward_list_validate<T, TT>(request.buffer,
+                                                                        request.buffer + request.bytes_read);
+            is_valid = valid;
+            char *last_element{ nullptr };
+            if (is_valid && !view.empty()) {
+                last_element = request.buffer + (view.last().get_ptr() - request.buffer);
+            }
+            list.attach(request.buffer,
+                        last_element,
+                        request.buffer + request.buffer_size);
+            request.buffer = nullptr;
+        } else {
+            release_request(request);
+        }
+        fn(request.file_index, request.error, is_valid, list);
+    }
+
+    //!
+    //! @brief Reads files one by one using pread.
+    //! @tparam F - type of the callback.
+    //! @param fds - array of file descriptors opened for read.
+    //! @param count - number of file descriptors.
+    //! @param fn - callback.
+    //!
+    template <typename F>
+    void load_pread(int const *fds, size_type count, F const &fn) {
+        for (size_type idx = 0; idx < count; ++idx) {
+            load_request request;
+            request.file_index = idx;
+            request.fd = fds[idx];
+            auto release{ make_scope_guard([this, &request]() noexcept {
+                release_request(request);
+            }) };
+            prepare_request(request);
+            if (0 == request.error && request.buffer) {
+                request.error = read_from_fd(request.fd,
+                                             request.buffer,
+                                             request.buffer_size,
+                                             0,
+                                             &request.bytes_read);
+            }
+            complete_request(request, fn);
+        }
+    }
+
+#if defined(FFL_HAS_LIBURING)
+
+    //!
+    //! @brief Queues read of the part of the file that we did not read yet.
+    //! @param request - request we are reading.
+    //!
+    void submit_read(load_request &request) {
+        io_uring_sqe *sqe{ io_uring_get_sqe(&ring_) };
+        if (nullptr == sqe) {
+            io_uring_submit(&ring_);
+            sqe = io_uring_get_sqe(&ring_);
+            if (nullptr == sqe) {
+                throw std::system_error{ EBUSY, std::generic_category(), "io_uring submission queue is full" };
+            }
+        }
+        io_uring_prep_read(sqe,
+                           request.fd,
+                           request.buffer + request.bytes_read,
+                           static_cast<unsigned int>(std::min<size_type>(request.buffer_size - request.bytes_read,
+                                                                         std::numeric_limits<unsigned int>::max())),
+                           static_cast<__u64>(request.bytes_read));
+        io_uring_sqe_set_data(sqe, &request);
+    }
+
+    //!
+    //! @brief Reads files through io_uring keeping up to queue_depth_
+    //! reads in flight.
+    //! @tparam F - type of the callback.
+    //! @param fds - array of file descriptors opened for read.
+    //! @param count - number of file descriptors.
+    //! @param fn - callback.
+    //!
+    template <typename F>
+    void load_io_uring(int const *fds, size_type count, F const &fn) {
+        std::vector<load_request> requests(count);
+        size_type next_request{ 0 };
+        size_type completed_count{ 0 };
+        size_type in_flight_count{ 0 };
+        //
+        // Kernel is writing to buffers of requests in flight.
+        // Wait for these reads before freeing buffers.
+        //
+        auto release{ make_scope_guard([this, &requests, &in_flight_count]() noexcept {
+            while (0 < in_flight_count) {
+                //
+                // Reads that are queued, but not submitted, never
+                // complete. Submit them before waiting. If submit fails
+                // and there is no submitted read we can reap, retry.
+                // Kernel returns EAGAIN and EBUSY when it is out of
+                // resources, so back off before retrying.
+                //
+                unsigned int const queued_count{ io_uring_sq_ready(&ring_) };
+                if (0 < queued_count) {
+                    int const submitted{ io_uring_submit(&ring_) };
+                    FFL_CODDING_ERROR_IF(submitted < 0 &&
+                                         -EINTR != submitted &&
+                                         -EAGAIN != submitted &&
+                                         -EBUSY != submitted);
+                    if (submitted < 0 && in_flight_count == queued_count) {
+                        if (-EINTR != submitted) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+                        }
+                        continue;
+                    }
+                }
+                io_uring_cqe *cqe{ nullptr };
+                int const result{ io_uring_wait_cqe(&ring_, &cqe) };
+                if (-EINTR == result) {
+                    continue;
+                }
+                FFL_CODDING_ERROR_IF(0 != result);
+                io_uring_cqe_seen(&ring_, cqe);
+                --in_flight_count;
+            }
+            for (load_request &request : requests) {
+                release_request(request);
+            }
+        }) };
+
+        while (completed_count < count) {
+            while (in_flight_count < queue_depth_ && next_request < count) {
+                load_request &request{ requests[next_request] };
+                request.file_index = next_request;
+                request.fd = fds[next_request];
+                ++next_request;
+                prepare_request(request);
+                if (0 != request.error || nullptr == request.buffer) {
+                    ++completed_count;
+                    complete_request(request, fn);
+                    continue;
+                }
+                submit_read(request);
+                ++in_flight_count;
+            }
+
+            if (0 == in_flight_count) {
+                continue;
+            }
+
+            int result{ io_uring_submit(&ring_) };
+            if (result < 0 && -EINTR != result) {
+                throw std::system_error{ -result, std::generic_category(), "io_uring_submit failed" };
+            }
+
+            io_uring_cqe *cqe{ nullptr };
+            result = io_uring_wait_cqe(&ring_, &cqe);
+            if (-EINTR == result) {
+                continue;
+            }
+            if (0 != result) {
+                throw std::system_error{ -result, std::generic_category(), "io_uring_wait_cqe failed" };
+            }
+            load_request &request{ *static_cast<load_request *>(io_uring_cqe_get_data(cqe)) };
+            int const bytes_read{ cqe->res };
+            io_uring_cqe_seen(&ring_, cqe);
+            --in_flight_count;
+
+            if (-EINTR == bytes_read || -EAGAIN == bytes_read) {
+                submit_read(request);
+                ++in_flight_count;
+                continue;
+            }
+            if (bytes_read < 0) {
+                request.error = -bytes_read;
+            } else {
+                request.bytes_read += static_cast<size_type>(bytes_read);
+                //
+                // Short read. Queue read of the remaining part
+                // unless we've reached end of file.
+                //
+                if (0 < bytes_read && request.bytes_read < request.buffer_size) {
+                    submit_read(request);
+                    ++in_flight_count;
+                    continue;
+                }
+            }
+            ++completed_count;
+            complete_request(request, fn);
+        }
+    }
+
+    //!
+    //! @brief io_uring instance.
+    //!
+    io_uring ring_{};
+    //!
+    //! @brief true if io_uring_queue_init succeeded.
+    //!
+    bool ring_initialized_{ false };
+
+#endif
+
+    //!
+    //! @brief Maximum number of reads in flight.
+    //!
+    unsigned int queue_depth_{ 32 };
+    //!
+    //! @brief Allocator used for buffers.
+    //!
+    allocator_type alloc_;
+};
+
+//!
+//! @typedef pmr_flat_forward_list_loader
+//! @brief Loader that uses polymorphic allocator for the buffers
+//! @tparam T - element type
+//! @tparam TT - element traits type
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+using pmr_flat_forward_list_loader = flat_forward_list_loader<T, TT, FFL_PMR::polymorphic_allocator<char>>;
+
+} // namespace iffl
+
+#endif
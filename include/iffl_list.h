@@ -266,6 +266,25 @@ namespace iffl {
 //! constexpr static size_t const alignment{ TYPE_ALIGNMENT };
 //! @endcode 
 //!
+//! Specifies that every element has the same size. When provided then 
+//! get_size is not called, and for types that do not have get_next_offset
+//! containers find element count, and elements at position without walking
+//! the list, because element N starts at N * fixed_size padded to alignment.
+//!
+//! @code 
+//! constexpr static size_t const fixed_size{ ELEMENT_SIZE };
+//! @endcode 
+//!
+//! Lists nested in the element. Each type in the tuple has static
+//! validate(size_t element_size, T const &e) that validates the nested list.
+//! It is called after validate for the element succeeds, so nested lists
+//! are validated during the same traversal as the outer list.
+//! See flat_forward_list_nested_field in iffl_nested_list.h.
+//!
+//! @code 
+//! using nested_lists = std::tuple<NESTED_FIELD...>;
+//! @endcode 
+//!
 //! This method is used by flat_forward_list. It calculates size of element, but it should
 //! not use next element offset, and instead it should calculate size based on the data this 
 //! element contains. It is used when we append new element to the container, and need to
@@ -384,6 +403,24 @@ private:
     //!
     template <typename P>
     using has_alignment_mfn = decltype(std::declval<P &>().alignment);
+    //!
+    //! @typedef has_fixed_size_mfn
+    //! @tparam P - type we will evaluate this meta-function for. 
+    //!             Traits type should be used here.
+    //! !brief Meta-function that detects if traits define that all
+    //! elements have the same size
+    //!
+    template <typename P>
+    using has_fixed_size_mfn = decltype(std::declval<P &>().fixed_size);
+    //!
+    //! @typedef has_nested_lists_mfn
+    //! @tparam P - type we will evaluate this meta-function for. 
+    //!             Traits type should be used here.
+    //! !brief Meta-function that detects if traits declare lists
+    //! nested in the element
+    //!
+    template <typename P>
+    using has_nested_lists_mfn = typename P::nested_lists;
 
 public:
     //!
@@ -475,6 +512,43 @@ public:
     //!
     constexpr static auto const has_alignment_v{ iffl::mpl::is_detected_v < has_alignment_mfn, type_traits> };
     //!
+    //! @typedef has_fixed_size_t
+    //! @brief Uses detect idiom with has_fixed_size_mfn to
+    //! find if traits define fixed element size
+    //! @details If traits have traits::fixed_size static variable then 
+    //! has_fixed_size_t is std::true_type otherwise std::false_type
+    //!
+    using has_fixed_size_t = iffl::mpl::is_detected < has_fixed_size_mfn, type_traits>;
+    //!
+    //! @brief Instance of has_fixed_size_t 
+    //! @details has_fixed_size_v is std::true_type{} otherwise std::false_type{}
+    //!
+    constexpr static auto const has_fixed_size_v{ iffl::mpl::is_detected_v < has_fixed_size_mfn, type_traits> };
+    //!
+    //! @typedef has_nested_lists_t
+    //! @brief Uses detect idiom with has_nested_lists_mfn to
+    //! find if traits declare nested lists
+    //! @details If traits have traits::nested_lists type then 
+    //! has_nested_lists_t is std::true_type otherwise std::false_type
+    //!
+    using has_nested_lists_t = iffl::mpl::is_detected < has_nested_lists_mfn, type_traits>;
+    //!
+    //! @brief Instance of has_nested_lists_t 
+    //! @details has_nested_lists_v is std::true_type{} otherwise std::false_type{}
+    //!
+    constexpr static auto const has_nested_lists_v{ iffl::mpl::is_detected_v < has_nested_lists_mfn, type_traits> };
+    //!
+    //! @brief True when elements follow each other with a constant stride.
+    //! @details Elements of a type that does not have offset to the next 
+    //! element are placed right after previous element padded to alignment.
+    //! When all elements have the same size, element N starts at 
+    //! N * element_stride, so containers can calculate element count,
+    //! and find elements without walking the list.
+    //! Types that have offset to the next element can place next element
+    //! anywhere, so they do not get this optimization.
+    //!
+    constexpr static bool const has_fixed_stride_v{ has_fixed_size_v && !has_next_offset_v };
+    //!
     //! @brief Casts buffer pointer to a pointer to the element type
     //! @param ptr - pointer to a buffer
     //!
@@ -554,6 +628,22 @@ public:
     //!
     using offset_with_aligment_t = offset_with_aligment<alignment>;
     //!
+    //! @brief If traits defined fixed_size then returns that value,
+    //! and 0 otherwise
+    //!
+    [[nodiscard]] constexpr static size_t get_fixed_size() noexcept {
+        if constexpr (has_fixed_size_v) {
+            return type_traits::fixed_size;
+        } else {
+            return 0;
+        }
+    }
+    //!
+    //! @brief Defines static constexpr member with size of 
+    //! every element, or 0 if elements have variable size.
+    //!
+    constexpr static size_t const fixed_size{ get_fixed_size() };
+    //!
     //! @brief If traits defined alignment then s padded
     //! to alignment, or unchanged value of s otherwise
     //! @param s - value that we are rounding up
@@ -572,7 +662,72 @@ public:
     //! @return element size wrapped into size_with_padding_t
     //!
     [[nodiscard]] constexpr static size_with_padding_t get_size(char const *buffer) noexcept {
-        return size_with_padding_t{ type_traits::get_size(*ptr_to_t(buffer)) };
+        if constexpr (has_fixed_size_v) {
+            unused_variable(buffer);
+            return size_with_padding_t{ fixed_size };
+        } else {
+            return size_with_padding_t{ type_traits::get_size(*ptr_to_t(buffer)) };
+        }
+    }
+    //!
+    //! @brief Distance between starts of two consecutive elements
+    //! for types that have fixed stride.
+    //! @return fixed_size padded to alignment
+    //!
+    [[nodiscard]] constexpr static size_t element_stride() noexcept {
+        static_assert(has_fixed_stride_v,
+                      "element_stride is supported only for types with fixed size and without get_next_offset");
+        return size_with_padding_t{ fixed_size }.size_padded();
+    }
+    //!
+    //! @brief Calculates number of elements for types with fixed stride.
+    //! @param begin - pointer to the first element
+    //! @param last - pointer to the last element, or nullptr if there
+    //! are no elements
+    //! @return number of elements
+    //!
+    [[nodiscard]] constexpr static size_t fixed_stride_count(char const *begin,
+                                                             char const *last) noexcept {
+        if (nullptr == last) {
+            return 0;
+        }
+        return static_cast<size_t>(last - begin) / element_stride() + 1;
+    }
+    //!
+    //! @brief For types with fixed stride finds offset of the last element
+    //! that ends before position.
+    //! @param begin - pointer to the first element
+    //! @param last - pointer to the last element, or nullptr if there
+    //! are no elements
+    //! @param position - offset from begin
+    //! @return offset of the element, or npos if element was not found
+    //!
+    [[nodiscard]] constexpr static size_t fixed_stride_offset_before(char const *begin,
+                                                                     char const *last,
+                                                                     size_t position) noexcept {
+        if (nullptr == last || position < fixed_size) {
+            return npos;
+        }
+        size_t const last_idx{ static_cast<size_t>(last - begin) / element_stride() };
+        size_t const idx{ (position - fixed_size) / element_stride() };
+        return (idx < last_idx ? idx : last_idx) * element_stride();
+    }
+    //!
+    //! @brief For types with fixed stride finds offset of the element
+    //! that contains position.
+    //! @param begin - pointer to the first element
+    //! @param last - pointer to the last element, or nullptr if there
+    //! are no elements
+    //! @param position - offset from begin
+    //! @return offset of the element, or npos if element was not found
+    //!
+    [[nodiscard]] constexpr static size_t fixed_stride_offset_at(char const *begin,
+                                                                 char const *last,
+                                                                 size_t position) noexcept {
+        if (nullptr == last || position >= static_cast<size_t>(last - begin) + fixed_size) {
+            return npos;
+        }
+        return (position / element_stride()) * element_stride();
     }
     //!
     //! @brief Asks type traits to validate element. 
@@ -583,7 +738,26 @@ public:
     //!
     [[nodiscard]] constexpr static bool validate(size_t buffer_size, T const &buffer) noexcept {
         if constexpr (can_validate_v) {
-            return type_traits::validate(buffer_size, buffer);
+            return type_traits::validate(buffer_size, buffer) &&
+                   validate_nested_lists(buffer_size, buffer);
+        } else {
+            return validate_nested_lists(buffer_size, buffer);
+        }
+    }
+    //!
+    //! @brief Validates lists nested in the element.
+    //! @param buffer_size - size of the buffer used by this element
+    //! @param buffer - element that passed validate
+    //! @return true if traits do not declare nested lists, or
+    //! every nested list is inside of the element, and is valid
+    //!
+    [[nodiscard]] constexpr static bool validate_nested_lists([[maybe_unused]] size_t buffer_size,
+                                                              [[maybe_unused]] T const &buffer) noexcept {
+        if constexpr (has_nested_lists_v) {
+            size_t const element_size{ get_size(reinterpret_cast<char const *>(&buffer)).size };
+            return validate_nested_lists_in(static_cast<typename type_traits::nested_lists const *>(nullptr),
+                                            std::min(buffer_size, element_size),
+                                            buffer);
         } else {
             return true;
         }
@@ -666,8 +840,35 @@ public:
         } else {
             std::printf("  alignment       : no \n");
         }
+
+        if constexpr (has_fixed_size_v) {
+            std::printf("  fixed_size      : yes -> %zu\n", fixed_size);
+        } else {
+            std::printf("  fixed_size      : no \n");
+        }
+
+        if constexpr (has_nested_lists_v) {
+            std::printf("  nested_lists    : yes -> %zu\n", std::tuple_size_v<typename type_traits::nested_lists>);
+        } else {
+            std::printf("  nested_lists    : no \n");
+        }
         std::printf("}\n");
     }
+
+private:
+    //!
+    //! @brief Calls validate of each nested list field.
+    //! @tparam N - nested list fields
+    //! @param element_size - size of the element
+    //! @param buffer - element
+    //! @return true if all nested lists are valid
+    //!
+    template <typename... N>
+    [[nodiscard]] constexpr static bool validate_nested_lists_in(std::tuple<N...> const *,
+                                                                 [[maybe_unused]] size_t element_size,
+                                                                 [[maybe_unused]] T const &buffer) noexcept {
+        return (N::validate(element_size, buffer) && ...);
+    }
 };
 
 
@@ -693,7 +894,8 @@ class flat_forward_list_ref;
 //! @tparam TT - element type traits. Defaulted to 
 //! specialization flat_forward_list_traits<T>
 //! @details
-//! Calls flat_forward_list_traits::validate(...)
+//! Calls flat_forward_list_traits::validate(...), and validates
+//! lists nested in the element.
 //!
 template<typename T,
          typename TT = flat_forward_list_traits<T>>
@@ -705,7 +907,8 @@ struct default_validate_element_fn {
     //!
     bool operator() (size_t buffer_size, 
                      T const &e) const noexcept {
-        return TT::validate(buffer_size, e);
+        return TT::validate(buffer_size, e) &&
+               flat_forward_list_traits_traits<T, TT>::validate_nested_lists(buffer_size, e);
     }
 };
 //!
@@ -745,6 +948,15 @@ constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list
 //!
 //! @brief Forward declaration
 //!
+template<typename T,
+         typename TT = flat_forward_list_traits<T>,
+         typename F = default_validate_element_fn<T, TT>>
+constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list_validate_fixed_stride(char const *first,
+                                                                                                       char const *end,
+                                                                                                       F const &validate_element_fn = default_validate_element_fn<T, TT>{}) noexcept;
+//!
+//! @brief Forward declaration
+//!
 template<typename T,
          typename TT = flat_forward_list_traits<T>,
          typename F = default_validate_element_fn<T, TT>>
@@ -1182,12 +1394,16 @@ public:
     //! @details Advances iterator to the next element
     //!
     constexpr flat_forward_list_iterator_t &operator++() noexcept {
-        size_t const next_offset = traits_traits::get_next_offset(p_);
-        if (0 == next_offset) {
-            size_with_padding_t const element_size{ traits_traits::get_size(p_) };
-            p_ += element_size.size_padded();
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            p_ += traits_traits::element_stride();
         } else {
-            p_ += next_offset;
+            size_t const next_offset = traits_traits::get_next_offset(p_);
+            if (0 == next_offset) {
+                size_with_padding_t const element_size{ traits_traits::get_size(p_) };
+                p_ += element_size.size_padded();
+            } else {
+                p_ += next_offset;
+            }
         }
         return *this;
     }
@@ -1199,12 +1415,16 @@ public:
     //!
     constexpr flat_forward_list_iterator_t operator++(int) noexcept {
         flat_forward_list_iterator_t tmp{ p_ };
-        size_t next_offset = traits_traits::get_next_offset(p_);
-        if (0 == next_offset) {
-            size_with_padding_t element_size{ traits_traits::get_size(p_) };
-            p_ += element_size.size_padded();
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            p_ += traits_traits::element_stride();
         } else {
-            p_ += next_offset;
+            size_t next_offset = traits_traits::get_next_offset(p_);
+            if (0 == next_offset) {
+                size_with_padding_t element_size{ traits_traits::get_size(p_) };
+                p_ += element_size.size_padded();
+            } else {
+                p_ += next_offset;
+            }
         }
         return tmp;
     }
@@ -1216,12 +1436,19 @@ public:
     //! caller is responsible for making sure iterator would not get
     //! advanced beyond container's end, if that happen then behavior is 
     //! undefined.
+    //! For types with fixed stride cost is O(1).
     //!
     constexpr flat_forward_list_iterator_t operator+(unsigned int advance_by) const noexcept {
         flat_forward_list_iterator_t result{ get_ptr() };
-        while (nullptr != result.get_ptr() && 0 != advance_by) {
-            ++result;
-            --advance_by;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            if (nullptr != result.get_ptr()) {
+                result.p_ += advance_by * traits_traits::element_stride();
+            }
+        } else {
+            while (nullptr != result.get_ptr() && 0 != advance_by) {
+                ++result;
+                --advance_by;
+            }
         }
         return result;
     }
@@ -1368,6 +1595,14 @@ template <typename T,
 class flat_forward_list_ref final {
 public:
 
+    //!
+    //! @details Give other instantiations friend permissions
+    //! so a view can be initialized from a non-const ref
+    //!
+    template <typename TU,
+              typename TTU>
+    friend class flat_forward_list_ref;
+
     //
     // Technically we need T to be 
     // - trivially destructible
@@ -1375,7 +1610,7 @@ public:
     // - trivially movable
     // - trivially copyable
     //
-    static_assert(std::is_pod_v<T>, "T must be a Plain Old Definition");
+    static_assert(std::is_standard_layout_v<T> && std::is_trivial_v<T>, "T must be a Plain Old Definition");
     //!
     //! @brief True if this is a ref and false if this is a view
     //!
@@ -2016,19 +2251,24 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_before(size_type position) const noexcept {
         validate_pointer_invariants();
-        if (empty_unsafe()) {
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            size_type const offset{ traits_traits::fixed_stride_offset_before(buff().begin, buff().last, position) };
+            return npos == offset ? end() : const_iterator{ buff().begin + offset };
+        } else {
+            if (empty_unsafe()) {
+                return end();
+            }
+            auto[is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
+                                                                            buff().begin + position);
+            if (!buffer_view.empty()) {
+                return const_iterator{ buffer_view.last().get_ptr() };
+            }
             return end();
         }
-        auto[is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
-                                                                        buff().begin + position);
-        if (!buffer_view.empty()) {
-            return const_iterator{ buffer_view.last().get_ptr() };
-        }
-        return end();
     }
     //!
     //! @brief Searches for an element that contains given position.
@@ -2037,18 +2277,24 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_at(size_type position) const noexcept {
-        const_iterator it = find_element_before(position);
-        if (cend() != it) {
-            ++it;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            validate_pointer_invariants();
+            size_type const offset{ traits_traits::fixed_stride_offset_at(buff().begin, buff().last, position) };
+            return npos == offset ? end() : const_iterator{ buff().begin + offset };
+        } else {
+            const_iterator it = find_element_before(position);
             if (cend() != it) {
-                FFL_CODDING_ERROR_IF_NOT(contains(it, position));
-                return it;
+                ++it;
+                if (cend() != it) {
+                    FFL_CODDING_ERROR_IF_NOT(contains(it, position));
+                    return it;
+                }
             }
+            return end();
         }
-        return end();
     }
     //!
     //! @brief Searches for an element after the element that contains 
@@ -2058,7 +2304,7 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_after(size_type position) const noexcept {
         const_iterator it = find_element_at(position);
@@ -2075,15 +2321,20 @@ public:
     //! @returns Number of elements in the container.
     //! @details Cost of this algorithm is O(number of elements in container).
     //! Container does not actively cache/updates element count so we need to
-    //! scan list to find number of elements.
+    //! scan list to find number of elements. For types with fixed stride
+    //! cost is O(1).
     //!
     size_type size() const noexcept {
         validate_pointer_invariants();
-        size_type s = 0;
-        std::for_each(cbegin(), cend(), [&s](T const &) {
-            ++s;
-        });
-        return s;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            return traits_traits::fixed_stride_count(buff().begin, buff().last);
+        } else {
+            size_type s = 0;
+            std::for_each(cbegin(), cend(), [&s](T const &) {
+                ++s;
+            });
+            return s;
+        }
     }
     //!
     //! @brief Tells if container contains no elements.
@@ -2610,6 +2861,23 @@ public:
     template <typename TU,
               typename TTU>
     friend class flat_forward_list_ref;
+    //!
+    //! @details Give small_flat_forward_list friend permissions
+    //! so it can place buffer in the inline storage
+    //!
+    template <typename TU,
+              size_t NU,
+              typename TTU,
+              typename AU>
+    friend class small_flat_forward_list;
+    //!
+    //! @details Give static_flat_forward_list friend permissions
+    //! so it can place buffer in the storage inside of container
+    //!
+    template <typename TU,
+              size_t CU,
+              typename TTU>
+    friend class static_flat_forward_list;
 
     //
     // Technically we need T to be 
@@ -2618,7 +2886,7 @@ public:
     // - trivially movable
     // - trivially copyable
     //
-    static_assert(std::is_pod_v<T>, "T must be a Plain Old Definition");
+    static_assert(std::is_standard_layout_v<T> && std::is_trivial_v<T>, "T must be a Plain Old Definition");
     //!
     //! @typedef value_type
     //! @brief Element value type
@@ -3103,7 +3371,7 @@ public:
 
         FFL_CODDING_ERROR_IF(buff().begin == buffer_begin);
         if (last_element) {
-            FFL_CODDING_ERROR_IF_NOT(buffer_begin < last_element && last_element < buffer_end);
+            FFL_CODDING_ERROR_IF_NOT(buffer_begin <= last_element && last_element < buffer_end);
         } else {
             FFL_CODDING_ERROR_IF_NOT(buffer_begin < buffer_end);
         }
@@ -3175,7 +3443,7 @@ public:
         flat_forward_list l(get_allocator());
 
         if (last_element) {
-            FFL_CODDING_ERROR_IF_NOT(buffer_begin < last_element && last_element < buffer_end);
+            FFL_CODDING_ERROR_IF_NOT(buffer_begin <= last_element && last_element < buffer_end);
         } else {
             FFL_CODDING_ERROR_IF_NOT(buffer_begin < buffer_end);
         }
@@ -4063,7 +4331,7 @@ public:
         
         range_t const start_range = range_unsafe(start);
         range_t const end_range = range_unsafe(end);
-        size_type const bytes_to_copy{ prev_sizes.used_capacity().size - end_range.buffer_end };
+        size_type const bytes_to_copy{ prev_sizes.used_capacity().size - end_range.begin() };
         size_type const bytes_erased{ end_range.begin() - start_range.begin() };
 
         move_data(buff().begin + start_range.begin(),
@@ -4112,6 +4380,9 @@ public:
         // user.
         //
         std::vector<const_iterator> iterator_array;      
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            iterator_array.reserve(size());
+        }
         for (const_iterator i = begin(); i != end(); ++i) {
             iterator_array.push_back(i);
         }
@@ -4129,8 +4400,23 @@ public:
         //
         flat_forward_list sorted_list(get_allocator());
         sorted_list.resize_buffer(used_capacity());
-        for (const_iterator const &i : iterator_array) {
-            sorted_list.push_back(used_size(i), i.get_ptr());
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            //
+            // Element N goes to N * stride so we can copy 
+            // elements without updating container on each 
+            // element
+            //
+            char *sorted_element{ sorted_list.buff().begin };
+            for (const_iterator const &i : iterator_array) {
+                copy_data(sorted_element, i.get_ptr(), traits_traits::fixed_size);
+                sorted_list.buff().last = sorted_element;
+                sorted_element += traits_traits::element_stride();
+            }
+            sorted_list.validate_data_invariants();
+        } else {
+            for (const_iterator const &i : iterator_array) {
+                sorted_list.push_back(used_size(i), i.get_ptr());
+            }
         }
 
         //
@@ -4705,21 +4991,26 @@ public:
     //! container's end iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to perform linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     iterator find_element_before(size_type position) noexcept {
         validate_pointer_invariants();
-        if (empty_unsafe()) {
-            return end();
-        }
-        auto const [is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
-                                                                               buff().begin + position);
-        unused_variable(is_valid);
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            size_type const offset{ traits_traits::fixed_stride_offset_before(buff().begin, buff().last, position) };
+            return npos == offset ? end() : iterator{ buff().begin + offset };
+        } else {
+            if (empty_unsafe()) {
+                return end();
+            }
+            auto const [is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
+                                                                                   buff().begin + position);
+            unused_variable(is_valid);
 
-        if (!buffer_view.empty()) {
-            return iterator{ const_cast<char *>(buffer_view.last().get_ptr()) };
+            if (!buffer_view.empty()) {
+                return iterator{ const_cast<char *>(buffer_view.last().get_ptr()) };
+            }
+            return end();
         }
-        return end();
     }
     //!
     //! @brief Searches for an element before the element that contains 
@@ -4729,19 +5020,24 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_before(size_type position) const noexcept {
         validate_pointer_invariants();
-        if (empty_unsafe()) {
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            size_type const offset{ traits_traits::fixed_stride_offset_before(buff().begin, buff().last, position) };
+            return npos == offset ? end() : const_iterator{ buff().begin + offset };
+        } else {
+            if (empty_unsafe()) {
+                return end();
+            }
+            auto[is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
+                                                                            buff().begin + position);
+            if (!buffer_view.empty()) {
+                return const_iterator{ buffer_view.last() };
+            }
             return end();
         }
-        auto[is_valid, buffer_view] = flat_forward_list_validate<T, TT>(buff().begin,
-                                                                        buff().begin + position);
-        if (!buffer_view.empty()) {
-            return const_iterator{ buffer_view.last() };
-        }
-        return end();
     }
     //!
     //! @brief Searches for an element that contains given position.
@@ -4750,18 +5046,24 @@ public:
     //! container's end iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     iterator find_element_at(size_type position) noexcept {
-        iterator it = find_element_before(position);
-        if (end() != it) {
-            ++it;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            validate_pointer_invariants();
+            size_type const offset{ traits_traits::fixed_stride_offset_at(buff().begin, buff().last, position) };
+            return npos == offset ? end() : iterator{ buff().begin + offset };
+        } else {
+            iterator it = find_element_before(position);
             if (end() != it) {
-                FFL_CODDING_ERROR_IF_NOT(contains(it, position));
-                return it;
+                ++it;
+                if (end() != it) {
+                    FFL_CODDING_ERROR_IF_NOT(contains(it, position));
+                    return it;
+                }
             }
+            return end();
         }
-        return end();
     }
     //!
     //! @brief Searches for an element that contains given position.
@@ -4770,18 +5072,24 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_at(size_type position) const noexcept {
-        const_iterator it = find_element_before(position);
-        if (cend() != it) {
-            ++it;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            validate_pointer_invariants();
+            size_type const offset{ traits_traits::fixed_stride_offset_at(buff().begin, buff().last, position) };
+            return npos == offset ? end() : const_iterator{ buff().begin + offset };
+        } else {
+            const_iterator it = find_element_before(position);
             if (cend() != it) {
-                FFL_CODDING_ERROR_IF_NOT(contains(it, position));
-                return it;
+                ++it;
+                if (cend() != it) {
+                    FFL_CODDING_ERROR_IF_NOT(contains(it, position));
+                    return it;
+                }
             }
+            return end();
         }
-        return end();
     }
     //!
     //! @brief Searches for an element after the element that contains 
@@ -4791,7 +5099,7 @@ public:
     //! container's end iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     iterator find_element_after(size_type position) noexcept {
         iterator it = find_element_at(position);
@@ -4811,7 +5119,7 @@ public:
     //! container's end const iterator otherwise.
     //! @details Cost of this algorithm is O(number of elements in container)
     //! because we have to performs linear search for an element from the start
-    //! of container's buffer.
+    //! of container's buffer. For types with fixed stride cost is O(1).
     //!
     const_iterator find_element_after(size_type position) const noexcept {
         const_iterator it = find_element_at(position);
@@ -4828,15 +5136,20 @@ public:
     //! @returns Number of elements in the container.
     //! @details Cost of this algorithm is O(number of elements in container).
     //! Container does not actively cache/updates element count so we need to
-    //! scan list to find number of elements.
+    //! scan list to find number of elements. For types with fixed stride
+    //! cost is O(1).
     //!
     size_type size() const noexcept {
         validate_pointer_invariants();
-        size_type s = 0;
-        std::for_each(cbegin(), cend(), [&s](T const &) noexcept {
-            ++s;
-        });
-        return s;
+        if constexpr (traits_traits::has_fixed_stride_v) {
+            return traits_traits::fixed_stride_count(buff().begin, buff().last);
+        } else {
+            size_type s = 0;
+            std::for_each(cbegin(), cend(), [&s](T const &) noexcept {
+                ++s;
+            });
+            return s;
+        }
     }
     //!
     //! @brief Tells if container contains no elements.
@@ -6346,6 +6659,91 @@ constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list
                                                                 cast_to_char_ptr(end) });
 }
 //!
+//! @brief flat_forward_list_validate_fixed_stride
+//! @tparam T - element type
+//! @tparam TT - element type traits. Defaulted to 
+//! specialization flat_forward_list_traits<T>
+//! @tparam F - functor used to validate element
+//! by default uses default_validate_element_fn<T, TT>
+//! @details
+//! Validates if buffer contains a valid intrusive flat forward list
+//! See comment for flat_forward_list_validate.
+//! Users are not expected to use this function directly,
+//! instead prefer to use flat_forward_list_validate, which will call
+//! flat_forward_list_validate_fixed_stride if TT::fixed_size 
+//! is defined, and TT::get_next_offset is NOT defined.
+//! Returns same result as flat_forward_list_validate_no_next_offset,
+//! but since element N starts at N * stride, number of elements 
+//! is known before validation starts. Elements are validated in 
+//! blocks without a branch on each element, so compiler can
+//! vectorize the loop when validate_element_fn is inlined.
+//!
+template<typename T,
+         typename TT,
+         typename F>
+constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list_validate_fixed_stride(char const *first,
+                                                                                                       char const *end,
+                                                                                                       F const &validate_element_fn) noexcept {
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    static_assert(traits_traits::has_fixed_stride_v,
+                  "traits type must define fixed_size, and must not define get_next_offset");
+    //
+    // Number of elements we validate before checking result
+    //
+    constexpr size_t const block_size{ 64 };
+    constexpr size_t const stride{ traits_traits::element_stride() };
+    //
+    // null buffer is defined as valid
+    //
+    if (first == nullptr) {
+        FFL_CODDING_ERROR_IF_NOT(nullptr == end);
+        return std::make_pair(true, flat_forward_list_ref<T, TT>{});
+    }
+    //
+    // Can we safely subtract pointers?
+    //
+    FFL_CODDING_ERROR_IF(end < first);
+    //
+    // Traits that say that element is smaller than
+    // minimum size are incorrect
+    //
+    FFL_CODDING_ERROR_IF(stride < traits_traits::minimum_size());
+    //
+    // Element is examined if remaining buffer is not empty, 
+    // and can fit minimum size. That gives us number of elements.
+    //
+    size_t const length{ static_cast<size_t>(end - first) };
+    size_t const minimum_size{ traits_traits::minimum_size() > 0 ? traits_traits::minimum_size() : 1 };
+    size_t const element_count{ length < minimum_size ? 0 : (length - minimum_size) / stride + 1 };
+
+    size_t valid_count{ 0 };
+    while (valid_count < element_count) {
+        size_t const block_end{ std::min(valid_count + block_size, element_count) };
+        bool block_valid{ true };
+        for (size_t idx = valid_count; idx < block_end; ++idx) {
+            block_valid &= validate_element_fn(length - idx * stride,
+                                               *traits_traits::ptr_to_t(first + idx * stride));
+        }
+        if (!block_valid) {
+            //
+            // Find first element that failed validation
+            //
+            while (validate_element_fn(length - valid_count * stride,
+                                       *traits_traits::ptr_to_t(first + valid_count * stride))) {
+                ++valid_count;
+            }
+            break;
+        }
+        valid_count = block_end;
+    }
+
+    char const *last_valid{ 0 == valid_count ? nullptr : first + (valid_count - 1) * stride };
+    return std::make_pair(valid_count == element_count, 
+                          flat_forward_list_ref<T, TT>{ cast_to_char_ptr(first),
+                                                        cast_to_char_ptr(last_valid),
+                                                        cast_to_char_ptr(end) });
+}
+//!
 //! @brief Validates that buffer contains valid flat forward list
 //! and returns a pointer to the last element.
 //!
@@ -6401,6 +6799,9 @@ constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list
 //!       when next element offset is 0
 //!     - flat_forward_list_validate_no_next_offset stops
 //!       when buffer cannot fit next element
+//!     - flat_forward_list_validate_fixed_stride is used instead of
+//!       flat_forward_list_validate_no_next_offset when TT defines
+//!       fixed_size. It finds number of elements from buffer size.
 //!
 template<typename T,
          typename TT,
@@ -6418,6 +6819,8 @@ constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list
     //
     if constexpr (type_has_next_offset) {
         return flat_forward_list_validate_has_next_offset<T, TT, F>(first, end, validate_element_fn);
+    } else if constexpr (traits_traits::has_fixed_stride_v) {
+        return flat_forward_list_validate_fixed_stride<T, TT, F>(first, end, validate_element_fn);
     } else {
         return flat_forward_list_validate_no_next_offset<T, TT, F>(first, end, validate_element_fn);
     }
@@ -6439,6 +6842,8 @@ constexpr inline std::pair<bool, flat_forward_list_ref<T, TT>> flat_forward_list
     //
     if constexpr (type_has_next_offset) {
         return flat_forward_list_validate_has_next_offset<T, TT, F>(first, end, validate_element_fn);
+    } else if constexpr (traits_traits::has_fixed_stride_v) {
+        return flat_forward_list_validate_fixed_stride<T, TT, F>(first, end, validate_element_fn);
     } else {
         return flat_forward_list_validate_no_next_offset<T, TT, F>(first, end, validate_element_fn);
     }
@@ -0,0 +1,396 @@
+#pragma once
+
+//!
+//! @file iffl_mapped_file.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements mapped_file_memory_resource, a memory resource
+//!        that places flat forward list buffer in a shared file mapping.
+//!        This header depends on POSIX headers, and is not included by iffl.h.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//!
+//! @brief Defined when platform supports mapped_file_memory_resource
+//!
+#define FFL_HAS_MAPPED_FILE 1
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @class mapped_file_memory_resource
+//! @brief implements std::pmr::memory_resource interface on top
+//! of a shared file mapping.
+//! @details This class can be used with Polymorphic Memory Allocator.
+//! Forward Linked List has typedef for PMR called pmr_flat_forward_list.
+//! All container methods, including methods that reallocate buffer,
+//! work on top of this memory resource, and every change container makes
+//! to the elements lands directly in the file pages.
+//!
+//! Memory resource does not own file descriptor. Caller must keep it
+//! open until all memory allocated from this resource is deallocated.
+//! File size always tracks size of the buffer that container owns.
+//!
+//! Container reallocates buffer by allocating a new buffer, copying
+//! data and only then deallocating old buffer, so it needs two distinct
+//! buffers for a short period of time. While file is mapped, next
+//! allocation returns an anonymous staging buffer. When container
+//! deallocates old file mapping we resize file to the size of the
+//! staging buffer, write staging buffer to the file, and map the
+//! file over the staging buffer address. Container pointers remain valid,
+//! and buffer is backed by the file again.
+//! Appending to the list that has unused capacity does not cause any
+//! reallocations, so reserve capacity using resize_buffer to reduce number
+//! of times we rewrite the file.
+//!
+//! Releasing buffer, for instance in container destructor, unmaps the file
+//! but does not change file content. Use flush to make sure data reached disk.
+//! To open list persisted in the file allocate buffer of file_size() bytes,
+//! and attach it to the container.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::mapped_file_memory_resource file_resource{ fd };
+//! size_t const file_size{ file_resource.file_size() };
+//! iffl::pmr_flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl{ &file_resource };
+//! if (file_size) {
+//!     ffl.attach(static_cast<char *>(file_resource.allocate(file_size)), file_size);
+//! }
+//! ffl.push_back(<data_size>, <data>);
+//! file_resource.flush(ffl.data(), ffl.used_capacity());
+//! @endcode
+//!
+//! For element types that do not have next element offset validation
+//! cannot tell where list ends, so call shrink_to_fit before releasing
+//! buffer to trim unused capacity from the file.
+//!
+//! Thread safety:
+//!
+//! This class is not thread safe. It is expected that only one container
+//! allocates from it.
+//!
+class mapped_file_memory_resource
+    : public FFL_PMR::memory_resource {
+
+public:
+    //!
+    //! @brief Constructs memory resource that will allocate
+    //! buffer in the file.
+    //! @param fd - file descriptor opened for read and write.
+    //!
+    explicit mapped_file_memory_resource(int fd) noexcept
+        : fd_{ fd } {
+    }
+
+    mapped_file_memory_resource(mapped_file_memory_resource const &) = delete;
+    mapped_file_memory_resource &operator=(mapped_file_memory_resource const &) = delete;
+
+    //!
+    //! @brief Destructor verifies that there are no outstanding allocations
+    //!
+    ~mapped_file_memory_resource() noexcept {
+        validate_no_busy_blocks();
+    }
+
+    //!
+    //! @brief Can be used to query number of outstanding allocations
+    //! @return number of outstanding allocations
+    //!
+    size_t get_busy_blocks_count() const noexcept {
+        return (mapping_ ? 1 : 0) + (staging_ ? 1 : 0);
+    }
+
+    //!
+    //! @brief Triggers fail fast if there are outstanding allocations
+    //!
+    void validate_no_busy_blocks() const noexcept {
+        FFL_CODDING_ERROR_IF(0 < get_busy_blocks_count());
+    }
+
+    //!
+    //! @brief Queries current file size.
+    //! @return size of the file, or 0 if query failed.
+    //!
+    size_t file_size() const noexcept {
+        struct stat st {};
+        if (0 != fstat(fd_, &st)) {
+            return 0;
+        }
+        return static_cast<size_t>(st.st_size);
+    }
+
+    //!
+    //! @brief Tells if buffer we gave to the container is backed by the file.
+    //! @return false if we failed to move staging buffer to the file.
+    //! Container still owns a valid buffer, but changes would not reach the file.
+    //! Use get_last_error to find why remapping failed.
+    //!
+    bool is_file_backed() const noexcept {
+        return mapping_ && file_backed_;
+    }
+
+    //!
+    //! @brief Returns error code of the last failed attempt to
+    //! move staging buffer to the file.
+    //! @return errno value or 0 if there were no failures.
+    //!
+    int get_last_error() const noexcept {
+        return last_error_;
+    }
+
+    //!
+    //! @brief Writes dirty pages of the range to the file.
+    //! @param ptr - pointer to the beginning of the range. Must
+    //!              point inside of the mapped buffer.
+    //! @param size - size of the range.
+    //! @param wait - when true waits for write to complete.
+    //!               When false schedules write and returns.
+    //! @return 0 on success, and errno value on failure.
+    //! @details Range is extended to the page boundaries.
+    //!
+    [[nodiscard]] int flush(void const *ptr, size_t size, bool wait = true) const noexcept {
+        if (!is_file_backed()) {
+            return last_error_ ? last_error_ : EBADF;
+        }
+        char const *first{ static_cast<char const *>(ptr) };
+        FFL_CODDING_ERROR_IF(first < mapping_ ||
+                             mapping_ + mapping_size_ < first + size);
+        if (0 == size) {
+            return 0;
+        }
+        size_t const first_offset{ static_cast<size_t>(first - mapping_) };
+        size_t const page_offset{ first_offset - first_offset % page_size() };
+        if (0 != msync(mapping_ + page_offset,
+                       first_offset + size - page_offset,
+                       wait ? MS_SYNC : MS_ASYNC)) {
+            return errno;
+        }
+        return 0;
+    }
+
+    //!
+    //! @brief Writes all dirty pages of the mapped buffer to the file.
+    //! @param wait - when true waits for write to complete.
+    //!               When false schedules write and returns.
+    //! @return 0 on success, and errno value on failure.
+    //!
+    [[nodiscard]] int flush(bool wait = true) const noexcept {
+        if (nullptr == mapping_) {
+            return 0;
+        }
+        return flush(mapping_, mapping_size_, wait);
+    }
+
+protected:
+
+    //!
+    //! @brief Overrides memory resource virtual method that performs allocation.
+    //! @param bytes - number of bytes to be allocated.
+    //! @param alignment - alignment requirements for the allocated buffer.
+    //! @throws std::bad_alloc if allocation fails
+    //! @return On success return a pointer to the buffer of requested size.
+    //!         First allocation returns file mapping. If file is already mapped,
+    //!         then returns staging buffer that will be moved to the file when
+    //!         file mapping is deallocated.
+    //!         On failure throws std::bad_alloc.
+    //!
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (0 == bytes || alignment > page_size()) {
+            throw std::bad_alloc{};
+        }
+
+        if (nullptr == mapping_) {
+            if (file_size() != bytes &&
+                0 != ftruncate(fd_, static_cast<off_t>(bytes))) {
+                throw std::bad_alloc{};
+            }
+            void *ptr{ mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0) };
+            if (MAP_FAILED == ptr) {
+                throw std::bad_alloc{};
+            }
+            mapping_ = static_cast<char *>(ptr);
+            mapping_size_ = bytes;
+            file_backed_ = true;
+            return ptr;
+        } else if (nullptr == staging_) {
+            void *ptr{ mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+            if (MAP_FAILED == ptr) {
+                throw std::bad_alloc{};
+            }
+            staging_ = static_cast<char *>(ptr);
+            staging_size_ = bytes;
+            return ptr;
+        }
+
+        throw std::bad_alloc{};
+    }
+    //!
+    //! @brief Overrides memory resource virtual method that performs deallocation.
+    //! @param p - pointer to the user buffer that is deallocated.
+    //! @param bytes - buffer size. Mast match to the size that was allocated.
+    //! @param alignment - alignment of the buffer.
+    //! @details If container deallocates staging buffer then it failed to
+    //! commit it, and we simply unmap staging buffer. If container deallocates
+    //! file mapping while we have a staging buffer then container moved
+    //! data to the staging buffer, and we move staging buffer to the file.
+    //! Triggers fail fast if buffer does not match to what we have allocated.
+    //!
+    void do_deallocate(void* p, size_t bytes, [[maybe_unused]] size_t alignment) noexcept override {
+        if (nullptr != staging_ && p == staging_) {
+            FFL_CODDING_ERROR_IF_NOT(bytes == staging_size_);
+            unmap(staging_, staging_size_);
+            staging_ = nullptr;
+            staging_size_ = 0;
+        } else {
+            FFL_CODDING_ERROR_IF_NOT(nullptr != mapping_ && p == mapping_ && bytes == mapping_size_);
+            unmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            file_backed_ = false;
+            if (staging_) {
+                commit_staging_buffer();
+            }
+        }
+    }
+
+    //!
+    //! @brief Validates that two memory resources are equivalent.
+    //!        For this class they must be equal.
+    //! @param other - reference to the other memory resource.
+    //! @return true if other memory resource is the same object,
+    //!         and false otherwise.
+    //!
+    bool do_is_equal(memory_resource const & other) const noexcept override {
+        return (&other == this);
+    }
+
+private:
+
+    //!
+    //! @brief Returns size of a memory page.
+    //!
+    static size_t page_size() noexcept {
+        static size_t const size{ static_cast<size_t>(sysconf(_SC_PAGESIZE)) };
+        return size;
+    }
+
+    //!
+    //! @brief Unmaps buffer. Failure to unmap buffer we've mapped
+    //! is a codding error.
+    //! @param buffer - pointer to the buffer.
+    //! @param buffer_size - size of the buffer.
+    //!
+    static void unmap(char *buffer, size_t buffer_size) noexcept {
+        FFL_CODDING_ERROR_IF(0 != munmap(buffer, buffer_size));
+    }
+
+    //!
+    //! @brief Writes buffer to the beginning of the file.
+    //! @param buffer - pointer to the buffer.
+    //! @param buffer_size - size of the buffer.
+    //! @return 0 on success, and errno value on failure.
+    //!
+    int write_to_file(char const *buffer, size_t buffer_size) const noexcept {
+        size_t written{ 0 };
+        while (written < buffer_size) {
+            ssize_t const result{ pwrite(fd_,
+                                         buffer + written,
+                                         buffer_size - written,
+                                         static_cast<off_t>(written)) };
+            if (result < 0) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                return errno;
+            }
+            written += static_cast<size_t>(result);
+        }
+        return 0;
+    }
+
+    //!
+    //! @brief Staging buffer becomes container buffer. Resize file
+    //! to the size of the staging buffer, copy staging buffer to the
+    //! file, and map file at the staging buffer address.
+    //! @details On failure staging buffer remains container buffer,
+    //! but it is not backed by the file. Error is saved in last_error_.
+    //!
+    void commit_staging_buffer() noexcept {
+        mapping_ = staging_;
+        mapping_size_ = staging_size_;
+        file_backed_ = false;
+        staging_ = nullptr;
+        staging_size_ = 0;
+
+        if (0 != ftruncate(fd_, static_cast<off_t>(mapping_size_))) {
+            last_error_ = errno;
+            return;
+        }
+
+        int const error{ write_to_file(mapping_, mapping_size_) };
+        if (0 != error) {
+            last_error_ = error;
+            return;
+        }
+        //
+        // MAP_FIXED atomically replaces anonymous pages of the staging
+        // buffer with the file pages, which now contain same data
+        //
+        void *ptr{ mmap(mapping_, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0) };
+        if (MAP_FAILED == ptr) {
+            last_error_ = errno;
+            return;
+        }
+        FFL_CODDING_ERROR_IF_NOT(ptr == mapping_);
+        file_backed_ = true;
+    }
+
+    //!
+    //! @brief File descriptor of the file backing the buffer.
+    //!
+    int fd_{ -1 };
+    //!
+    //! @brief Buffer owned by container.
+    //!
+    char *mapping_{ nullptr };
+    //!
+    //! @brief Size of the buffer owned by container.
+    //!
+    size_t mapping_size_{ 0 };
+    //!
+    //! @brief true when buffer owned by container is mapped to the file.
+    //!
+    bool file_backed_{ false };
+    //!
+    //! @brief New buffer container is moving data to.
+    //!
+    char *staging_{ nullptr };
+    //!
+    //! @brief Size of the new buffer.
+    //!
+    size_t staging_size_{ 0 };
+    //!
+    //! @brief errno value of the last failure to move buffer to the file.
+    //!
+    int last_error_{ 0 };
+};
+
+} // namespace iffl
+
+#endif
@@ -0,0 +1,276 @@
+#pragma once
+
+//!
+//! @file iffl_nested_list.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements flat_forward_list_nested_field that
+//!        describes a list nested in an element of another list.
+//!
+//! @details Element can contain offset and length of a buffer with
+//!          another list, for instance a directory entry can contain
+//!          a list of extended attributes. Traits of the element declare
+//!          these lists in nested_lists tuple:
+//!
+//! @code
+//! namespace iffl {
+//!     template <>
+//!     struct flat_forward_list_traits<dir_entry> {
+//!         using nested_lists = std::tuple<flat_forward_list_nested_field<&dir_entry::ea_offset,
+//!                                                                        &dir_entry::ea_length,
+//!                                                                        FILE_FULL_EA_INFORMATION>>;
+//!         ...
+//!     };
+//! }
+//! @endcode
+//!
+//!          Validation of the element also validates nested lists,
+//!          so flat_forward_list_validate checks all levels in a single
+//!          traversal. Lists nested in elements of a nested list are
+//!          validated the same way.
+//!          Once outer list is validated, nested_view and nested_ref return
+//!          view and reference of a nested list without validating it again.
+//!
+//!          Element type can contain lists of its own type, for instance
+//!          a directory entry can contain directory entries. Nested list
+//!          must start after the header of the element, so each nested
+//!          list is smaller than the element that contains it, and
+//!          validation does not go deeper than
+//!          flat_forward_list_max_nesting_depth levels.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Maximum number of lists nested in each other that
+//! validation accepts.
+//! @details Input might come from an untrusted source, and
+//! validation of nested lists is recursive. Limit keeps
+//! stack use bounded.
+//!
+constexpr size_t const flat_forward_list_max_nesting_depth{ 32 };
+
+//!
+//! @class flat_forward_list_nesting_depth_guard
+//! @brief Counts nested lists that calling thread is validating.
+//!
+class flat_forward_list_nesting_depth_guard {
+public:
+    //!
+    //! @brief Constructor. Enters next nesting level.
+    //!
+    flat_forward_list_nesting_depth_guard() noexcept {
+        ++depth_;
+    }
+    //!
+    //! @brief Destructor. Leaves nesting level.
+    //!
+    ~flat_forward_list_nesting_depth_guard() noexcept {
+        --depth_;
+    }
+    //!
+    //! @brief Guard is not copyable
+    //!
+    flat_forward_list_nesting_depth_guard(flat_forward_list_nesting_depth_guard const &) = delete;
+    //!
+    //! @brief Guard is not copyable
+    //!
+    flat_forward_list_nesting_depth_guard &operator= (flat_forward_list_nesting_depth_guard const &) = delete;
+    //!
+    //! @returns true if calling thread is deeper than
+    //! flat_forward_list_max_nesting_depth.
+    //!
+    bool is_too_deep() const noexcept {
+        return depth_ > flat_forward_list_max_nesting_depth;
+    }
+
+private:
+    //!
+    //! @brief Number of nested lists calling thread is validating
+    //!
+    inline static thread_local size_t depth_{ 0 };
+};
+
+//!
+//! @struct flat_forward_list_nested_field
+//! @brief Describes a list nested in an element.
+//! @tparam OFFSET - pointer to the member that contains offset of
+//! the nested list from the start of the element.
+//! @tparam LENGTH - pointer to the member that contains size
+//! of the nested list in bytes. 0 means list is empty.
+//! @tparam C - type of elements of the nested list
+//! @tparam CT - traits of elements of the nested list
+//! @details Nested list must be inside of the element, as
+//! reported by traits get_size, and must start after the first
+//! minimum_size bytes of the element.
+//!
+template <auto OFFSET,
+          auto LENGTH,
+          typename C,
+          typename CT = flat_forward_list_traits<C>>
+struct flat_forward_list_nested_field {
+    //!
+    //! @typedef value_type
+    //! @brief Type of elements of the nested list
+    //!
+    using value_type = C;
+    //!
+    //! @typedef traits
+    //! @brief Traits of elements of the nested list
+    //!
+    using traits = CT;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that reads traits of the nested list
+    //!
+    using traits_traits = flat_forward_list_traits_traits<C, CT>;
+    //!
+    //! @param e - element that contains nested list
+    //! @returns offset of the nested list from the start of the element
+    //!
+    template <typename T>
+    constexpr static size_t get_offset(T const &e) noexcept {
+        return static_cast<size_t>(e.*OFFSET);
+    }
+    //!
+    //! @param e - element that contains nested list
+    //! @returns size of the nested list in bytes
+    //!
+    template <typename T>
+    constexpr static size_t get_length(T const &e) noexcept {
+        return static_cast<size_t>(e.*LENGTH);
+    }
+    //!
+    //! @brief Validates nested list.
+    //! @param element_size - size of the element that contains
+    //! nested list.
+    //! @param e - element that contains nested list
+    //! @returns true if nested list is inside of the element after
+    //! element header, it is a valid list, and it does not go deeper
+    //! than flat_forward_list_max_nesting_depth.
+    //! @details Nested list that starts after the header is smaller
+    //! than the element, so a list that contains elements of the same
+    //! type cannot describe itself.
+    //!
+    template <typename T>
+    static bool validate(size_t element_size, T const &e) noexcept {
+        size_t const offset{ get_offset(e) };
+        size_t const length{ get_length(e) };
+        if (0 == length) {
+            return true;
+        }
+        if (offset < flat_forward_list_traits_traits<T>::minimum_size() ||
+            offset > element_size ||
+            length > element_size - offset) {
+            return false;
+        }
+        flat_forward_list_nesting_depth_guard const depth_guard;
+        if (depth_guard.is_too_deep()) {
+            return false;
+        }
+        char const *const begin{ reinterpret_cast<char const *>(&e) + offset };
+        return flat_forward_list_validate<C, CT>(begin, begin + length).first;
+    }
+    //!
+    //! @brief Creates view of the nested list without validating it.
+    //! @param e - element of a validated list
+    //! @returns view of the nested list
+    //!
+    template <typename T>
+    static flat_forward_list_view<C, CT> view(T const &e) noexcept {
+        char const *const begin{ reinterpret_cast<char const *>(&e) + get_offset(e) };
+        char const *const end{ begin + get_length(e) };
+        return flat_forward_list_view<C, CT>{ begin, find_last(begin, end), end };
+    }
+    //!
+    //! @brief Creates reference to the nested list without validating it.
+    //! @param e - element of a validated list
+    //! @returns reference to the nested list
+    //!
+    template <typename T>
+    static flat_forward_list_ref<C, CT> ref(T &e) noexcept {
+        char *const begin{ reinterpret_cast<char *>(&e) + get_offset(e) };
+        char *const end{ begin + get_length(e) };
+        return flat_forward_list_ref<C, CT>{ begin, const_cast<char *>(find_last(begin, end)), end };
+    }
+
+private:
+    //!
+    //! @brief Walks a valid list to find the last element
+    //! @param begin - start of the nested list
+    //! @param end - end of the nested list
+    //! @returns pointer to the last element, or nullptr if list is empty
+    //!
+    static char const *find_last(char const *begin, char const *end) noexcept {
+        if (begin == end) {
+            return nullptr;
+        }
+        char const *last{ begin };
+        for (;;) {
+            size_t const next_offset{ traits_traits::get_next_offset(last) };
+            if constexpr (traits_traits::has_next_offset_v) {
+                if (0 == next_offset) {
+                    break;
+                }
+            } else {
+                //
+                // Last element is not padded, and elements of a
+                // valid list cover buffer up to the last element.
+                //
+                if (static_cast<size_t>(end - last) < next_offset + traits_traits::minimum_size()) {
+                    break;
+                }
+            }
+            last += next_offset;
+        }
+        return last;
+    }
+};
+
+//!
+//! @brief Creates view of a list nested in the element that iterator
+//! points to. Does not validate nested list.
+//! @tparam I - index of the nested list in traits nested_lists
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @param it - iterator that points to an element of a validated list
+//! @returns view of the nested list
+//!
+template <size_t I,
+          typename T,
+          typename TT>
+inline auto nested_view(flat_forward_list_iterator_t<T, TT> const &it) noexcept {
+    using nested_field = std::tuple_element_t<I, typename TT::nested_lists>;
+    return nested_field::view(*it);
+}
+
+//!
+//! @brief Creates reference to a list nested in the element that iterator
+//! points to. Does not validate nested list.
+//! @tparam I - index of the nested list in traits nested_lists
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @param it - iterator that points to an element of a validated list
+//! @returns reference to the nested list
+//!
+template <size_t I,
+          typename T,
+          typename TT>
+inline auto nested_ref(flat_forward_list_iterator_t<T, TT> const &it) noexcept {
+    static_assert(!std::is_const_v<T>, "use nested_view for const iterators");
+    using nested_field = std::tuple_element_t<I, typename TT::nested_lists>;
+    return nested_field::ref(*it);
+}
+
+} // namespace iffl
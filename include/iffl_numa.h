@@ -0,0 +1,723 @@
+#pragma once
+
+//!
+//! @file iffl_numa.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements a memory resource that places pages
+//!        on chosen NUMA nodes, and parallel algorithms that process
+//!        chunks of a list on threads running on the node that owns
+//!        chunk's pages.
+//!        This header depends on Linux headers, and is not included by iffl.h.
+//!
+//! @details Memory policy is applied with mbind and queried with
+//!          get_mempolicy system calls, so there is no dependency on libnuma.
+//!          Topology is read from /sys/devices/system/node. Tests can
+//!          emulate several nodes on a single node machine by constructing
+//!          numa_topology with a list of CPUs for each node, and a functor
+//!          that maps address to a node.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+#include <iffl_parallel.h>
+
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>) && __has_include(<sys/syscall.h>) && __has_include(<sys/mman.h>)
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//!
+//! @brief Defined when platform supports NUMA helpers
+//!
+#define FFL_HAS_NUMA 1
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Maximum number of NUMA nodes supported by
+//! numa_memory_resource. Node mask is a single unsigned long.
+//!
+constexpr inline size_t const numa_max_nodes{ sizeof(unsigned long) * CHAR_BIT };
+
+//!
+//! @brief Parses list of CPUs or nodes in the format used by sysfs,
+//! for instance "0-3,8,10-11".
+//! @param list - zero terminated string.
+//! @returns vector of numbers in the list.
+//! @throw std::bad_alloc if allocating vector fails.
+//!
+inline std::vector<int> numa_parse_list(char const *list) {
+    std::vector<int> result;
+    char const *cur{ list };
+    while (*cur) {
+        char *next{ nullptr };
+        long const first{ std::strtol(cur, &next, 10) };
+        if (next == cur) {
+            break;
+        }
+        long last{ first };
+        cur = next;
+        if ('-' == *cur) {
+            last = std::strtol(cur + 1, &next, 10);
+            cur = next;
+        }
+        for (long idx = first; idx <= last; ++idx) {
+            result.push_back(static_cast<int>(idx));
+        }
+        if (',' != *cur) {
+            break;
+        }
+        ++cur;
+    }
+    return result;
+}
+
+//!
+//! @brief Returns NUMA node that owns page at the address.
+//! @param ptr - address.
+//! @returns node id, or -1 if query failed.
+//! @details If page is not present yet, kernel allocates it.
+//!
+inline int numa_page_node(void const *ptr) noexcept {
+    int node{ -1 };
+    if (0 != syscall(SYS_get_mempolicy,
+                     &node,
+                     nullptr,
+                     0,
+                     const_cast<void *>(ptr),
+                     MPOL_F_NODE | MPOL_F_ADDR)) {
+        return -1;
+    }
+    return node;
+}
+
+//!
+//! @class numa_topology
+//! @brief Describes NUMA nodes and CPUs that belong to them.
+//! @details Nodes are identified by index in the range [0, node_count()).
+//! node_id converts index to the node id used by the operating system.
+//! Default constructor reads topology of the machine. If it cannot be read,
+//! then topology has a single node with no CPUs, and threads are not bound.
+//!
+class numa_topology {
+public:
+    //!
+    //! @typedef locate_fn
+    //! @brief Type of functor that maps address to a node index
+    //!
+    using locate_fn = std::function<size_t(void const *)>;
+
+    //!
+    //! @brief Reads topology of this machine from sysfs.
+    //! @throw std::bad_alloc if allocating vectors fails.
+    //!
+    numa_topology() {
+        std::vector<int> node_ids;
+        if (FILE *file = std::fopen("/sys/devices/system/node/online", "r")) {
+            char buffer[256]{};
+            if (std::fgets(buffer, sizeof(buffer), file)) {
+                node_ids = numa_parse_list(buffer);
+            }
+            std::fclose(file);
+        }
+        for (int node_id : node_ids) {
+            char path[128];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node_id);
+            std::vector<int> cpus;
+            if (FILE *file = std::fopen(path, "r")) {
+                char buffer[1024]{};
+                if (std::fgets(buffer, sizeof(buffer), file)) {
+                    cpus = numa_parse_list(buffer);
+                }
+                std::fclose(file);
+            }
+            node_ids_.push_back(node_id);
+            node_cpus_.push_back(std::move(cpus));
+        }
+        if (node_ids_.empty()) {
+            node_ids_.push_back(0);
+            node_cpus_.emplace_back();
+        }
+    }
+    //!
+    //! @brief Constructs emulated topology.
+    //! @param node_cpus - CPUs of each node. CPUs can belong to
+    //! several nodes.
+    //! @param locate - functor that returns index of the node that
+    //! owns an address. Result is wrapped to the number of nodes.
+    //! @throw std::bad_alloc if allocating vectors fails.
+    //!
+    numa_topology(std::vector<std::vector<int>> node_cpus,
+                  locate_fn locate)
+        : node_cpus_{ std::move(node_cpus) }
+        , locate_{ std::move(locate) } {
+        FFL_CODDING_ERROR_IF(node_cpus_.empty());
+        for (size_t idx = 0; idx < node_cpus_.size(); ++idx) {
+            node_ids_.push_back(static_cast<int>(idx));
+        }
+    }
+    //!
+    //! @returns topology of this machine. It is read once.
+    //!
+    static numa_topology const &system() {
+        static numa_topology const topology;
+        return topology;
+    }
+    //!
+    //! @returns number of nodes.
+    //!
+    size_t node_count() const noexcept {
+        return node_ids_.size();
+    }
+    //!
+    //! @param node - node index.
+    //! @returns node id used by the operating system.
+    //!
+    int node_id(size_t node) const noexcept {
+        FFL_CODDING_ERROR_IF_NOT(node < node_count());
+        return node_ids_[node];
+    }
+    //!
+    //! @param node - node index.
+    //! @returns CPUs of the node.
+    //!
+    std::vector<int> const &node_cpus(size_t node) const noexcept {
+        FFL_CODDING_ERROR_IF_NOT(node < node_count());
+        return node_cpus_[node];
+    }
+    //!
+    //! @param ptr - address.
+    //! @returns index of the node that owns page at the address,
+    //! or 0 if it is not known.
+    //!
+    size_t node_of(void const *ptr) const noexcept {
+        if (locate_) {
+            return locate_(ptr) % node_count();
+        }
+        return node_index(numa_page_node(ptr));
+    }
+    //!
+    //! @returns index of the node calling thread is running on,
+    //! or 0 if it is not known.
+    //!
+    size_t current_node() const noexcept {
+        int const cpu{ sched_getcpu() };
+        for (size_t node = 0; node < node_count(); ++node) {
+            for (int node_cpu : node_cpus_[node]) {
+                if (node_cpu == cpu) {
+                    return node;
+                }
+            }
+        }
+        return 0;
+    }
+    //!
+    //! @brief Restricts calling thread to CPUs of a node.
+    //! @param node - node index.
+    //! @returns 0 on success, and errno value on failure.
+    //! Node without CPUs leaves thread affinity unchanged.
+    //!
+    [[nodiscard]] int bind_current_thread(size_t node) const noexcept {
+        std::vector<int> const &cpus{ node_cpus(node) };
+        if (cpus.empty()) {
+            return 0;
+        }
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : cpus) {
+            if (0 <= cpu && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    }
+
+private:
+    //!
+    //! @param node_id - node id used by the operating system.
+    //! @returns index of the node, or 0 if it is not known.
+    //!
+    size_t node_index(int node_id) const noexcept {
+        for (size_t node = 0; node < node_count(); ++node) {
+            if (node_ids_[node] == node_id) {
+                return node;
+            }
+        }
+        return 0;
+    }
+    //!
+    //! @brief Node ids used by the operating system.
+    //!
+    std::vector<int> node_ids_;
+    //!
+    //! @brief CPUs of each node.
+    //!
+    std::vector<std::vector<int>> node_cpus_;
+    //!
+    //! @brief Optional functor that maps address to a node.
+    //! Used to emulate topology.
+    //!
+    locate_fn locate_;
+};
+
+//!
+//! @enum numa_policy
+//! @brief Policy that numa_memory_resource applies to allocated pages.
+//!
+enum class numa_policy : int {
+    //!
+    //! @brief Pages are allocated only on the given nodes.
+    //!
+    bind = MPOL_BIND,
+    //!
+    //! @brief Pages are interleaved between the given nodes.
+    //!
+    interleave = MPOL_INTERLEAVE,
+    //!
+    //! @brief Pages are allocated on the first given node if it has
+    //! free memory, and on other nodes otherwise. Kernel prefers the
+    //! lowest node in the mask, so only the first given node is
+    //! added to the mask.
+    //!
+    preferred = MPOL_PREFERRED,
+};
+
+//!
+//! @class numa_memory_resource
+//! @brief implements std::pmr::memory_resource interface that
+//! maps pages, and applies NUMA memory policy to them.
+//! @details Each allocation is an anonymous mapping rounded up to
+//! the page size, so use this memory resource for large buffers,
+//! for instance buffer of a large list, or as the upstream of a
+//! pool resource. Policy is applied before pages are touched, so
+//! pages are allocated on the right nodes when first written.
+//!
+//! Sample usage:
+//!
+//! @code
+//! iffl::numa_memory_resource interleaved{ iffl::numa_policy::interleave, { 0, 1 } };
+//! iffl::pmr_flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl{ &interleaved };
+//! @endcode
+//!
+//! Thread safety:
+//!
+//! Memory resource can be used from multiple threads.
+//!
+class numa_memory_resource
+    : public FFL_PMR::memory_resource {
+
+public:
+    //!
+    //! @brief Constructs memory resource.
+    //! @param policy - policy applied to the pages.
+    //! @param node_ids - ids of nodes used by the operating system,
+    //! for instance numa_topology::node_id. Must not be empty.
+    //! numa_policy::preferred uses only the first node.
+    //!
+    numa_memory_resource(numa_policy policy,
+                         std::vector<int> const &node_ids) noexcept
+        : policy_{ policy } {
+        FFL_CODDING_ERROR_IF(node_ids.empty());
+        for (int node_id : node_ids) {
+            FFL_CODDING_ERROR_IF(node_id < 0 || numa_max_nodes <= static_cast<size_t>(node_id));
+            node_mask_ |= 1UL << node_id;
+            if (numa_policy::preferred == policy) {
+                break;
+            }
+        }
+    }
+
+    numa_memory_resource(numa_memory_resource const &) = delete;
+    numa_memory_resource &operator=(numa_memory_resource const &) = delete;
+
+    //!
+    //! @brief Destructor verifies that there are no outstanding allocations
+    //!
+    ~numa_memory_resource() noexcept {
+        validate_no_busy_blocks();
+    }
+
+    //!
+    //! @brief Can be used to query number of outstanding allocations
+    //! @return number of outstanding allocations
+    //!
+    size_t get_busy_blocks_count() const noexcept {
+        return busy_blocks_count_.load(std::memory_order_relaxed);
+    }
+
+    //!
+    //! @brief Triggers fail fast if there are outstanding allocations
+    //!
+    void validate_no_busy_blocks() const noexcept {
+        FFL_CODDING_ERROR_IF(0 < get_busy_blocks_count());
+    }
+
+    //!
+    //! @brief Returns error code of the last failed allocation.
+    //! @return errno value or 0 if there were no failures.
+    //!
+    int get_last_error() const noexcept {
+        return last_error_.load(std::memory_order_relaxed);
+    }
+
+protected:
+
+    //!
+    //! @brief Overrides memory resource virtual method that performs allocation.
+    //! @param bytes - number of bytes to be allocated.
+    //! @param alignment - alignment requirements for the allocated buffer.
+    //! @throws std::bad_alloc if mapping pages or applying policy fails.
+    //! Use get_last_error to find the reason.
+    //! @return pointer to the buffer aligned on the page boundary.
+    //!
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (0 == bytes || alignment > page_size()) {
+            throw std::bad_alloc{};
+        }
+        size_t const mapping_size{ roundup_size_to_alignment(bytes, page_size()) };
+        void *ptr{ mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+        if (MAP_FAILED == ptr) {
+            last_error_ = errno;
+            throw std::bad_alloc{};
+        }
+        //
+        // Kernel decrements maxnode before using it
+        //
+        if (0 != syscall(SYS_mbind,
+                         ptr,
+                         mapping_size,
+                         static_cast<int>(policy_),
+                         &node_mask_,
+                         numa_max_nodes + 1,
+                         0)) {
+            last_error_ = errno;
+            FFL_CODDING_ERROR_IF(0 != munmap(ptr, mapping_size));
+            throw std::bad_alloc{};
+        }
+        ++busy_blocks_count_;
+        return ptr;
+    }
+    //!
+    //! @brief Overrides memory resource virtual method that performs deallocation.
+    //! @param p - pointer to the user buffer that is deallocated.
+    //! @param bytes - buffer size. Mast match to the size that was allocated.
+    //! @param alignment - alignment of the buffer.
+    //!
+    void do_deallocate(void* p, size_t bytes, [[maybe_unused]] size_t alignment) noexcept override {
+        FFL_CODDING_ERROR_IF(0 != munmap(p, roundup_size_to_alignment(bytes, page_size())));
+        FFL_CODDING_ERROR_IF(0 == busy_blocks_count_.fetch_sub(1));
+    }
+
+    //!
+    //! @brief Validates that two memory resources are equivalent.
+    //!        For this class they must be equal.
+    //! @param other - reference to the other memory resource.
+    //! @return true if other memory resource is the same object,
+    //!         and false otherwise.
+    //!
+    bool do_is_equal(memory_resource const & other) const noexcept override {
+        return (&other == this);
+    }
+
+private:
+
+    //!
+    //! @brief Returns size of a memory page.
+    //!
+    static size_t page_size() noexcept {
+        static size_t const size{ static_cast<size_t>(sysconf(_SC_PAGESIZE)) };
+        return size;
+    }
+
+    //!
+    //! @brief Policy applied to the pages.
+    //!
+    numa_policy policy_{ numa_policy::bind };
+    //!
+    //! @brief Mask of node ids.
+    //!
+    unsigned long node_mask_{ 0 };
+    //!
+    //! @brief Number of outstanding allocations.
+    //!
+    std::atomic<size_t> busy_blocks_count_{ 0 };
+    //!
+    //! @brief errno value of the last failed allocation.
+    //!
+    std::atomic<int> last_error_{ 0 };
+};
+
+//!
+//! @brief Calls functor for each chunk on threads running on the node
+//! that owns the chunk.
+//! @tparam F - type of the functor.
+//! @param chunk_nodes - index of the node that owns each chunk.
+//! @param topology - NUMA topology.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @param fn - functor that is called with a chunk index.
+//! @throw std::bad_alloc, std::system_error if starting a thread fails.
+//!        First exception raised by the functor. Remaining chunks
+//!        are not started after functor raised.
+//! @details Each node has its own queue of chunks. Worker threads are
+//! spread between nodes that own chunks, and bound to CPUs of their
+//! node. Calling thread is not bound, and works on the node it is
+//! running on. Worker that drained its node queue takes chunks from
+//! queues of other nodes.
+//!
+template <typename F>
+void numa_for_each_chunk(std::vector<size_t> const &chunk_nodes,
+                         numa_topology const &topology,
+                         unsigned int concurrency,
+                         F const &fn) {
+    if (chunk_nodes.empty()) {
+        return;
+    }
+    size_t const node_count{ topology.node_count() };
+    std::vector<std::vector<size_t>> node_chunks(node_count);
+    for (size_t chunk = 0; chunk < chunk_nodes.size(); ++chunk) {
+        node_chunks[chunk_nodes[chunk] % node_count].push_back(chunk);
+    }
+    //
+    // Calling thread works on its node. Other workers
+    // are spread between nodes that own chunks
+    //
+    size_t const thread_count{ std::min<size_t>(parallel_concurrency(concurrency), chunk_nodes.size()) };
+    std::vector<size_t> worker_nodes;
+    worker_nodes.reserve(thread_count);
+    worker_nodes.push_back(topology.current_node());
+    for (size_t node = worker_nodes.front(); worker_nodes.size() < thread_count;) {
+        node = (node + 1) % node_count;
+        if (!node_chunks[node].empty() || node == worker_nodes.front()) {
+            worker_nodes.push_back(node);
+        }
+    }
+
+    struct alignas(64) node_queue {
+        std::atomic<size_t> next{ 0 };
+    };
+    std::unique_ptr<node_queue[]> queues{ std::make_unique<node_queue[]>(node_count) };
+
+    parallel_run_workers(thread_count,
+                         [&](size_t worker_idx, std::atomic<bool> const &failed) {
+                             size_t const home_node{ worker_nodes[worker_idx] };
+                             if (0 != worker_idx) {
+                                 //
+                                 // Thread still runs correctly, just
+                                 // not close to its data
+                                 //
+                                 [[maybe_unused]] int const error{ topology.bind_current_thread(home_node) };
+                             }
+                             for (size_t step = 0; step < node_count; ++step) {
+                                 size_t const node{ (home_node + step) % node_count };
+                                 std::vector<size_t> const &chunks{ node_chunks[node] };
+                                 for (;;) {
+                                     size_t const idx{ queues[node].next.fetch_add(1, std::memory_order_relaxed) };
+                                     if (chunks.size() <= idx || failed.load(std::memory_order_relaxed)) {
+                                         break;
+                                     }
+                                     fn(chunks[idx]);
+                                 }
+                             }
+                         });
+}
+
+//!
+//! @brief Finds node that owns each chunk created by
+//! flat_forward_list_split.
+//! @tparam I - type of iterator.
+//! @param boundaries - chunk boundaries.
+//! @param topology - NUMA topology.
+//! @returns node that owns first element of each chunk.
+//! @throw std::bad_alloc if allocation fails.
+//!
+template <typename I>
+std::vector<size_t> numa_chunk_nodes(std::vector<I> const &boundaries,
+                                     numa_topology const &topology) {
+    std::vector<size_t> chunk_nodes;
+    if (boundaries.empty()) {
+        return chunk_nodes;
+    }
+    chunk_nodes.reserve(boundaries.size() - 1);
+    for (size_t chunk = 0; chunk + 1 < boundaries.size(); ++chunk) {
+        chunk_nodes.push_back(topology.node_of(boundaries[chunk].get_ptr()));
+    }
+    return chunk_nodes;
+}
+
+//!
+//! @brief Calls functor for each element on threads running on the
+//! node that owns the element.
+//! @tparam I - type of iterator.
+//! @tparam F - type of the functor.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param fn - functor that is called with a reference to each element.
+//! Functor is called concurrently from different threads.
+//! @param topology - NUMA topology.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functor.
+//! @details Node of a chunk is the node that owns chunk's first element.
+//!
+template <typename I,
+          typename F>
+void numa_parallel_for_each(I const &first,
+                            I const &end,
+                            F const &fn,
+                            numa_topology const &topology = numa_topology::system(),
+                            unsigned int concurrency = 0) {
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<I> const boundaries{ flat_forward_list_split(first,
+                                                             end,
+                                                             thread_count * parallel_chunks_per_thread) };
+    std::vector<size_t> const chunk_nodes{ numa_chunk_nodes(boundaries, topology) };
+    parallel_for_each_in_chunks(boundaries,
+                                fn,
+                                [&chunk_nodes, &topology, thread_count](size_t, auto const &chunk_fn) {
+                                    numa_for_each_chunk(chunk_nodes, topology, thread_count, chunk_fn);
+                                });
+}
+
+//!
+//! @brief Calls functor for each element of a container or a view
+//! on threads running on the node that owns the element.
+//! @tparam C - type of container or view.
+//! @tparam F - type of the functor.
+//! @param c - container or view.
+//! @param fn - functor that is called with a reference to each element.
+//! @param topology - NUMA topology.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//!
+template <typename C,
+          typename F>
+void numa_parallel_for_each(C &c,
+                            F const &fn,
+                            numa_topology const &topology = numa_topology::system(),
+                            unsigned int concurrency = 0) {
+    numa_parallel_for_each(c.begin(), c.end(), fn, topology, concurrency);
+}
+
+//!
+//! @brief Transforms each element, and reduces results on threads
+//! running on the node that owns the element.
+//! @tparam I - type of iterator.
+//! @tparam R - type of the result.
+//! @tparam BO - type of the reduce functor.
+//! @tparam UO - type of the transform functor.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param init - initial value.
+//! @param reduce - associative functor that combines two values.
+//! @param transform - functor that is called with a reference to each
+//! element, and returns value that is reduced.
+//! @param topology - NUMA topology.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns init reduced with transformed values of all elements.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functors.
+//! @details Chunk results are reduced in the order of chunks,
+//! so reduce does not have to be commutative.
+//!
+template <typename I,
+          typename R,
+          typename BO,
+          typename UO>
+R numa_parallel_transform_reduce(I const &first,
+                                 I const &end,
+                                 R init,
+                                 BO const &reduce,
+                                 UO const &transform,
+                                 numa_topology const &topology = numa_topology::system(),
+                                 unsigned int concurrency = 0) {
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<I> const boundaries{ flat_forward_list_split(first,
+                                                             end,
+                                                             thread_count * parallel_chunks_per_thread) };
+    std::vector<size_t> const chunk_nodes{ numa_chunk_nodes(boundaries, topology) };
+    return parallel_transform_reduce_chunks(boundaries,
+                                            std::move(init),
+                                            reduce,
+                                            transform,
+                                            [&chunk_nodes, &topology, thread_count](size_t, auto const &chunk_fn) {
+                                                numa_for_each_chunk(chunk_nodes, topology, thread_count, chunk_fn);
+                                            });
+}
+
+//!
+//! @brief Validates a batch of buffers on threads running on the
+//! node that owns the buffers.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam F - type of the element validation functor.
+//! @param buffers - pointer to an array of buffer descriptors.
+//! @param count - number of buffers.
+//! @param results - pointer to an array of count results. Result i
+//! is set to what flat_forward_list_validate returns for buffer i.
+//! @param topology - NUMA topology.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @param validate_element_fn - functor used to validate each element.
+//! @throw std::bad_alloc, std::system_error if starting a thread fails.
+//! @details Node of a chunk is the node that owns chunk's first buffer.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename F = default_validate_element_fn<T, TT>>
+void numa_flat_forward_list_validate_batch(flat_forward_list_buffer const *buffers,
+                                           size_t count,
+                                           flat_forward_list_validation_result<T, TT> *results,
+                                           numa_topology const &topology = numa_topology::system(),
+                                           unsigned int concurrency = 0,
+                                           F const &validate_element_fn = F{}) {
+    if (0 == count) {
+        return;
+    }
+    FFL_CODDING_ERROR_IF(nullptr == buffers || nullptr == results);
+
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<size_t> const boundaries{ flat_forward_list_split_buffers(buffers, count, thread_count) };
+    std::vector<size_t> chunk_nodes;
+    chunk_nodes.reserve(boundaries.size() - 1);
+    for (size_t chunk = 0; chunk + 1 < boundaries.size(); ++chunk) {
+        chunk_nodes.push_back(topology.node_of(buffers[boundaries[chunk]].begin));
+    }
+    numa_for_each_chunk(chunk_nodes,
+                        topology,
+                        thread_count,
+                        [buffers, results, &boundaries, &validate_element_fn](size_t chunk) noexcept {
+                            flat_forward_list_validate_buffers<T, TT, F>(buffers,
+                                                                         boundaries[chunk],
+                                                                         boundaries[chunk + 1],
+                                                                         results,
+                                                                         validate_element_fn);
+                        });
+}
+
+} // namespace iffl
+
+#endif
@@ -0,0 +1,1077 @@
+#pragma once
+
+//!
+//! @file iffl_parallel.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements algorithms that process elements
+//!        of a flat forward list on multiple threads.
+//!
+//! @details Moving an iterator to the next element requires reading
+//!          current element, so list cannot be split at an arbitrary
+//!          position. Algorithms in this module walk list once to split
+//!          it into chunks of about the same number of bytes, and then
+//!          process chunks on a set of worker threads.
+//!          Algorithms that process a collection of lists split
+//!          all lists into tasks of about the same number of bytes,
+//!          and balance tasks between workers with work stealing.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+#include <iffl_aligned_view.h>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Number of chunks we create for each worker thread.
+//! More chunks help balance work when processing time
+//! of elements is not proportional to their size.
+//!
+constexpr inline size_t const parallel_chunks_per_thread{ 4 };
+
+//!
+//! @brief Minimum number of bytes in a chunk of buffers that
+//! flat_forward_list_validate_batch validates on one thread.
+//! Smaller batches are validated on fewer threads, so starting
+//! a thread costs less than the work it does.
+//!
+constexpr inline size_t const parallel_validate_min_chunk_size{ 64 * 1024 };
+
+//!
+//! @brief Minimum number of bytes in a chunk that parallel_realign
+//! copies on one thread. Smaller lists are copied on fewer threads.
+//!
+constexpr inline size_t const parallel_realign_min_chunk_size{ 64 * 1024 };
+
+//!
+//! @brief Returns number of threads to use
+//! @param concurrency - number of threads requested by the caller.
+//! 0 means number of hardware threads.
+//! @returns number of threads to use. Always at least 1.
+//!
+inline unsigned int parallel_concurrency(unsigned int concurrency) noexcept {
+    if (0 == concurrency) {
+        concurrency = std::thread::hardware_concurrency();
+    }
+    return concurrency ? concurrency : 1;
+}
+
+//!
+//! @brief Splits range of elements into chunks of about the
+//! same size in bytes.
+//! @tparam I - type of iterator.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param chunk_count - maximum number of chunks.
+//! @returns vector of chunk boundaries. Chunk i is the range
+//! [result[i], result[i + 1]). First boundary is first, and last
+//! boundary is end. Vector is empty if range is empty.
+//! @throw std::bad_alloc if allocating vector fails.
+//! @details Walks range once. Chunk boundary is placed at the first
+//! element that starts at or past the chunk's share of bytes,
+//! so one large element can leave some chunks empty. Empty
+//! chunks are not returned.
+//!
+template <typename I>
+std::vector<I> flat_forward_list_split(I const &first,
+                                       I const &end,
+                                       size_t chunk_count) {
+    std::vector<I> boundaries;
+    if (first == end) {
+        return boundaries;
+    }
+    FFL_CODDING_ERROR_IF(0 == chunk_count);
+    size_t const total_size{ static_cast<size_t>(end.get_ptr() - first.get_ptr()) };
+    boundaries.reserve(chunk_count + 1);
+    boundaries.push_back(first);
+
+    size_t next_chunk{ 1 };
+    for (I cur = first; cur != end && next_chunk < chunk_count; ++cur) {
+        size_t const offset{ static_cast<size_t>(cur.get_ptr() - first.get_ptr()) };
+        if (offset * chunk_count < total_size * next_chunk) {
+            continue;
+        }
+        if (boundaries.back() != cur) {
+            boundaries.push_back(cur);
+        }
+        //
+        // Skip chunks that this element covered
+        //
+        while (next_chunk < chunk_count && total_size * next_chunk <= offset * chunk_count) {
+            ++next_chunk;
+        }
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
+
+//!
+//! @brief Runs worker functor on a set of threads.
+//! @tparam W - type of the worker functor.
+//! @param thread_count - number of workers including the calling thread.
+//! @param worker - functor that is called with worker index, and
+//! a flag that is set once any of the workers raised an exception.
+//! Workers should stop when they see the flag.
+//! @throw std::system_error if starting a thread fails.
+//!        First exception raised by a worker.
+//! @details Calling thread runs worker 0. Returns after all
+//! workers returned.
+//!
+template <typename W>
+void parallel_run_workers(size_t thread_count,
+                          W const &worker) {
+    std::atomic<bool> failed{ false };
+    std::exception_ptr first_exception;
+
+    auto const run_worker{ [&worker, &failed, &first_exception](size_t worker_idx) noexcept {
+        try {
+            worker(worker_idx, failed);
+        } catch (...) {
+            if (!failed.exchange(true)) {
+                first_exception = std::current_exception();
+            }
+        }
+    } };
+
+    std::vector<std::thread> threads;
+    auto join_threads{ make_scope_guard([&threads]() noexcept {
+        for (std::thread &t : threads) {
+            t.join();
+        }
+    }) };
+    if (1 < thread_count) {
+        auto stop_workers{ make_scope_guard([&failed]() noexcept {
+            failed = true;
+        }) };
+        threads.reserve(thread_count - 1);
+        for (size_t idx = 1; idx < thread_count; ++idx) {
+            threads.emplace_back(run_worker, idx);
+        }
+        stop_workers.disarm();
+    }
+    run_worker(0);
+    join_threads.discharge();
+
+    if (first_exception) {
+        std::rethrow_exception(first_exception);
+    }
+}
+
+//!
+//! @brief Calls functor for each chunk on a set of worker threads.
+//! @tparam F - type of the functor.
+//! @param chunk_count - number of chunks.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @param fn - functor that is called with a chunk index.
+//! @throw std::system_error if starting a thread fails.
+//!        First exception raised by the functor. Remaining chunks
+//!        are not started after functor raised.
+//! @details Calling thread processes chunks too. Threads pick
+//! next chunk from a shared counter, so a thread that finished
+//! early picks up more chunks.
+//!
+template <typename F>
+void parallel_for_each_chunk(size_t chunk_count,
+                             unsigned int concurrency,
+                             F const &fn) {
+    std::atomic<size_t> next_chunk{ 0 };
+    parallel_run_workers(std::min<size_t>(parallel_concurrency(concurrency), chunk_count),
+                         [chunk_count, &fn, &next_chunk](size_t, std::atomic<bool> const &failed) {
+                             for (;;) {
+                                 size_t const chunk{ next_chunk.fetch_add(1, std::memory_order_relaxed) };
+                                 if (chunk_count <= chunk || failed.load(std::memory_order_relaxed)) {
+                                     break;
+                                 }
+                                 fn(chunk);
+                             }
+                         });
+}
+
+//!
+//! @brief Calls functor for each element of chunks created by
+//! flat_forward_list_split.
+//! @tparam I - type of iterator.
+//! @tparam F - type of the functor.
+//! @tparam S - type of the chunk scheduler.
+//! @param boundaries - chunk boundaries.
+//! @param fn - functor that is called with a reference to each element.
+//! @param schedule - functor that is called with number of chunks, and
+//! a functor that processes a chunk by index. It decides what threads
+//! process each chunk, for instance parallel_for_each_chunk.
+//!
+template <typename I,
+          typename F,
+          typename S>
+void parallel_for_each_in_chunks(std::vector<I> const &boundaries,
+                                 F const &fn,
+                                 S const &schedule) {
+    if (boundaries.empty()) {
+        return;
+    }
+    schedule(boundaries.size() - 1,
+             [&boundaries, &fn](size_t chunk) {
+                 for (I cur = boundaries[chunk]; cur != boundaries[chunk + 1]; ++cur) {
+                     fn(*cur);
+                 }
+             });
+}
+
+//!
+//! @brief Transforms each element of chunks created by
+//! flat_forward_list_split, and reduces results.
+//! @tparam I - type of iterator.
+//! @tparam R - type of the result.
+//! @tparam BO - type of the reduce functor.
+//! @tparam UO - type of the transform functor.
+//! @tparam S - type of the chunk scheduler.
+//! @param boundaries - chunk boundaries.
+//! @param init - initial value.
+//! @param reduce - associative functor that combines two values.
+//! @param transform - functor that is called with a reference to each
+//! element, and returns value that is reduced.
+//! @param schedule - functor that is called with number of chunks, and
+//! a functor that processes a chunk by index.
+//! @returns init reduced with transformed values of all elements.
+//! @details Chunk results are reduced in the order of chunks on the
+//! calling thread, so reduce does not have to be commutative.
+//!
+template <typename I,
+          typename R,
+          typename BO,
+          typename UO,
+          typename S>
+R parallel_transform_reduce_chunks(std::vector<I> const &boundaries,
+                                   R init,
+                                   BO const &reduce,
+                                   UO const &transform,
+                                   S const &schedule) {
+    if (boundaries.empty()) {
+        return init;
+    }
+    std::vector<std::optional<R>> chunk_results(boundaries.size() - 1);
+    schedule(chunk_results.size(),
+             [&boundaries, &chunk_results, &reduce, &transform](size_t chunk) {
+                 I cur{ boundaries[chunk] };
+                 R result{ transform(*cur) };
+                 for (++cur; cur != boundaries[chunk + 1]; ++cur) {
+                     result = reduce(std::move(result), transform(*cur));
+                 }
+                 chunk_results[chunk].emplace(std::move(result));
+             });
+    for (std::optional<R> &chunk_result : chunk_results) {
+        init = reduce(std::move(init), std::move(*chunk_result));
+    }
+    return init;
+}
+
+//!
+//! @brief Calls functor for each element on a set of worker threads.
+//! @tparam I - type of iterator.
+//! @tparam F - type of the functor.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param fn - functor that is called with a reference to each element.
+//! Functor is called concurrently from different threads.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functor.
+//!
+template <typename I,
+          typename F>
+void parallel_for_each(I const &first,
+                       I const &end,
+                       F const &fn,
+                       unsigned int concurrency = 0) {
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<I> const boundaries{ flat_forward_list_split(first,
+                                                             end,
+                                                             thread_count * parallel_chunks_per_thread) };
+    parallel_for_each_in_chunks(boundaries,
+                                fn,
+                                [thread_count](size_t chunk_count, auto const &chunk_fn) {
+                                    parallel_for_each_chunk(chunk_count, thread_count, chunk_fn);
+                                });
+}
+
+//!
+//! @brief Calls functor for each element of a container or a view
+//! on a set of worker threads.
+//! @tparam C - type of container or view.
+//! @tparam F - type of the functor.
+//! @param c - container or view.
+//! @param fn - functor that is called with a reference to each element.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//!
+template <typename C,
+          typename F>
+void parallel_for_each(C &c,
+                       F const &fn,
+                       unsigned int concurrency = 0) {
+    parallel_for_each(c.begin(), c.end(), fn, concurrency);
+}
+
+//!
+//! @brief Transforms each element, and reduces results on a set
+//! of worker threads.
+//! @tparam I - type of iterator.
+//! @tparam R - type of the result.
+//! @tparam BO - type of the reduce functor.
+//! @tparam UO - type of the transform functor.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param init - initial value.
+//! @param reduce - associative functor that combines two values.
+//! @param transform - functor that is called with a reference to each
+//! element, and returns value that is reduced.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns init reduced with transformed values of all elements.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functors.
+//! @details Chunks are reduced in parallel, and chunk results are
+//! reduced in the order of chunks on the calling thread, so reduce
+//! does not have to be commutative.
+//!
+template <typename I,
+          typename R,
+          typename BO,
+          typename UO>
+R parallel_transform_reduce(I const &first,
+                            I const &end,
+                            R init,
+                            BO const &reduce,
+                            UO const &transform,
+                            unsigned int concurrency = 0) {
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<I> const boundaries{ flat_forward_list_split(first,
+                                                             end,
+                                                             thread_count * parallel_chunks_per_thread) };
+    return parallel_transform_reduce_chunks(boundaries,
+                                            std::move(init),
+                                            reduce,
+                                            transform,
+                                            [thread_count](size_t chunk_count, auto const &chunk_fn) {
+                                                parallel_for_each_chunk(chunk_count, thread_count, chunk_fn);
+                                            });
+}
+
+//!
+//! @brief Transforms each element of a container or a view, and reduces
+//! results on a set of worker threads.
+//! @tparam C - type of container or view.
+//! @tparam R - type of the result.
+//! @tparam BO - type of the reduce functor.
+//! @tparam UO - type of the transform functor.
+//! @param c - container or view.
+//! @param init - initial value.
+//! @param reduce - associative functor that combines two values.
+//! @param transform - functor that is called with a reference to each
+//! element, and returns value that is reduced.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns init reduced with transformed values of all elements.
+//!
+template <typename C,
+          typename R,
+          typename BO,
+          typename UO>
+R parallel_transform_reduce(C &c,
+                            R init,
+                            BO const &reduce,
+                            UO const &transform,
+                            unsigned int concurrency = 0) {
+    return parallel_transform_reduce(c.begin(), c.end(), std::move(init), reduce, transform, concurrency);
+}
+
+//!
+//! @brief Counts elements that satisfy predicate on a set of
+//! worker threads.
+//! @tparam I - type of iterator.
+//! @tparam P - type of the predicate.
+//! @param first - iterator to the first element.
+//! @param end - iterator past the last element.
+//! @param pred - predicate that is called with a reference to each element.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns number of elements for which predicate returned true.
+//!
+template <typename I,
+          typename P>
+size_t parallel_count_if(I const &first,
+                         I const &end,
+                         P const &pred,
+                         unsigned int concurrency = 0) {
+    return parallel_transform_reduce(first,
+                                     end,
+                                     size_t{ 0 },
+                                     [](size_t lhs, size_t rhs) noexcept -> size_t {
+                                         return lhs + rhs;
+                                     },
+                                     [&pred](auto const &e) -> size_t {
+                                         return pred(e) ? 1 : 0;
+                                     },
+                                     concurrency);
+}
+
+//!
+//! @brief Counts elements of a container or a view that satisfy
+//! predicate on a set of worker threads.
+//! @tparam C - type of container or view.
+//! @tparam P - type of the predicate.
+//! @param c - container or view.
+//! @param pred - predicate that is called with a reference to each element.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns number of elements for which predicate returned true.
+//!
+template <typename C,
+          typename P>
+size_t parallel_count_if(C &c,
+                         P const &pred,
+                         unsigned int concurrency = 0) {
+    return parallel_count_if(c.begin(), c.end(), pred, concurrency);
+}
+
+//!
+//! @brief Copies elements of a list that is not aligned to a list
+//! aligned for traits TT on a set of worker threads.
+//! @tparam T - element type
+//! @tparam STT - traits of the list we are copying from.
+//! @tparam TT - traits of the list we are copying to
+//! @tparam A - allocator type
+//! @param view - validated list we are copying from
+//! @param a - allocator of the new list
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @returns new list. Buffer is just large enough for all elements.
+//! @throw std::bad_alloc, std::system_error if starting a thread fails.
+//! @details List is split into chunks that start at an element. Each
+//! thread calculates size of its chunks in the new buffer. Chunk
+//! offsets are calculated on the calling thread, and then each thread
+//! copies its chunks. Offset of a chunk is padded to alignment, so
+//! elements are at the same offsets as flat_forward_list_realign
+//! places them.
+//!
+template <typename T,
+          typename STT,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+flat_forward_list<T, TT, A> parallel_realign(flat_forward_list_view<T, STT> const &view,
+                                             A const &a = A{},
+                                             unsigned int concurrency = 0) {
+    using list_type = flat_forward_list<T, TT, A>;
+    using allocator_type_traits = typename list_type::allocator_type_traits;
+    using iterator = typename flat_forward_list_view<T, STT>::const_iterator;
+
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    size_t const chunk_count{ std::min<size_t>(thread_count * parallel_chunks_per_thread,
+                                               view.used_capacity() / parallel_realign_min_chunk_size) };
+    if (chunk_count < 2) {
+        return flat_forward_list_realign<T, STT, TT, A>(view, a);
+    }
+    std::vector<iterator> const boundaries{ flat_forward_list_split(view.cbegin(), view.cend(), chunk_count) };
+    size_t const split_count{ boundaries.size() - 1 };
+    //
+    // Entry i + 1 is the end of the chunk i in the new buffer.
+    // Chunk i starts at entry i rounded up to alignment, and
+    // the last entry is the buffer size.
+    //
+    std::vector<size_t> offsets(split_count + 1);
+    parallel_for_each_chunk(split_count,
+                            thread_count,
+                            [&boundaries, &offsets](size_t chunk) noexcept {
+                                offsets[chunk + 1] = flat_forward_list_realigned_size<TT>(boundaries[chunk],
+                                                                                          boundaries[chunk + 1]);
+                            });
+    for (size_t chunk = 1; chunk <= split_count; ++chunk) {
+        offsets[chunk] += flat_forward_list_traits_traits<T, TT>::roundup_to_alignment(offsets[chunk - 1]);
+    }
+
+    typename list_type::allocator_type allocator{ a };
+    size_t const buffer_size{ offsets[split_count] };
+    char *const buffer{ allocator_type_traits::allocate(allocator, buffer_size) };
+    FFL_CODDING_ERROR_IF(nullptr == buffer);
+    auto deallocate_buffer{ make_scope_guard([&allocator, buffer, buffer_size]() noexcept {
+        allocator_type_traits::deallocate(allocator, buffer, buffer_size);
+    }) };
+
+    std::vector<char *> lasts(split_count);
+    parallel_for_each_chunk(split_count,
+                            thread_count,
+                            [&boundaries, &offsets, &lasts, buffer, split_count](size_t chunk) noexcept {
+                                lasts[chunk] = flat_forward_list_realign_copy<TT>(boundaries[chunk],
+                                                                                  boundaries[chunk + 1],
+                                                                                  buffer + flat_forward_list_traits_traits<T, TT>::roundup_to_alignment(offsets[chunk]),
+                                                                                  chunk + 1 == split_count);
+                            });
+    deallocate_buffer.disarm();
+    return list_type{ attach_buffer{}, buffer, lasts.back(), buffer + buffer_size, std::move(allocator) };
+}
+
+//!
+//! @class parallel_work_stealing_queues
+//! @brief Distributes task indices between a set of workers.
+//! @details Each worker owns a range of task indices. Worker takes
+//! tasks from the front of its own range. Once its range is empty
+//! it steals back half of a range owned by another worker.
+//! Range is packed into a single 64 bits atomic, so taking and
+//! stealing is a single compare and exchange.
+//! Tasks are never added back, so a range value never repeats,
+//! and compare and exchange does not suffer from ABA.
+//! Queues use relaxed ordering. Task descriptions must be
+//! published to workers before they start, for instance by
+//! creating queues before starting threads.
+//!
+class parallel_work_stealing_queues {
+public:
+    //!
+    //! @brief Constructor
+    //! @param worker_count - number of workers.
+    //! @param task_count - number of tasks. Tasks are split
+    //! between workers in equal ranges.
+    //! @throw std::bad_alloc if allocating queues fails.
+    //!
+    parallel_work_stealing_queues(size_t worker_count,
+                                  size_t task_count)
+        : worker_count_{ worker_count } {
+        FFL_CODDING_ERROR_IF(0 == worker_count);
+        FFL_CODDING_ERROR_IF(static_cast<size_t>(std::numeric_limits<uint32_t>::max()) < task_count);
+        queues_ = std::make_unique<queue[]>(worker_count);
+        size_t begin{ 0 };
+        for (size_t idx = 0; idx < worker_count; ++idx) {
+            size_t const end{ task_count * (idx + 1) / worker_count };
+            queues_[idx].range.store(pack(begin, end), std::memory_order_relaxed);
+            begin = end;
+        }
+    }
+    //!
+    //! @brief Returns next task for a worker.
+    //! @param worker_idx - index of the worker.
+    //! @returns index of a task or npos if all queues
+    //! were empty.
+    //! @details npos might be returned while another worker
+    //! still has tasks it just stole. That worker will
+    //! process these tasks itself.
+    //!
+    size_t pop(size_t worker_idx) noexcept {
+        FFL_CODDING_ERROR_IF_NOT(worker_idx < worker_count_);
+        size_t const task{ pop_front(worker_idx) };
+        return (npos != task) ? task : steal(worker_idx);
+    }
+    //!
+    //! @returns number of workers.
+    //!
+    size_t worker_count() const noexcept {
+        return worker_count_;
+    }
+
+private:
+    //!
+    //! @brief Packed range of task indices.
+    //! Higher 32 bits is begin, and lower 32 bits is end.
+    //!
+    using range_t = uint64_t;
+    //!
+    //! @brief Queue owned by a worker. Each queue is on its
+    //! own cache line so workers do not slow down each other.
+    //!
+    struct alignas(64) queue {
+        std::atomic<range_t> range{ 0 };
+    };
+
+    static range_t pack(size_t begin, size_t end) noexcept {
+        return (static_cast<range_t>(begin) << 32) | static_cast<range_t>(end);
+    }
+
+    static size_t range_begin(range_t range) noexcept {
+        return static_cast<size_t>(range >> 32);
+    }
+
+    static size_t range_end(range_t range) noexcept {
+        return static_cast<size_t>(range & 0xFFFFFFFF);
+    }
+
+    size_t pop_front(size_t worker_idx) noexcept {
+        std::atomic<range_t> &range{ queues_[worker_idx].range };
+        range_t cur{ range.load(std::memory_order_relaxed) };
+        for (;;) {
+            size_t const begin{ range_begin(cur) };
+            size_t const end{ range_end(cur) };
+            if (end <= begin) {
+                return npos;
+            }
+            if (range.compare_exchange_weak(cur, pack(begin + 1, end), std::memory_order_relaxed)) {
+                return begin;
+            }
+        }
+    }
+
+    size_t steal(size_t worker_idx) noexcept {
+        for (size_t step = 1; step < worker_count_; ++step) {
+            std::atomic<range_t> &range{ queues_[(worker_idx + step) % worker_count_].range };
+            range_t cur{ range.load(std::memory_order_relaxed) };
+            for (;;) {
+                size_t const begin{ range_begin(cur) };
+                size_t const end{ range_end(cur) };
+                if (end <= begin) {
+                    break;
+                }
+                size_t const stolen_begin{ end - (end - begin + 1) / 2 };
+                if (range.compare_exchange_weak(cur, pack(begin, stolen_begin), std::memory_order_relaxed)) {
+                    //
+                    // Our own queue is empty, and only we can
+                    // add tasks to it
+                    //
+                    queues_[worker_idx].range.store(pack(stolen_begin + 1, end), std::memory_order_relaxed);
+                    return stolen_begin;
+                }
+            }
+        }
+        return npos;
+    }
+
+    size_t worker_count_{ 0 };
+    std::unique_ptr<queue[]> queues_;
+};
+
+//!
+//! @brief Type of view used to describe part of a list
+//! in a collection of lists.
+//! @tparam L - type of container or view in the collection.
+//!
+template <typename L>
+using parallel_list_view_t = flat_forward_list_view<std::remove_const_t<typename L::value_type>,
+                                                    typename L::traits>;
+
+//!
+//! @brief Part of a list in a collection of lists.
+//! @tparam V - type of view.
+//!
+template <typename V>
+struct parallel_list_segment {
+    //!
+    //! @brief Index of the list in the collection.
+    //!
+    size_t list_index{ 0 };
+    //!
+    //! @brief Elements of the list.
+    //!
+    V view;
+};
+
+//!
+//! @brief Collection of lists split into tasks.
+//! @tparam V - type of view.
+//! @details Task i is the range of segments
+//! [task_boundaries[i], task_boundaries[i + 1]).
+//! A task might span several small lists, and
+//! a large list might be split between several tasks.
+//!
+template <typename V>
+struct parallel_list_tasks {
+    //!
+    //! @brief Segments in the order of lists and elements.
+    //!
+    std::vector<parallel_list_segment<V>> segments;
+    //!
+    //! @brief Boundaries of tasks in the segments vector.
+    //! Empty if there are no tasks.
+    //!
+    std::vector<size_t> task_boundaries;
+    //!
+    //! @returns number of tasks.
+    //!
+    size_t task_count() const noexcept {
+        return task_boundaries.empty() ? 0 : task_boundaries.size() - 1;
+    }
+};
+
+//!
+//! @brief Splits a collection of lists into tasks of about
+//! the same size in bytes.
+//! @tparam LI - type of iterator over the collection of containers or views.
+//! @param lists_first - iterator to the first list.
+//! @param lists_end - iterator past the last list.
+//! @param task_count - desired number of tasks.
+//! @returns segments and task boundaries. Each task has at
+//! least total size / task_count bytes, except the last one.
+//! @throw std::bad_alloc if allocating vectors fails.
+//! @details Walks each list once. Task boundary is placed after
+//! the element that filled task's share of bytes. Empty lists
+//! do not produce segments.
+//!
+template <typename LI>
+auto flat_forward_list_split_lists(LI const &lists_first,
+                                   LI const &lists_end,
+                                   size_t task_count) {
+    using view_type = parallel_list_view_t<typename std::iterator_traits<LI>::value_type>;
+    FFL_CODDING_ERROR_IF(0 == task_count);
+
+    parallel_list_tasks<view_type> result;
+    size_t total_size{ 0 };
+    for (LI l = lists_first; l != lists_end; ++l) {
+        auto const &list{ *l };
+        total_size += static_cast<size_t>(list.end().get_ptr() - list.begin().get_ptr());
+    }
+    if (0 == total_size) {
+        return result;
+    }
+    size_t const task_size{ (total_size + task_count - 1) / task_count };
+
+    result.task_boundaries.push_back(0);
+    size_t current_task_size{ 0 };
+    size_t list_index{ 0 };
+    for (LI l = lists_first; l != lists_end; ++l, ++list_index) {
+        auto const &list{ *l };
+        auto const list_end{ list.end() };
+        auto segment_begin{ list.begin() };
+        for (auto cur = segment_begin; cur != list_end;) {
+            auto next{ cur };
+            ++next;
+            current_task_size += static_cast<size_t>(next.get_ptr() - cur.get_ptr());
+            bool const task_filled{ task_size <= current_task_size };
+            if (task_filled || next == list_end) {
+                result.segments.push_back(parallel_list_segment<view_type>{ list_index,
+                                                                            view_type{ segment_begin, cur } });
+                segment_begin = next;
+            }
+            if (task_filled) {
+                result.task_boundaries.push_back(result.segments.size());
+                current_task_size = 0;
+            }
+            cur = next;
+        }
+    }
+    if (result.task_boundaries.back() != result.segments.size()) {
+        result.task_boundaries.push_back(result.segments.size());
+    }
+    return result;
+}
+
+//!
+//! @brief Calls functor for parts of each list in a collection
+//! of lists on a set of worker threads.
+//! @tparam LI - type of iterator over the collection of containers or views.
+//! @tparam F - type of the functor.
+//! @param lists_first - iterator to the first list.
+//! @param lists_end - iterator past the last list.
+//! @param fn - functor that is called with index of the list in the
+//! collection, and a view over a part of that list. Functor is called
+//! concurrently from different threads, and might be called several
+//! times for the same list with views over different elements.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functor. Remaining tasks are not started
+//!        after functor raised.
+//! @details Lists are split by number of bytes, not by number of
+//! lists, so a collection of very uneven lists is spread evenly
+//! between workers. Workers that ran out of tasks steal tasks
+//! from other workers.
+//!
+template <typename LI,
+          typename F>
+void parallel_for_each_view_in_lists(LI const &lists_first,
+                                     LI const &lists_end,
+                                     F const &fn,
+                                     unsigned int concurrency = 0) {
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    auto const tasks{ flat_forward_list_split_lists(lists_first,
+                                                    lists_end,
+                                                    thread_count * parallel_chunks_per_thread) };
+    if (0 == tasks.task_count()) {
+        return;
+    }
+    parallel_work_stealing_queues queues{ std::min<size_t>(thread_count, tasks.task_count()),
+                                          tasks.task_count() };
+    parallel_run_workers(queues.worker_count(),
+                         [&tasks, &queues, &fn](size_t worker_idx, std::atomic<bool> const &failed) {
+                             for (;;) {
+                                 size_t const task{ queues.pop(worker_idx) };
+                                 if (npos == task || failed.load(std::memory_order_relaxed)) {
+                                     break;
+                                 }
+                                 for (size_t idx = tasks.task_boundaries[task];
+                                      idx < tasks.task_boundaries[task + 1];
+                                      ++idx) {
+                                     fn(tasks.segments[idx].list_index, tasks.segments[idx].view);
+                                 }
+                             }
+                         });
+}
+
+//!
+//! @brief Calls functor for parts of each list in a collection
+//! of lists on a set of worker threads.
+//! @tparam C - type of collection of containers or views.
+//! @tparam F - type of the functor.
+//! @param lists - collection of lists.
+//! @param fn - functor that is called with index of the list in the
+//! collection, and a view over a part of that list.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//!
+template <typename C,
+          typename F>
+void parallel_for_each_view_in_lists(C const &lists,
+                                     F const &fn,
+                                     unsigned int concurrency = 0) {
+    parallel_for_each_view_in_lists(std::begin(lists), std::end(lists), fn, concurrency);
+}
+
+//!
+//! @brief Calls functor for each element of each list in a collection
+//! of lists on a set of worker threads.
+//! @tparam LI - type of iterator over the collection of containers or views.
+//! @tparam F - type of the functor.
+//! @param lists_first - iterator to the first list.
+//! @param lists_end - iterator past the last list.
+//! @param fn - functor that is called with index of the list in the
+//! collection, and a reference to an element of that list.
+//! Functor is called concurrently from different threads.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @throw std::bad_alloc, std::system_error, or first exception
+//!        raised by the functor.
+//!
+template <typename LI,
+          typename F>
+void parallel_for_each_in_lists(LI const &lists_first,
+                                LI const &lists_end,
+                                F const &fn,
+                                unsigned int concurrency = 0) {
+    parallel_for_each_view_in_lists(lists_first,
+                                    lists_end,
+                                    [&fn](size_t list_index, auto const &view) {
+                                        for (auto const &e : view) {
+                                            fn(list_index, e);
+                                        }
+                                    },
+                                    concurrency);
+}
+
+//!
+//! @brief Calls functor for each element of each list in a collection
+//! of lists on a set of worker threads.
+//! @tparam C - type of collection of containers or views.
+//! @tparam F - type of the functor.
+//! @param lists - collection of lists.
+//! @param fn - functor that is called with index of the list in the
+//! collection, and a reference to an element of that list.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//!
+template <typename C,
+          typename F>
+void parallel_for_each_in_lists(C const &lists,
+                                F const &fn,
+                                unsigned int concurrency = 0) {
+    parallel_for_each_in_lists(std::begin(lists), std::end(lists), fn, concurrency);
+}
+
+//!
+//! @struct flat_forward_list_buffer
+//! @brief Describes a buffer that might contain a list.
+//!
+struct flat_forward_list_buffer {
+    //!
+    //! @brief Pointer to the start of the buffer.
+    //!
+    char const *begin{ nullptr };
+    //!
+    //! @brief Buffer size in bytes.
+    //!
+    size_t size{ 0 };
+};
+
+//!
+//! @struct flat_forward_list_validation_result
+//! @brief Result of validating a buffer.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+struct flat_forward_list_validation_result {
+    //!
+    //! @brief true if whole buffer contains a valid list.
+    //!
+    bool is_valid{ false };
+    //!
+    //! @brief View over valid elements at the start of the buffer.
+    //!
+    flat_forward_list_view<T, TT> view;
+};
+
+//!
+//! @brief Splits array of buffers into chunks of about the same
+//! size in bytes.
+//! @param buffers - pointer to an array of buffer descriptors.
+//! @param count - number of buffers.
+//! @param thread_count - number of threads that will process chunks.
+//! @returns vector of chunk boundaries. Chunk i is the range of buffers
+//! [result[i], result[i + 1]). Vector is empty if there are no buffers.
+//! @throw std::bad_alloc if allocating vector fails.
+//! @details Creates up to parallel_chunks_per_thread chunks per thread,
+//! but each chunk has at least parallel_validate_min_chunk_size bytes,
+//! so small arrays produce a single chunk. Chunk boundaries are placed by
+//! number of bytes, so a few large buffers do not end up in one chunk.
+//!
+inline std::vector<size_t> flat_forward_list_split_buffers(flat_forward_list_buffer const *buffers,
+                                                           size_t count,
+                                                           size_t thread_count) {
+    std::vector<size_t> boundaries;
+    if (0 == count) {
+        return boundaries;
+    }
+    size_t total_size{ 0 };
+    for (size_t idx = 0; idx < count; ++idx) {
+        total_size += buffers[idx].size;
+    }
+    size_t const chunk_count{ std::max<size_t>(1,
+                                               std::min<size_t>({ thread_count * parallel_chunks_per_thread,
+                                                                  total_size / parallel_validate_min_chunk_size,
+                                                                  count })) };
+    boundaries.reserve(chunk_count + 1);
+    boundaries.push_back(0);
+    size_t prefix_size{ 0 };
+    for (size_t idx = 0; idx < count && boundaries.size() < chunk_count; ++idx) {
+        prefix_size += buffers[idx].size;
+        if (total_size * boundaries.size() <= prefix_size * chunk_count) {
+            boundaries.push_back(idx + 1);
+        }
+    }
+    if (boundaries.back() != count) {
+        boundaries.push_back(count);
+    }
+    return boundaries;
+}
+
+//!
+//! @brief Validates a range of buffers on the calling thread.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam F - type of the element validation functor.
+//! @param buffers - pointer to an array of buffer descriptors.
+//! @param first - index of the first buffer.
+//! @param end - index past the last buffer.
+//! @param results - pointer to an array of results. Result i is
+//! set to what flat_forward_list_validate returns for buffer i.
+//! @param validate_element_fn - functor used to validate each element.
+//! @details Prefetches next buffer while validating current one.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename F = default_validate_element_fn<T, TT>>
+void flat_forward_list_validate_buffers(flat_forward_list_buffer const *buffers,
+                                        size_t first,
+                                        size_t end,
+                                        flat_forward_list_validation_result<T, TT> *results,
+                                        F const &validate_element_fn = F{}) noexcept {
+    for (size_t idx = first; idx < end; ++idx) {
+        if (idx + 1 < end) {
+            FFL_PREFETCH(buffers[idx + 1].begin);
+        }
+        char const *const begin{ buffers[idx].begin };
+        auto const [is_valid, view] = flat_forward_list_validate<T, TT, F>(begin,
+                                                                            begin + buffers[idx].size,
+                                                                            validate_element_fn);
+        results[idx].is_valid = is_valid;
+        results[idx].view = view;
+    }
+}
+
+//!
+//! @brief Validates a batch of buffers on a set of worker threads.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam F - type of the element validation functor.
+//! @param buffers - pointer to an array of buffer descriptors.
+//! @param count - number of buffers.
+//! @param results - pointer to an array of count results. Result i
+//! is set to what flat_forward_list_validate returns for buffer i.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @param validate_element_fn - functor used to validate each element.
+//! @throw std::bad_alloc, std::system_error if starting a thread fails.
+//! @details Buffers are split with flat_forward_list_split_buffers,
+//! and each chunk is validated on one thread. While a buffer is
+//! validated, the next buffer is prefetched. Small batches are
+//! validated on the calling thread.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename F = default_validate_element_fn<T, TT>>
+void flat_forward_list_validate_batch(flat_forward_list_buffer const *buffers,
+                                      size_t count,
+                                      flat_forward_list_validation_result<T, TT> *results,
+                                      unsigned int concurrency = 0,
+                                      F const &validate_element_fn = F{}) {
+    if (0 == count) {
+        return;
+    }
+    FFL_CODDING_ERROR_IF(nullptr == buffers || nullptr == results);
+
+    unsigned int const thread_count{ parallel_concurrency(concurrency) };
+    std::vector<size_t> const boundaries{ flat_forward_list_split_buffers(buffers, count, thread_count) };
+    parallel_for_each_chunk(boundaries.size() - 1,
+                            thread_count,
+                            [buffers, results, &boundaries, &validate_element_fn](size_t chunk) noexcept {
+                                flat_forward_list_validate_buffers<T, TT, F>(buffers,
+                                                                             boundaries[chunk],
+                                                                             boundaries[chunk + 1],
+                                                                             results,
+                                                                             validate_element_fn);
+                            });
+}
+
+//!
+//! @brief Validates a batch of buffers on a set of worker threads.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @tparam F - type of the element validation functor.
+//! @param buffers - buffer descriptors.
+//! @param concurrency - maximum number of threads, including
+//! the calling thread. 0 means number of hardware threads.
+//! @param validate_element_fn - functor used to validate each element.
+//! @returns vector of results in the order of buffers.
+//! @throw std::bad_alloc, std::system_error if starting a thread fails.
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>,
+          typename F = default_validate_element_fn<T, TT>>
+std::vector<flat_forward_list_validation_result<T, TT>> flat_forward_list_validate_batch(std::vector<flat_forward_list_buffer> const &buffers,
+                                                                                         unsigned int concurrency = 0,
+                                                                                         F const &validate_element_fn = F{}) {
+    std::vector<flat_forward_list_validation_result<T, TT>> results(buffers.size());
+    flat_forward_list_validate_batch<T, TT, F>(buffers.data(),
+                                               buffers.size(),
+                                               results.data(),
+                                               concurrency,
+                                               validate_element_fn);
+    return results;
+}
+
+} // namespace iffl
@@ -0,0 +1,460 @@
+#pragma once
+
+//!
+//! @file iffl_shm_ring.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements a single producer, single consumer
+//!        ring buffer in shared memory that lets processes exchange
+//!        elements of a flat forward list without copying them.
+//!        This header depends on POSIX headers, and is not included by iffl.h.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+//!
+//! @brief Defined when platform supports shared memory ring
+//!
+#define FFL_HAS_SHM_RING 1
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @brief Header of the ring in the shared memory.
+//! @details Positions are logical offsets that only grow. Offset in
+//! the data area is position modulo capacity. Producer and consumer
+//! positions are kept on different cache lines.
+//!
+struct shm_ring_header {
+    //!
+    //! @brief Value that tells that header was initialized
+    //!
+    constexpr static uint64_t const expected_magic{ 0x676e69726c666669 };
+    //!
+    //! @brief Alignment of the header fields and of the data area
+    //!
+    constexpr static size_t const cache_line_size{ 64 };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "atomic used by processes must be lock free");
+
+    //!
+    //! @brief Set to expected_magic once header is initialized
+    //!
+    uint64_t magic{ expected_magic };
+    //!
+    //! @brief Size of the data area
+    //!
+    uint64_t capacity{ 0 };
+    //!
+    //! @brief Position after the last published element.
+    //! Modified by producer.
+    //!
+    alignas(cache_line_size) std::atomic<uint64_t> head{ 0 };
+    //!
+    //! @brief Skip marker. Position where producer stopped using the
+    //! data area because next element did not fit before its end, and
+    //! continued from the beginning of the data area.
+    //! Modified by producer.
+    //!
+    std::atomic<uint64_t> skip_begin{ std::numeric_limits<uint64_t>::max() };
+    //!
+    //! @brief Position of the first element that consumer did not
+    //! release yet. Modified by consumer.
+    //!
+    alignas(cache_line_size) std::atomic<uint64_t> tail{ 0 };
+};
+
+//!
+//! @class shm_flat_forward_list_ring
+//! @brief Single producer, single consumer ring buffer of flat
+//! forward list elements in POSIX shared memory.
+//! @tparam T - element type
+//! @tparam TT - element type traits
+//! @details Producer constructs elements directly in the shared memory
+//! with try_emplace_back. Elements are padded to the element alignment.
+//! If element type has offset to the next element then producer sets it
+//! to the padded element size, so elements that are next to each other
+//! always form a list. Once element is published producer never modifies
+//! it, so the last element that consumer sees has offset pointing past its
+//! end rather than 0.
+//!
+//! Consumer calls try_read to get a view over elements published since
+//! the last release. View points to the shared memory, so elements are not
+//! copied. Consumer calls release once it is done with the view, and only
+//! then producer can reuse that space.
+//!
+//! When an element does not fit before the end of the data area producer
+//! records skip marker in the header, and places element at the beginning
+//! of the data area. Consumer skips to the beginning of the data area when
+//! it reaches the skip marker. Because of that a view never wraps around,
+//! and a single published batch can be returned by two calls to try_read.
+//!
+//! One process creates the ring by passing name and capacity, and another
+//! process opens it by name. Each side must use its own object, and only
+//! call producer or consumer methods. Creator is responsible for
+//! removing the name with shm_flat_forward_list_ring::remove.
+//!
+//! Sample usage:
+//!
+//! @code
+//! <producer process>
+//! iffl::shm_flat_forward_list_ring<FLAT_FORWARD_LIST_TEST> ring{ "/my_ring", 1024 * 1024 };
+//! while (!ring.try_emplace_back(element_size, [](FLAT_FORWARD_LIST_TEST &e, size_t element_size) noexcept {
+//!                                                 <construct element>
+//!                                             })) {
+//!     <ring is full, wait for consumer>
+//! }
+//!
+//! <consumer process>
+//! iffl::shm_flat_forward_list_ring<FLAT_FORWARD_LIST_TEST> ring{ "/my_ring" };
+//! for (;;) {
+//!     auto const view{ ring.try_read() };
+//!     for (FLAT_FORWARD_LIST_TEST const &e : view) {
+//!         <process element>
+//!     }
+//!     ring.release();
+//! }
+//! @endcode
+//!
+template <typename T,
+          typename TT = flat_forward_list_traits<T>>
+class shm_flat_forward_list_ring final {
+public:
+    //!
+    //! @typedef size_type
+    //! @brief Size type
+    //!
+    using size_type = std::size_t;
+    //!
+    //! @typedef traits_traits
+    //! @brief Helper class that simplifies use of traits
+    //!
+    using traits_traits = flat_forward_list_traits_traits<T, TT>;
+    //!
+    //! @typedef view_type
+    //! @brief Type of view try_read returns
+    //!
+    using view_type = flat_forward_list_view<T, TT>;
+
+    static_assert(traits_traits::alignment <= shm_ring_header::cache_line_size,
+                  "element alignment is larger than alignment of the data area");
+
+    //!
+    //! @brief Creates shared memory object and initializes the ring.
+    //! @param name - name of the shared memory object. Must not exist.
+    //! @param capacity - size of the data area. Rounded up to the element
+    //! alignment. Largest element must fit in the data area.
+    //! @throw std::system_error if creating or mapping shared memory fails.
+    //!
+    shm_flat_forward_list_ring(char const *name, size_type capacity) {
+        capacity = traits_traits::roundup_to_alignment(capacity);
+        FFL_CODDING_ERROR_IF(0 == capacity);
+        int const fd{ shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR) };
+        if (fd < 0) {
+            throw std::system_error{ errno, std::generic_category(), "shm_open failed" };
+        }
+        auto close_fd{ make_scope_guard([fd]() noexcept {
+            close(fd);
+        }) };
+        auto remove_name{ make_scope_guard([name]() noexcept {
+            shm_unlink(name);
+        }) };
+        mapping_size_ = data_offset() + capacity;
+        if (0 != ftruncate(fd, static_cast<off_t>(mapping_size_))) {
+            throw std::system_error{ errno, std::generic_category(), "ftruncate failed" };
+        }
+        map(fd);
+        remove_name.disarm();
+        header_ = new (mapping_) shm_ring_header{};
+        header_->capacity = capacity;
+        capacity_ = capacity;
+    }
+
+    //!
+    //! @brief Opens ring created by another process.
+    //! @param name - name of the shared memory object.
+    //! @throw std::system_error if opening or mapping shared memory fails,
+    //! or if shared memory does not contain a ring.
+    //!
+    explicit shm_flat_forward_list_ring(char const *name) {
+        int const fd{ shm_open(name, O_RDWR, 0) };
+        if (fd < 0) {
+            throw std::system_error{ errno, std::generic_category(), "shm_open failed" };
+        }
+        auto close_fd{ make_scope_guard([fd]() noexcept {
+            close(fd);
+        }) };
+        struct stat st {};
+        if (0 != fstat(fd, &st)) {
+            throw std::system_error{ errno, std::generic_category(), "fstat failed" };
+        }
+        mapping_size_ = static_cast<size_type>(st.st_size);
+        if (mapping_size_ <= data_offset()) {
+            throw std::system_error{ EINVAL, std::generic_category(), "shared memory does not contain a ring" };
+        }
+        map(fd);
+        header_ = static_cast<shm_ring_header *>(mapping_);
+        capacity_ = static_cast<size_type>(header_->capacity);
+        if (shm_ring_header::expected_magic != header_->magic ||
+            mapping_size_ != data_offset() + capacity_) {
+            unmap();
+            throw std::system_error{ EINVAL, std::generic_category(), "shared memory does not contain a ring" };
+        }
+        cached_head_ = header_->head.load(std::memory_order_acquire);
+        cached_tail_ = header_->tail.load(std::memory_order_acquire);
+    }
+
+    shm_flat_forward_list_ring(shm_flat_forward_list_ring const &) = delete;
+    shm_flat_forward_list_ring &operator=(shm_flat_forward_list_ring const &) = delete;
+
+    //!
+    //! @brief Unmaps shared memory
+    //!
+    ~shm_flat_forward_list_ring() noexcept {
+        unmap();
+    }
+
+    //!
+    //! @brief Removes name of the shared memory object.
+    //! @param name - name of the shared memory object.
+    //! @return 0 on success, and errno value on failure.
+    //!
+    static int remove(char const *name) noexcept {
+        return 0 == shm_unlink(name) ? 0 : errno;
+    }
+
+    //!
+    //! @returns size of the data area
+    //!
+    size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    //!
+    //! @brief Producer constructs new element in the ring if ring
+    //! has enough free space, and publishes it.
+    //! @tparam F - type of a functor
+    //! @param element_size - number of bytes required for the new element.
+    //! @param fn - a functor used to construct new element.
+    //! Functor must not throw.
+    //! @returns true if element was published, and false if ring does
+    //! not have enough free space.
+    //!
+    template <typename F>
+    [[nodiscard]] bool try_emplace_back(size_type element_size,
+                                        F const &fn) noexcept {
+        FFL_CODDING_ERROR_IF(element_size < traits_traits::minimum_size());
+        size_type const reserved_size{ traits_traits::roundup_to_alignment(element_size) };
+        FFL_CODDING_ERROR_IF(capacity_ < reserved_size);
+
+        uint64_t const head{ cached_head_ };
+        uint64_t position{ head };
+        size_type const offset{ static_cast<size_type>(head % capacity_) };
+        bool const wraps{ capacity_ - offset < reserved_size };
+        if (wraps) {
+            position += capacity_ - offset;
+        }
+        if (!has_free_space(position + reserved_size)) {
+            return false;
+        }
+
+        char *cur{ data() + (position % capacity_) };
+        fn(*traits_traits::ptr_to_t(cur), element_size);
+        size_with_padding_t const cur_element_size{ traits_traits::get_size(cur) };
+        FFL_CODDING_ERROR_IF(element_size < cur_element_size.size);
+        if constexpr (traits_traits::has_next_offset_v) {
+            traits_traits::set_next_offset(cur, cur_element_size.size_padded());
+        }
+
+        if (wraps) {
+            header_->skip_begin.store(head, std::memory_order_relaxed);
+        }
+        cached_head_ = position + cur_element_size.size_padded();
+        header_->head.store(cached_head_, std::memory_order_release);
+        return true;
+    }
+
+    //!
+    //! @brief Producer copies element to the ring if ring
+    //! has enough free space, and publishes it.
+    //! @param init_buffer_size - number of bytes to copy.
+    //! @param init_buffer - buffer with element data.
+    //! @returns true if element was published, and false if ring does
+    //! not have enough free space.
+    //!
+    [[nodiscard]] bool try_push_back(size_type init_buffer_size,
+                                     char const *init_buffer) noexcept {
+        return try_emplace_back(init_buffer_size,
+                                [init_buffer_size, init_buffer](T &buffer,
+                                                                size_type element_size) noexcept {
+                                    FFL_CODDING_ERROR_IF_NOT(init_buffer_size == element_size);
+                                    copy_data(reinterpret_cast<char *>(&buffer), init_buffer, element_size);
+                                });
+    }
+
+    //!
+    //! @brief Consumer returns view over published elements that
+    //! were not released yet.
+    //! @returns view over elements in the shared memory. View is empty
+    //! if there are no published elements.
+    //! @details View stays valid until release is called. Calling
+    //! try_read again without release returns the same elements, and
+    //! elements that were published since then if they follow in the
+    //! data area.
+    //!
+    view_type try_read() noexcept {
+        uint64_t tail{ header_->tail.load(std::memory_order_relaxed) };
+        if (tail == cached_head_) {
+            cached_head_ = header_->head.load(std::memory_order_acquire);
+            if (tail == cached_head_) {
+                return view_type{};
+            }
+        }
+        //
+        // Producer does not write skip marker for the next lap before
+        // we release elements past this skip marker, so skip marker
+        // is either ahead of us or stale
+        //
+        uint64_t const skip_begin{ header_->skip_begin.load(std::memory_order_relaxed) };
+        if (tail == skip_begin) {
+            tail += capacity_ - (tail % capacity_);
+            header_->tail.store(tail, std::memory_order_release);
+        }
+        uint64_t segment_end{ std::min<uint64_t>(cached_head_, tail - (tail % capacity_) + capacity_) };
+        if (tail < skip_begin && skip_begin < segment_end) {
+            segment_end = skip_begin;
+        }
+
+        char *begin{ data() + (tail % capacity_) };
+        char *end{ begin + (segment_end - tail) };
+        char *last{ begin };
+        for (char *cur = begin; cur < end; cur += traits_traits::get_size(cur).size_padded()) {
+            last = cur;
+        }
+        read_size_ = static_cast<size_type>(end - begin);
+        return view_type{ begin, last, end };
+    }
+
+    //!
+    //! @brief Consumer releases elements returned by the last try_read,
+    //! so producer can reuse that space.
+    //!
+    void release() noexcept {
+        if (read_size_) {
+            uint64_t const tail{ header_->tail.load(std::memory_order_relaxed) };
+            header_->tail.store(tail + read_size_, std::memory_order_release);
+            read_size_ = 0;
+        }
+    }
+
+private:
+    //!
+    //! @typedef size_with_padding_t
+    //! @brief Size of element with padding
+    //!
+    using size_with_padding_t = typename traits_traits::size_with_padding_t;
+
+    //!
+    //! @returns offset of the data area in the shared memory
+    //!
+    constexpr static size_type data_offset() noexcept {
+        return roundup_size_to_alignment(sizeof(shm_ring_header), shm_ring_header::cache_line_size);
+    }
+
+    //!
+    //! @returns pointer to the data area
+    //!
+    char *data() const noexcept {
+        return static_cast<char *>(mapping_) + data_offset();
+    }
+
+    //!
+    //! @brief Checks if producer can use space up to the position.
+    //! @param end_position - position after the new element.
+    //! @returns true if consumer released enough space.
+    //!
+    bool has_free_space(uint64_t end_position) noexcept {
+        if (end_position - cached_tail_ <= capacity_) {
+            return true;
+        }
+        cached_tail_ = header_->tail.load(std::memory_order_acquire);
+        return end_position - cached_tail_ <= capacity_;
+    }
+
+    //!
+    //! @brief Maps shared memory object
+    //! @param fd - shared memory object file descriptor
+    //! @throw std::system_error if mmap fails.
+    //!
+    void map(int fd) {
+        void *mapping{ mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+        if (MAP_FAILED == mapping) {
+            throw std::system_error{ errno, std::generic_category(), "mmap failed" };
+        }
+        mapping_ = mapping;
+    }
+
+    //!
+    //! @brief Unmaps shared memory object
+    //!
+    void unmap() noexcept {
+        if (mapping_) {
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            header_ = nullptr;
+        }
+    }
+
+    //!
+    //! @brief Address of the mapped shared memory object.
+    //!
+    void *mapping_{ nullptr };
+    //!
+    //! @brief Size of the mapping. Header followed by the data area.
+    //!
+    size_type mapping_size_{ 0 };
+    //!
+    //! @brief Header at the beginning of the mapping.
+    //!
+    shm_ring_header *header_{ nullptr };
+    //!
+    //! @brief Size of the data area.
+    //!
+    size_type capacity_{ 0 };
+    //!
+    //! @brief Producer's copy of head. Consumer's last observed head.
+    //!
+    uint64_t cached_head_{ 0 };
+    //!
+    //! @brief Producer's last observed tail.
+    //!
+    uint64_t cached_tail_{ 0 };
+    //!
+    //! @brief Size of the data returned by the last try_read.
+    //!
+    size_type read_size_{ 0 };
+};
+
+} // namespace iffl
+
+#endif
@@ -0,0 +1,1013 @@
+#pragma once
+
+//!
+//! @file iffl_small_list.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements small_flat_forward_list, a
+//!        flat_forward_list that keeps up to N bytes of elements
+//!        in the storage inside of the container.
+//!
+//! @details Most lists are short, and allocating buffer for each
+//!          of them costs more than building the list.
+//!          small_flat_forward_list starts with a buffer that
+//!          is a part of the container, and calls allocator only
+//!          when elements do not fit in this buffer.
+//!
+//!          small_flat_forward_list keeps elements in a flat_forward_list
+//!          member, and forwards all its methods. Container passes
+//!          inline_buffer_allocator to the flat_forward_list. This
+//!          allocator returns inline buffer when it is not used yet,
+//!          and forwards all other allocations to the allocator A.
+//!
+//!          Methods that move buffer ownership between containers
+//!          are redefined, because inline buffer cannot change owner:
+//!          - move constructor and move assignment copy elements
+//!            when they are in the inline buffer, and take ownership
+//!            of the buffer otherwise.
+//!          - detach copies elements to a buffer allocated with
+//!            allocator A when they are in the inline buffer.
+//!            Caller must free returned buffer using allocator A.
+//!          - swap is implemented using move constructor and move
+//!            assignment.
+//!          - assign, sort, reverse, and merge build a new list, and
+//!            swap with it. New list cannot use inline buffer while
+//!            container owns it, so elements that fit are moved back
+//!            to the inline buffer when the method completes.
+//!
+//! @code
+//! iffl::small_flat_forward_list<FILE_FULL_EA_INFORMATION, 256> eas;
+//! eas.emplace_back(...); // no allocation
+//! @endcode
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @class flat_forward_list_inline_buffer
+//! @brief Describes inline buffer of small_flat_forward_list,
+//! and tracks if container uses it.
+//!
+class flat_forward_list_inline_buffer {
+public:
+    //!
+    //! @brief Constructor
+    //! @param begin - pointer to the buffer
+    //! @param size - buffer size
+    //!
+    flat_forward_list_inline_buffer(char *begin, size_t size) noexcept
+        : begin_{ begin }
+        , size_{ size } {
+    }
+    //!
+    //! @brief Inline buffer is owned by container, and cannot be copied.
+    //!
+    flat_forward_list_inline_buffer(flat_forward_list_inline_buffer const &) = delete;
+    //!
+    //! @brief Inline buffer is owned by container, and cannot be copied.
+    //!
+    flat_forward_list_inline_buffer &operator= (flat_forward_list_inline_buffer const &) = delete;
+    //!
+    //! @brief Destructor. Makes sure that buffer is not in use.
+    //!
+    ~flat_forward_list_inline_buffer() noexcept {
+        FFL_CODDING_ERROR_IF(busy_);
+    }
+    //!
+    //! @brief Returns inline buffer if it is not in use
+    //! and it is large enough.
+    //! @param size - size of the buffer caller needs.
+    //! @returns pointer to the inline buffer or nullptr.
+    //!
+    [[nodiscard]] char *try_allocate(size_t size) noexcept {
+        if (busy_ || size > size_) {
+            return nullptr;
+        }
+        busy_ = true;
+        return begin_;
+    }
+    //!
+    //! @brief Marks buffer as not used if ptr points to inline buffer.
+    //! @param ptr - buffer that is deallocated.
+    //! @returns true if ptr is inline buffer, and false otherwise.
+    //!
+    [[nodiscard]] bool try_deallocate(char *ptr) noexcept {
+        if (begin_ != ptr) {
+            return false;
+        }
+        FFL_CODDING_ERROR_IF_NOT(busy_);
+        busy_ = false;
+        return true;
+    }
+    //!
+    //! @returns true if ptr points to the inline buffer.
+    //!
+    bool contains(char const *ptr) const noexcept {
+        return begin_ == ptr;
+    }
+    //!
+    //! @returns true if inline buffer is in use.
+    //!
+    bool is_busy() const noexcept {
+        return busy_;
+    }
+    //!
+    //! @returns pointer to inline buffer.
+    //!
+    char *data() const noexcept {
+        return begin_;
+    }
+    //!
+    //! @returns inline buffer size.
+    //!
+    size_t size() const noexcept {
+        return size_;
+    }
+
+private:
+    //!
+    //! @brief Pointer to the buffer
+    //!
+    char *begin_{ nullptr };
+    //!
+    //! @brief Buffer size
+    //!
+    size_t size_{ 0 };
+    //!
+    //! @brief True when container uses inline buffer
+    //!
+    bool busy_{ false };
+};
+
+//!
+//! @class inline_buffer_allocator
+//! @brief Allocator used by small_flat_forward_list.
+//! @tparam A - allocator used when inline buffer is in use
+//! or is too small.
+//! @details Instances that point to the same inline buffer
+//! and have equal allocators A are equal.
+//! Allocator that does not point to inline buffer always uses A.
+//!
+template <typename A>
+class inline_buffer_allocator {
+public:
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator used when inline buffer cannot be used.
+    //!
+    using allocator_type = A;
+    //!
+    //! @typedef allocator_type_traits
+    //! @brief Traits of allocator_type
+    //!
+    using allocator_type_traits = std::allocator_traits<allocator_type>;
+    //!
+    //! @typedef value_type
+    //! @brief Containers use buffer of chars.
+    //!
+    using value_type = char;
+
+    static_assert(std::is_same_v<typename allocator_type_traits::value_type, char>,
+                  "allocator must allocate buffers of chars");
+    //!
+    //! @typedef propagate_on_container_copy_assignment
+    //! @brief Copy keeps allocator that points to own inline buffer.
+    //!
+    using propagate_on_container_copy_assignment = std::false_type;
+    //!
+    //! @typedef propagate_on_container_move_assignment
+    //! @brief Only containers that share inline buffer exchange
+    //! allocators.
+    //!
+    using propagate_on_container_move_assignment = std::true_type;
+    //!
+    //! @typedef propagate_on_container_swap
+    //! @brief Only containers that share inline buffer exchange
+    //! allocators.
+    //!
+    using propagate_on_container_swap = std::true_type;
+    //!
+    //! @typedef is_always_equal
+    //! @brief Allocators that point to different inline buffers
+    //! are not equal.
+    //!
+    using is_always_equal = std::false_type;
+    //!
+    //! @struct rebind
+    //! @brief Containers use only buffers of chars
+    //!
+    template <typename U>
+    struct rebind {
+        static_assert(std::is_same_v<U, char>,
+                      "inline_buffer_allocator allocates only buffers of chars");
+        //!
+        //! @typedef other
+        //! @brief Same allocator type
+        //!
+        using other = inline_buffer_allocator;
+    };
+    //!
+    //! @brief Constructor
+    //! @param inline_buffer - inline buffer or nullptr
+    //! @param a - allocator used when inline buffer cannot be used
+    //!
+    inline_buffer_allocator(flat_forward_list_inline_buffer *inline_buffer,
+                            allocator_type const &a) noexcept
+        : inline_buffer_{ inline_buffer }
+        , allocator_{ a } {
+    }
+    //!
+    //! @brief Copy constructor
+    //!
+    inline_buffer_allocator(inline_buffer_allocator const &) = default;
+    //!
+    //! @brief Assignment operator
+    //! @param other - allocator we are copying from
+    //! @details Containers exchange allocators only when
+    //! allocator_type instances are equal, so we only need to
+    //! copy inline buffer pointer. This also allows using
+    //! allocators that cannot be assigned, like polymorphic_allocator.
+    //!
+    inline_buffer_allocator &operator= (inline_buffer_allocator const &other) noexcept {
+        FFL_CODDING_ERROR_IF_NOT(allocator_ == other.allocator_);
+        inline_buffer_ = other.inline_buffer_;
+        return *this;
+    }
+    //!
+    //! @brief Allocates inline buffer if it is not in use, and
+    //! is large enough, otherwise uses allocator_type.
+    //! @param size - buffer size
+    //! @returns pointer to the buffer
+    //! @throws std::bad_alloc if allocator_type fails
+    //!
+    [[nodiscard]] char *allocate(size_t size) {
+        if (inline_buffer_) {
+            char *const ptr{ inline_buffer_->try_allocate(size) };
+            if (ptr) {
+                return ptr;
+            }
+        }
+        return allocator_type_traits::allocate(allocator_, size);
+    }
+    //!
+    //! @brief Deallocates buffer
+    //! @param ptr - pointer to the buffer
+    //! @param size - buffer size
+    //!
+    void deallocate(char *ptr, size_t size) noexcept {
+        if (inline_buffer_ && inline_buffer_->try_deallocate(ptr)) {
+            return;
+        }
+        allocator_type_traits::deallocate(allocator_, ptr, size);
+    }
+    //!
+    //! @brief Copy of allocator for a new container
+    //! does not point to inline buffer.
+    //!
+    inline_buffer_allocator select_on_container_copy_construction() const {
+        return inline_buffer_allocator{ nullptr,
+                                        allocator_type_traits::select_on_container_copy_construction(allocator_) };
+    }
+    //!
+    //! @returns inline buffer or nullptr
+    //!
+    flat_forward_list_inline_buffer *get_inline_buffer() const noexcept {
+        return inline_buffer_;
+    }
+    //!
+    //! @returns reference to allocator used when inline buffer
+    //! cannot be used
+    //!
+    allocator_type const &get_allocator() const noexcept {
+        return allocator_;
+    }
+    //!
+    //! @returns true if allocators point to the same inline buffer,
+    //! and allocator_type instances are equal.
+    //!
+    friend bool operator== (inline_buffer_allocator const &lhs,
+                            inline_buffer_allocator const &rhs) noexcept {
+        return lhs.inline_buffer_ == rhs.inline_buffer_ &&
+               lhs.allocator_ == rhs.allocator_;
+    }
+    //!
+    //! @returns false if allocators point to the same inline buffer,
+    //! and allocator_type instances are equal.
+    //!
+    friend bool operator!= (inline_buffer_allocator const &lhs,
+                            inline_buffer_allocator const &rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    //!
+    //! @brief Inline buffer or nullptr
+    //!
+    flat_forward_list_inline_buffer *inline_buffer_{ nullptr };
+    //!
+    //! @brief Allocator used when inline buffer cannot be used
+    //!
+    allocator_type allocator_;
+};
+
+//!
+//! @class small_flat_forward_list_storage
+//! @brief Inline buffer of small_flat_forward_list.
+//! @tparam N - buffer size in bytes.
+//! @details It is a base class of small_flat_forward_list, so it
+//! is constructed before and destroyed after flat_forward_list.
+//!
+template <size_t N>
+class small_flat_forward_list_storage {
+    static_assert(N > 0, "inline buffer cannot be empty");
+protected:
+    //!
+    //! @brief Constructor
+    //!
+    small_flat_forward_list_storage() noexcept
+        : inline_buffer_{ storage_, N } {
+    }
+    //!
+    //! @brief Inline buffer
+    //!
+    alignas(std::max_align_t) char storage_[N];
+    //!
+    //! @brief Tracks if inline buffer is in use
+    //!
+    flat_forward_list_inline_buffer inline_buffer_;
+};
+
+//!
+//! @class small_flat_forward_list
+//! @brief flat_forward_list with inline buffer of N bytes.
+//! @tparam T - element type
+//! @tparam N - size of the inline buffer in bytes
+//! @tparam TT - element type traits
+//! @tparam A - allocator that is used when elements
+//! do not fit in the inline buffer
+//! @details Empty container always owns inline buffer, so
+//! its capacity is N. When container needs a larger buffer it
+//! allocates it using A, and releases inline buffer.
+//! When elements fit in the inline buffer again, resize_buffer,
+//! shrink_to_fit, and methods that rebuild the list, like sort,
+//! move them back to the inline buffer.
+//!
+template <typename T,
+          size_t N,
+          typename TT = flat_forward_list_traits<T>,
+          typename A = std::allocator<T>>
+class small_flat_forward_list final
+    : private small_flat_forward_list_storage<N> {
+public:
+    //!
+    //! @typedef list_type
+    //! @brief Type of the container that keeps elements
+    //!
+    using list_type = flat_forward_list<T,
+                                        TT,
+                                        inline_buffer_allocator<typename std::allocator_traits<A>::template rebind_alloc<char>>>;
+    //!
+    //! @typedef storage
+    //! @brief Type of the base class that owns inline buffer
+    //!
+    using storage = small_flat_forward_list_storage<N>;
+    //!
+    //! @typedef allocator_type
+    //! @brief Type of allocator passed to flat_forward_list
+    //!
+    using allocator_type = typename list_type::allocator_type;
+    //!
+    //! @typedef heap_allocator_type
+    //! @brief Type of allocator used when inline buffer cannot be used
+    //!
+    using heap_allocator_type = typename allocator_type::allocator_type;
+    //!
+    //! @typedef heap_allocator_type_traits
+    //! @brief Traits of heap_allocator_type
+    //!
+    using heap_allocator_type_traits = std::allocator_traits<heap_allocator_type>;
+
+    using value_type = typename list_type::value_type;
+    using pointer = typename list_type::pointer;
+    using const_pointer = typename list_type::const_pointer;
+    using reference = typename list_type::reference;
+    using const_reference = typename list_type::const_reference;
+    using size_type = typename list_type::size_type;
+    using difference_type = typename list_type::difference_type;
+    using traits = typename list_type::traits;
+    using traits_traits = typename list_type::traits_traits;
+    using range_t = typename list_type::range_t;
+    using size_with_padding_t = typename list_type::size_with_padding_t;
+    using buffer_value_type = typename list_type::buffer_value_type;
+    using const_buffer_value_type = typename list_type::const_buffer_value_type;
+    using buffer_pointer = typename list_type::buffer_pointer;
+    using const_buffer_pointer = typename list_type::const_buffer_pointer;
+    using iterator = typename list_type::iterator;
+    using const_iterator = typename list_type::const_iterator;
+    constexpr static size_type const npos{ list_type::npos };
+    //!
+    //! @brief Size of inline buffer
+    //!
+    constexpr static size_t const inline_capacity{ N };
+    //!
+    //! @brief Default constructor
+    //!
+    small_flat_forward_list() noexcept
+        : list_{ allocator_type{ &this->inline_buffer_, heap_allocator_type{} } } {
+        use_inline_buffer();
+    }
+    //!
+    //! @brief Constructs an empty container with an instance of
+    //! provided allocator
+    //! @param a - allocator used when inline buffer cannot be used
+    //!
+    explicit small_flat_forward_list(heap_allocator_type const &a) noexcept
+        : list_{ allocator_type{ &this->inline_buffer_, a } } {
+        use_inline_buffer();
+    }
+    //!
+    //! @brief Copy constructor
+    //! @param other - container we are copying from
+    //! @throw std::bad_alloc if elements do not fit in the inline
+    //! buffer, and buffer allocation fails
+    //!
+    small_flat_forward_list(small_flat_forward_list const &other)
+        : list_{ allocator_type{ &this->inline_buffer_,
+                                 heap_allocator_type_traits::select_on_container_copy_construction(other.get_heap_allocator()) } } {
+        use_inline_buffer();
+        copy_from(other);
+    }
+    //!
+    //! @brief Move constructor
+    //! @param other - container we are moving from
+    //! @details Elements are copied if they are in the other
+    //! container's inline buffer. Otherwise container takes
+    //! ownership of the other container's buffer.
+    //!
+    small_flat_forward_list(small_flat_forward_list &&other) noexcept
+        : list_{ allocator_type{ &this->inline_buffer_, other.get_heap_allocator() } } {
+        use_inline_buffer();
+        move_from(std::move(other));
+    }
+    //!
+    //! @brief Destructor.
+    //! @details flat_forward_list deallocates buffer before
+    //! inline buffer is destroyed.
+    //!
+    ~small_flat_forward_list() noexcept = default;
+    //!
+    //! @brief Copy assignment operator
+    //! @param other - container we are copying from
+    //! @throw std::bad_alloc if elements do not fit in the inline
+    //! buffer, and buffer allocation fails
+    //!
+    small_flat_forward_list &operator= (small_flat_forward_list const &other) {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+    //!
+    //! @brief Move assignment operator
+    //! @param other - container we are moving from
+    //! @throw std::bad_alloc if elements are in heap buffer, allocators
+    //! are not equal, and buffer allocation fails
+    //! @details Elements are copied if they are in the other
+    //! container's inline buffer, or if heap allocators are
+    //! not equal. Otherwise container takes ownership of the other
+    //! container's buffer.
+    //!
+    small_flat_forward_list &operator= (small_flat_forward_list &&other) noexcept (heap_allocator_type_traits::is_always_equal::value) {
+        if (this != &other) {
+            if (other.get_heap_allocator() == get_heap_allocator()) {
+                move_from(std::move(other));
+            } else {
+                copy_from(other);
+            }
+        }
+        return *this;
+    }
+    //!
+    //! @brief Copies list from a buffer
+    //! @param other_buff - describes the other buffer.
+    //! @throw std::bad_alloc if buffer allocation fails
+    //!
+    small_flat_forward_list &operator= (buffer_view const &other_buff) {
+        assign(other_buff);
+        return *this;
+    }
+    //!
+    //! @brief Swaps content of two containers
+    //! @param other - other container
+    //! @throw std::bad_alloc if heap allocators are not equal
+    //! and buffer allocation fails
+    //!
+    void swap(small_flat_forward_list &other) {
+        small_flat_forward_list tmp{ std::move(other) };
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+    //!
+    //! @brief Erases all elements.
+    //! @details After this call container owns inline buffer.
+    //!
+    void clear() noexcept {
+        list_.clear();
+        use_inline_buffer();
+    }
+    //!
+    //! @brief Container releases ownership of the buffer.
+    //! @details After the call completes, container is empty.
+    //! When elements are in the inline buffer they are copied to
+    //! a buffer allocated with heap allocator.
+    //! @return Returns buffer information to the caller.
+    //! Caller is responsible for deallocating returned buffer
+    //! using heap allocator.
+    //! @throw std::bad_alloc if allocating buffer fails
+    //!
+    buffer_ref detach() {
+        buffer_ref tmp{};
+        if (is_inline()) {
+            if (!empty()) {
+                heap_allocator_type a{ get_heap_allocator() };
+                size_type const used_capacity{ this->used_capacity() };
+                tmp.begin = heap_allocator_type_traits::allocate(a, used_capacity);
+                copy_data(tmp.begin, list_.buff().begin, used_capacity);
+                tmp.last = tmp.begin + (list_.buff().last - list_.buff().begin);
+                tmp.end = tmp.begin + used_capacity;
+            }
+            clear();
+        } else {
+            tmp = list_.detach();
+            use_inline_buffer();
+        }
+        return tmp;
+    }
+    //!
+    //! @brief Copies elements to the container.
+    //! @tparam P - types of the parameters
+    //! @param p - parameters of one of flat_forward_list::assign
+    //! overloads.
+    //! @returns result of flat_forward_list::assign
+    //! @throw std::bad_alloc if allocating buffer fails
+    //! @details flat_forward_list builds a new list, and swaps
+    //! with it. New list cannot use inline buffer while container
+    //! owns it, so elements that fit are moved back to the
+    //! inline buffer.
+    //!
+    template <typename... P>
+    decltype(auto) assign(P &&... p) {
+        auto use_inline_buffer_on_exit{ make_scope_guard([this]() noexcept {
+            try_use_inline_buffer();
+        }) };
+        return list_.assign(std::forward<P>(p)...);
+    }
+    //!
+    //! @brief Sorts elements of the list
+    //! @tparam LESS_F - type of the comparison functor
+    //! @param fn - comparison functor
+    //! @throw std::bad_alloc if allocating buffer fails
+    //! @details Elements that fit stay in the inline buffer.
+    //!
+    template <typename LESS_F>
+    void sort(LESS_F const &fn) {
+        auto use_inline_buffer_on_exit{ make_scope_guard([this]() noexcept {
+            try_use_inline_buffer();
+        }) };
+        list_.sort(fn);
+    }
+    //!
+    //! @brief Reverses elements of the list
+    //! @throw std::bad_alloc if allocating buffer fails
+    //! @details Elements that fit stay in the inline buffer.
+    //!
+    void reverse() {
+        auto use_inline_buffer_on_exit{ make_scope_guard([this]() noexcept {
+            try_use_inline_buffer();
+        }) };
+        list_.reverse();
+    }
+    //!
+    //! @brief Merges two lists ordering elements using comparison functor
+    //! @tparam F - type of the comparison functor
+    //! @param other - the other list we are merging with.
+    //! After the call it is empty, and owns its inline buffer.
+    //! @param fn - comparison functor
+    //! @throw std::bad_alloc if allocating buffer fails
+    //! @details Elements that fit stay in the inline buffer.
+    //!
+    template <typename F>
+    void merge(small_flat_forward_list &other, F const &fn) {
+        auto use_inline_buffer_on_exit{ make_scope_guard([this, &other]() noexcept {
+            try_use_inline_buffer();
+            other.try_use_inline_buffer();
+        }) };
+        list_.merge(other.list_, fn);
+    }
+    //!
+    //! @brief Resizes buffer.
+    //! @param size - new buffer size
+    //! @throw std::bad_alloc if allocating new buffer fails
+    //! @details Elements stay in the inline buffer while buffer
+    //! size does not exceed inline buffer size. If elements are in
+    //! heap buffer, and new size fits inline buffer then elements
+    //! move back to the inline buffer.
+    //!
+    void resize_buffer(size_type size) {
+        if (0 == size) {
+            clear();
+        } else if (size <= N) {
+            if (!is_inline() || size < used_capacity()) {
+                list_.resize_buffer(size);
+            }
+            try_use_inline_buffer();
+        } else {
+            list_.resize_buffer(size);
+        }
+    }
+    //!
+    //! @brief Resizes buffer to the used capacity.
+    //! @throw std::bad_alloc if allocating new buffer fails
+    //!
+    void tail_shrink_to_fit() {
+        resize_buffer(used_capacity());
+    }
+    //!
+    //! @brief Removes unused padding of each element, and
+    //! resizes buffer to the used capacity.
+    //! @throw std::bad_alloc if allocating new buffer fails
+    //!
+    void shrink_to_fit() {
+        list_.shrink_to_fit(list_.begin(), list_.end());
+        tail_shrink_to_fit();
+    }
+    //!
+    //! @returns true if elements are in the inline buffer.
+    //!
+    bool is_inline() const noexcept {
+        return this->inline_buffer_.contains(list_.buff().begin);
+    }
+    //!
+    //! @returns allocator passed to flat_forward_list.
+    //!
+    allocator_type const &get_allocator() const noexcept {
+        return list_.get_allocator();
+    }
+    //!
+    //! @returns allocator used when inline buffer cannot be used.
+    //!
+    heap_allocator_type const &get_heap_allocator() const noexcept {
+        return get_allocator().get_allocator();
+    }
+    //!
+    //! @name Methods of flat_forward_list
+    //! @brief Container forwards these methods to flat_forward_list.
+    //! See flat_forward_list for their description.
+    //! @{
+    //!
+    template <typename... P>
+    decltype(auto) attach(P &&... p) {
+        return list_.attach(std::forward<P>(p)...);
+    }
+    template <typename AA>
+    [[nodiscard]] bool is_compatible_allocator(AA const &other_allocator) const noexcept {
+        return list_.is_compatible_allocator(other_allocator);
+    }
+    size_type max_size() const noexcept {
+        return list_.max_size();
+    }
+    template <typename... P>
+    void push_back(P &&... p) {
+        list_.push_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_push_back(P &&... p) {
+        return list_.try_push_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    void emplace_back(P &&... p) {
+        list_.emplace_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace_back(P &&... p) {
+        return list_.try_emplace_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    iterator insert(P &&... p) {
+        return list_.insert(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_insert(P &&... p) {
+        return list_.try_insert(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    iterator emplace(P &&... p) {
+        return list_.emplace(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace(P &&... p) {
+        return list_.try_emplace(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    void push_front(P &&... p) {
+        list_.push_front(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_push_front(P &&... p) {
+        return list_.try_push_front(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    void emplace_front(P &&... p) {
+        list_.emplace_front(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace_front(P &&... p) {
+        return list_.try_emplace_front(std::forward<P>(p)...);
+    }
+    iterator element_add_size(iterator const &it, size_type size_to_add) {
+        return list_.element_add_size(it, size_to_add);
+    }
+    [[nodiscard]] bool try_element_add_size(iterator const &it, size_type size_to_add) {
+        return list_.try_element_add_size(it, size_to_add);
+    }
+    template <typename F>
+    iterator element_resize(iterator const &it, size_type new_size, F const &fn) {
+        return list_.element_resize(it, new_size, fn);
+    }
+    template <typename F>
+    [[nodiscard]] bool try_element_resize(iterator const &it, size_type new_size, F const &fn) {
+        return list_.try_element_resize(it, new_size, fn);
+    }
+    void shrink_to_fit(iterator const &first, iterator const &end) {
+        list_.shrink_to_fit(first, end);
+    }
+    void shrink_to_fit(iterator const &it) {
+        list_.shrink_to_fit(it);
+    }
+    void pop_back() noexcept {
+        list_.pop_back();
+    }
+    void pop_front() noexcept {
+        list_.pop_front();
+    }
+    void erase_after(iterator const &it) noexcept {
+        list_.erase_after(it);
+    }
+    void erase_after_half_closed(iterator const &before_start, iterator const &last) noexcept {
+        list_.erase_after_half_closed(before_start, last);
+    }
+    void erase_all_after(iterator const &it) noexcept {
+        list_.erase_all_after(it);
+    }
+    iterator erase_all_from(iterator const &it) noexcept {
+        return list_.erase_all_from(it);
+    }
+    void erase_all() noexcept {
+        list_.erase_all();
+    }
+    iterator erase(iterator const &it) noexcept {
+        return list_.erase(it);
+    }
+    iterator erase(iterator const &start, iterator const &end) noexcept {
+        return list_.erase(start, end);
+    }
+    template <typename F>
+    void unique(F const &fn) noexcept {
+        list_.unique(fn);
+    }
+    template <typename F>
+    void remove_if(F const &fn) noexcept {
+        list_.remove_if(fn);
+    }
+    T &front() noexcept {
+        return list_.front();
+    }
+    T const &front() const noexcept {
+        return list_.front();
+    }
+    T &back() noexcept {
+        return list_.back();
+    }
+    T const &back() const noexcept {
+        return list_.back();
+    }
+    iterator begin() noexcept {
+        return list_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return list_.begin();
+    }
+    iterator last() noexcept {
+        return list_.last();
+    }
+    const_iterator last() const noexcept {
+        return list_.last();
+    }
+    iterator end() noexcept {
+        return list_.end();
+    }
+    const_iterator end() const noexcept {
+        return list_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return list_.cbegin();
+    }
+    const_iterator clast() const noexcept {
+        return list_.clast();
+    }
+    const_iterator cend() const noexcept {
+        return list_.cend();
+    }
+    char *data() noexcept {
+        return list_.data();
+    }
+    char const *data() const noexcept {
+        return list_.data();
+    }
+    [[nodiscard]] bool revalidate_data(size_type data_size = npos) noexcept {
+        return list_.revalidate_data(data_size);
+    }
+    size_type required_size(const_iterator const &it) const noexcept {
+        return list_.required_size(it);
+    }
+    size_type used_size(const_iterator const &it) const noexcept {
+        return list_.used_size(it);
+    }
+    range_t range(const_iterator const &it) const noexcept {
+        return list_.range(it);
+    }
+    range_t closed_range(const_iterator const &begin, const_iterator const &last) const noexcept {
+        return list_.closed_range(begin, last);
+    }
+    range_t half_open_range(const_iterator const &begin, const_iterator const &end) const noexcept {
+        return list_.half_open_range(begin, end);
+    }
+    bool contains(const_iterator const &it, size_type position) const noexcept {
+        return list_.contains(it, position);
+    }
+    iterator find_element_before(size_type position) noexcept {
+        return list_.find_element_before(position);
+    }
+    const_iterator find_element_before(size_type position) const noexcept {
+        return list_.find_element_before(position);
+    }
+    iterator find_element_at(size_type position) noexcept {
+        return list_.find_element_at(position);
+    }
+    const_iterator find_element_at(size_type position) const noexcept {
+        return list_.find_element_at(position);
+    }
+    iterator find_element_after(size_type position) noexcept {
+        return list_.find_element_after(position);
+    }
+    const_iterator find_element_after(size_type position) const noexcept {
+        return list_.find_element_after(position);
+    }
+    size_type size() const noexcept {
+        return list_.size();
+    }
+    bool empty() const noexcept {
+        return list_.empty();
+    }
+    size_type used_capacity() const noexcept {
+        return list_.used_capacity();
+    }
+    size_type total_capacity() const noexcept {
+        return list_.total_capacity();
+    }
+    size_type remaining_capacity() const noexcept {
+        return list_.remaining_capacity();
+    }
+    void fill_padding(int fill_byte = 0, bool zero_unused_capacity = true) noexcept {
+        list_.fill_padding(fill_byte, zero_unused_capacity);
+    }
+    //!
+    //! @}
+    //!
+
+private:
+    //!
+    //! @brief If container does not have a buffer then
+    //! takes ownership of the inline buffer.
+    //!
+    void use_inline_buffer() noexcept {
+        if (nullptr == list_.buff().begin) {
+            char *const buffer{ this->inline_buffer_.try_allocate(N) };
+            FFL_CODDING_ERROR_IF(nullptr == buffer);
+            list_.buff().begin = buffer;
+            list_.buff().end = buffer + N;
+            list_.buff().last = nullptr;
+        }
+    }
+    //!
+    //! @brief If elements are in the heap buffer, and they fit
+    //! inline buffer then moves them to inline buffer. If container
+    //! does not have a buffer then takes ownership of the inline buffer.
+    //! @details flat_forward_list might have asked for inline 
+    //! buffer of a smaller size, but inline buffer can always
+    //! be used completely.
+    //!
+    void try_use_inline_buffer() noexcept {
+        if (is_inline()) {
+            list_.buff().end = list_.buff().begin + N;
+        } else if (nullptr == list_.buff().begin) {
+            use_inline_buffer();
+        } else if (used_capacity() <= N) {
+            size_type const used_capacity{ this->used_capacity() };
+            char *const buffer{ this->inline_buffer_.try_allocate(N) };
+            FFL_CODDING_ERROR_IF(nullptr == buffer);
+            if (used_capacity > 0) {
+                copy_data(buffer, list_.buff().begin, used_capacity);
+            }
+            char *const last{ list_.buff().last ? buffer + (list_.buff().last - list_.buff().begin) : nullptr };
+            list_.clear();
+            list_.buff().begin = buffer;
+            list_.buff().end = buffer + N;
+            list_.buff().last = last;
+        }
+    }
+    //!
+    //! @brief Copies elements of the other container.
+    //! @param other - container we are copying from
+    //!
+    void copy_from(small_flat_forward_list const &other) {
+        size_type const used_capacity{ other.used_capacity() };
+        if (used_capacity <= N) {
+            clear();
+            if (!other.empty()) {
+                copy_data(list_.buff().begin, other.list_.buff().begin, used_capacity);
+                list_.buff().last = list_.buff().begin + (other.list_.buff().last - other.list_.buff().begin);
+            }
+        } else {
+            list_ = other.list_;
+        }
+        list_.validate_data_invariants();
+    }
+    //!
+    //! @brief Takes ownership of the other container's heap buffer,
+    //! or copies elements from the other container's inline buffer.
+    //! @param other - container we are moving from. Heap allocators
+    //! must be equal.
+    //!
+    void move_from(small_flat_forward_list &&other) noexcept {
+        if (other.is_inline()) {
+            copy_from(other);
+            other.clear();
+        } else {
+            list_.clear();
+            list_.buff() = other.list_.buff();
+            other.list_.buff().clear();
+            other.use_inline_buffer();
+            list_.validate_data_invariants();
+        }
+    }
+    //!
+    //! @brief Container that keeps elements. It is constructed
+    //! after and destroyed before inline buffer.
+    //!
+    list_type list_;
+};
+
+//!
+//! @brief Swaps content of two containers
+//! @tparam T - element type
+//! @tparam N - size of the inline buffer
+//! @tparam TT - element type traits
+//! @tparam A - allocator type
+//! @param lhs - first container
+//! @param rhs - second container
+//!
+template <typename T,
+          size_t N,
+          typename TT,
+          typename A>
+inline void swap(small_flat_forward_list<T, N, TT, A> &lhs, small_flat_forward_list<T, N, TT, A> &rhs) {
+    lhs.swap(rhs);
+}
+//!
+//! @typedef pmr_small_flat_forward_list
+//! @brief Use this typedef if you want to use container with polymorphic allocator
+//! @tparam T - element type
+//! @tparam N - size of the inline buffer
+//! @tparam TT - element type traits
+//!
+template <typename T,
+          size_t N,
+          typename TT = flat_forward_list_traits<T>>
+using pmr_small_flat_forward_list = small_flat_forward_list<T,
+                                                            N,
+                                                            TT,
+                                                            FFL_PMR::polymorphic_allocator<char>>;
+
+} // namespace iffl
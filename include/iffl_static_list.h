@@ -0,0 +1,453 @@
+#pragma once
+
+//!
+//! @file iffl_static_list.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements static_flat_forward_list, a
+//!        container with fixed capacity that never allocates.
+//!
+//! @details static_flat_forward_list keeps elements in an array
+//!          that is a part of the container. It can be used on
+//!          the stack, or in a hot path where a buffer allocation,
+//!          even from input_buffer_memory_resource, costs too much.
+//!
+//!          Container passes static_buffer_allocator to the
+//!          flat_forward_list. This allocator is empty, so container
+//!          does not have an allocator member, and its metadata is
+//!          three pointers followed by the array.
+//!
+//!          Only methods that do not reallocate buffer are available.
+//!          Methods that add elements are try_* methods, which
+//!          return false when element does not fit in the remaining
+//!          capacity.
+//!
+//! @code
+//! iffl::static_flat_forward_list<FILE_FULL_EA_INFORMATION, 256> eas;
+//! if (!eas.try_emplace_back(...)) {
+//!     // does not fit
+//! }
+//! @endcode
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+#include <array>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @class static_buffer_allocator
+//! @brief Allocator used by static_flat_forward_list.
+//! @details static_flat_forward_list never asks for a new buffer,
+//! so allocate fails fast. Buffer is a part of the container, so
+//! deallocate is a no-op.
+//!
+class static_buffer_allocator {
+public:
+    //!
+    //! @typedef value_type
+    //! @brief Containers use buffer of chars.
+    //!
+    using value_type = char;
+    //!
+    //! @typedef is_always_equal
+    //! @brief Allocator is stateless.
+    //!
+    using is_always_equal = std::true_type;
+    //!
+    //! @struct rebind
+    //! @brief Containers use only buffers of chars
+    //!
+    template <typename U>
+    struct rebind {
+        static_assert(std::is_same_v<U, char>,
+                      "static_buffer_allocator allocates only buffers of chars");
+        //!
+        //! @typedef other
+        //! @brief Same allocator type
+        //!
+        using other = static_buffer_allocator;
+    };
+    //!
+    //! @brief Container with static buffer cannot reallocate.
+    //! @returns does not return
+    //!
+    [[nodiscard]] char *allocate(size_t) noexcept {
+        FFL_CRASH_APPLICATION();
+        return nullptr;
+    }
+    //!
+    //! @brief Buffer is owned by the container, and there is
+    //! nothing to deallocate.
+    //!
+    void deallocate(char *, size_t) noexcept {
+    }
+    //!
+    //! @returns true, allocator is stateless.
+    //!
+    friend bool operator== (static_buffer_allocator const &,
+                            static_buffer_allocator const &) noexcept {
+        return true;
+    }
+    //!
+    //! @returns false, allocator is stateless.
+    //!
+    friend bool operator!= (static_buffer_allocator const &,
+                            static_buffer_allocator const &) noexcept {
+        return false;
+    }
+};
+
+//!
+//! @class static_flat_forward_list
+//! @brief flat_forward_list with a fixed buffer of CAPACITY bytes.
+//! @tparam T - element type
+//! @tparam CAPACITY - size of the buffer in bytes
+//! @tparam TT - element type traits
+//! @details Container always owns its buffer, and its capacity
+//! is always CAPACITY. Copy and assignment copy elements between
+//! buffers. Buffer is aligned for the element type.
+//! Container keeps elements in a flat_forward_list member, and
+//! forwards to it only methods that do not reallocate buffer.
+//!
+template <typename T,
+          size_t CAPACITY,
+          typename TT = flat_forward_list_traits<T>>
+class static_flat_forward_list final {
+
+    static_assert(CAPACITY > 0, "buffer cannot be empty");
+
+public:
+    //!
+    //! @typedef list_type
+    //! @brief Type of the container that keeps elements
+    //!
+    using list_type = flat_forward_list<T, TT, static_buffer_allocator>;
+
+    using value_type = typename list_type::value_type;
+    using pointer = typename list_type::pointer;
+    using const_pointer = typename list_type::const_pointer;
+    using reference = typename list_type::reference;
+    using const_reference = typename list_type::const_reference;
+    using size_type = typename list_type::size_type;
+    using difference_type = typename list_type::difference_type;
+    using traits = typename list_type::traits;
+    using traits_traits = typename list_type::traits_traits;
+    using range_t = typename list_type::range_t;
+    using size_with_padding_t = typename list_type::size_with_padding_t;
+    using buffer_value_type = typename list_type::buffer_value_type;
+    using const_buffer_value_type = typename list_type::const_buffer_value_type;
+    using buffer_pointer = typename list_type::buffer_pointer;
+    using const_buffer_pointer = typename list_type::const_buffer_pointer;
+    using iterator = typename list_type::iterator;
+    using const_iterator = typename list_type::const_iterator;
+    constexpr static size_type const npos{ list_type::npos };
+    //!
+    //! @brief Size of the buffer
+    //!
+    constexpr static size_t const static_capacity{ CAPACITY };
+    //!
+    //! @brief Default constructor
+    //!
+    static_flat_forward_list() noexcept {
+        use_static_buffer();
+    }
+    //!
+    //! @brief Copy constructor
+    //! @param other - container we are copying from
+    //!
+    static_flat_forward_list(static_flat_forward_list const &other) noexcept {
+        use_static_buffer();
+        copy_from(other);
+    }
+    //!
+    //! @brief Copy assignment operator
+    //! @param other - container we are copying from
+    //!
+    static_flat_forward_list &operator= (static_flat_forward_list const &other) noexcept {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+    //!
+    //! @brief Destructor
+    //!
+    ~static_flat_forward_list() noexcept = default;
+    //!
+    //! @brief Copies elements from a view if they fit.
+    //! @param view - describes elements we are copying.
+    //! @returns false if elements do not fit. In that case
+    //! container is not changed.
+    //!
+    [[nodiscard]] bool try_assign(flat_forward_list_view<T, TT> const &view) noexcept {
+        size_type const used_capacity{ view.used_capacity() };
+        if (used_capacity > CAPACITY) {
+            return false;
+        }
+        if (view.empty()) {
+            list_.buff().last = nullptr;
+        } else {
+            copy_data(list_.buff().begin, view.data(), used_capacity);
+            list_.buff().last = list_.buff().begin + (view.last().get_ptr() - view.data());
+        }
+        list_.validate_data_invariants();
+        return true;
+    }
+    //!
+    //! @brief Swaps content of two containers
+    //! @param other - container we are swapping with
+    //!
+    void swap(static_flat_forward_list &other) noexcept {
+        static_flat_forward_list tmp{ other };
+        other = *this;
+        *this = tmp;
+    }
+    //!
+    //! @brief Erases all elements. Buffer stays with container.
+    //!
+    void clear() noexcept {
+        list_.erase_all();
+    }
+    //!
+    //! @returns maximum buffer size
+    //!
+    constexpr static size_type max_size() noexcept {
+        return CAPACITY;
+    }
+    //!
+    //! @name Methods that do not reallocate buffer
+    //! @brief Container forwards these methods to flat_forward_list.
+    //! See flat_forward_list for their description.
+    //! @{
+    //!
+    template <typename... P>
+    [[nodiscard]] bool try_push_back(P &&... p) {
+        return list_.try_push_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace_back(P &&... p) {
+        return list_.try_emplace_back(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_insert(P &&... p) {
+        return list_.try_insert(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace(P &&... p) {
+        return list_.try_emplace(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_push_front(P &&... p) {
+        return list_.try_push_front(std::forward<P>(p)...);
+    }
+    template <typename... P>
+    [[nodiscard]] bool try_emplace_front(P &&... p) {
+        return list_.try_emplace_front(std::forward<P>(p)...);
+    }
+    [[nodiscard]] bool try_element_add_size(iterator const &it, size_type size_to_add) {
+        return list_.try_element_add_size(it, size_to_add);
+    }
+    template <typename F>
+    [[nodiscard]] bool try_element_resize(iterator const &it, size_type new_size, F const &fn) {
+        return list_.try_element_resize(it, new_size, fn);
+    }
+    void pop_back() noexcept {
+        list_.pop_back();
+    }
+    void pop_front() noexcept {
+        list_.pop_front();
+    }
+    void erase_after(iterator const &it) noexcept {
+        list_.erase_after(it);
+    }
+    void erase_after_half_closed(iterator const &before_start, iterator const &last) noexcept {
+        list_.erase_after_half_closed(before_start, last);
+    }
+    void erase_all_after(iterator const &it) noexcept {
+        list_.erase_all_after(it);
+    }
+    iterator erase_all_from(iterator const &it) noexcept {
+        return list_.erase_all_from(it);
+    }
+    void erase_all() noexcept {
+        list_.erase_all();
+    }
+    iterator erase(iterator const &it) noexcept {
+        return list_.erase(it);
+    }
+    iterator erase(iterator const &start, iterator const &end) noexcept {
+        return list_.erase(start, end);
+    }
+    template <typename F>
+    void unique(F const &fn) noexcept {
+        list_.unique(fn);
+    }
+    template <typename F>
+    void remove_if(F const &fn) noexcept {
+        list_.remove_if(fn);
+    }
+    T &front() noexcept {
+        return list_.front();
+    }
+    T const &front() const noexcept {
+        return list_.front();
+    }
+    T &back() noexcept {
+        return list_.back();
+    }
+    T const &back() const noexcept {
+        return list_.back();
+    }
+    iterator begin() noexcept {
+        return list_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return list_.begin();
+    }
+    iterator last() noexcept {
+        return list_.last();
+    }
+    const_iterator last() const noexcept {
+        return list_.last();
+    }
+    iterator end() noexcept {
+        return list_.end();
+    }
+    const_iterator end() const noexcept {
+        return list_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return list_.cbegin();
+    }
+    const_iterator clast() const noexcept {
+        return list_.clast();
+    }
+    const_iterator cend() const noexcept {
+        return list_.cend();
+    }
+    char *data() noexcept {
+        return list_.data();
+    }
+    char const *data() const noexcept {
+        return list_.data();
+    }
+    [[nodiscard]] bool revalidate_data(size_type data_size = npos) noexcept {
+        return list_.revalidate_data(data_size);
+    }
+    size_type required_size(const_iterator const &it) const noexcept {
+        return list_.required_size(it);
+    }
+    size_type used_size(const_iterator const &it) const noexcept {
+        return list_.used_size(it);
+    }
+    range_t range(const_iterator const &it) const noexcept {
+        return list_.range(it);
+    }
+    range_t closed_range(const_iterator const &begin, const_iterator const &last) const noexcept {
+        return list_.closed_range(begin, last);
+    }
+    range_t half_open_range(const_iterator const &begin, const_iterator const &end) const noexcept {
+        return list_.half_open_range(begin, end);
+    }
+    bool contains(const_iterator const &it, size_type position) const noexcept {
+        return list_.contains(it, position);
+    }
+    iterator find_element_before(size_type position) noexcept {
+        return list_.find_element_before(position);
+    }
+    const_iterator find_element_before(size_type position) const noexcept {
+        return list_.find_element_before(position);
+    }
+    iterator find_element_at(size_type position) noexcept {
+        return list_.find_element_at(position);
+    }
+    const_iterator find_element_at(size_type position) const noexcept {
+        return list_.find_element_at(position);
+    }
+    iterator find_element_after(size_type position) noexcept {
+        return list_.find_element_after(position);
+    }
+    const_iterator find_element_after(size_type position) const noexcept {
+        return list_.find_element_after(position);
+    }
+    size_type size() const noexcept {
+        return list_.size();
+    }
+    bool empty() const noexcept {
+        return list_.empty();
+    }
+    size_type used_capacity() const noexcept {
+        return list_.used_capacity();
+    }
+    size_type total_capacity() const noexcept {
+        return list_.total_capacity();
+    }
+    size_type remaining_capacity() const noexcept {
+        return list_.remaining_capacity();
+    }
+    void fill_padding(int fill_byte = 0, bool zero_unused_capacity = true) noexcept {
+        list_.fill_padding(fill_byte, zero_unused_capacity);
+    }
+    //!
+    //! @}
+    //!
+
+private:
+    //!
+    //! @brief Points flat_forward_list to the buffer
+    //!
+    void use_static_buffer() noexcept {
+        list_.buff().begin = storage_.data();
+        list_.buff().end = storage_.data() + CAPACITY;
+        list_.buff().last = nullptr;
+    }
+    //!
+    //! @brief Copies elements from the other container
+    //! @param other - container we are copying from
+    //!
+    void copy_from(static_flat_forward_list const &other) noexcept {
+        if (other.list_.buff().last) {
+            copy_data(list_.buff().begin, other.list_.buff().begin, other.used_capacity());
+            list_.buff().last = list_.buff().begin + (other.list_.buff().last - other.list_.buff().begin);
+        } else {
+            list_.buff().last = nullptr;
+        }
+        list_.validate_data_invariants();
+    }
+    //!
+    //! @brief Buffer that contains elements
+    //!
+    alignas(std::max(alignof(T), traits_traits::alignment)) std::array<char, CAPACITY> storage_;
+    //!
+    //! @brief Container that keeps elements in storage_
+    //!
+    list_type list_;
+};
+
+//!
+//! @brief Swaps content of two containers
+//! @tparam T - element type
+//! @tparam CAPACITY - size of the buffer
+//! @tparam TT - element type traits
+//! @param lhs - first container
+//! @param rhs - second container
+//!
+template <typename T,
+          size_t CAPACITY,
+          typename TT>
+inline void swap(static_flat_forward_list<T, CAPACITY, TT> &lhs, static_flat_forward_list<T, CAPACITY, TT> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace iffl
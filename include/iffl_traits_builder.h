@@ -0,0 +1,244 @@
+#pragma once
+
+//!
+//! @file iffl_traits_builder.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements flat_forward_list_traits_builder that
+//!        generates element type traits from pointers to members.
+//!
+//! @details Many element types have a fixed header, followed by one or
+//!          more variable length arrays, and an optional offset to
+//!          the next element. Instead of writing traits by hand, describe
+//!          these fields, and derive traits from the builder:
+//!
+//! @code
+//! namespace iffl {
+//!     template <>
+//!     struct flat_forward_list_traits<FILE_FULL_EA_INFORMATION>
+//!         : flat_forward_list_traits_builder<FILE_FULL_EA_INFORMATION,
+//!                                            offsetof(FILE_FULL_EA_INFORMATION, EaName),
+//!                                            flat_forward_list_next_offset_field<&FILE_FULL_EA_INFORMATION::NextEntryOffset>,
+//!                                            flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaNameLength>,
+//!                                            flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaValueLength>> {
+//!     };
+//! }
+//! @endcode
+//!
+//!          Generated methods are constexpr, and have no branches, so
+//!          compiler can inline them into validation loop.
+//!          When element type has no length fields, builder also
+//!          defines fixed_size, which lets containers use stride
+//!          arithmetic for element types without next offset.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @struct flat_forward_list_next_offset_field
+//! @brief Describes field that contains offset to the next element.
+//! @tparam M - pointer to the member.
+//!
+template <auto M>
+struct flat_forward_list_next_offset_field {
+    //!
+    //! @brief Pointer to the member
+    //!
+    constexpr static auto const member{ M };
+};
+
+//!
+//! @struct flat_forward_list_no_next_offset
+//! @brief Tag used in place of flat_forward_list_next_offset_field
+//! for element types that do not have offset to the next element.
+//!
+struct flat_forward_list_no_next_offset {
+};
+
+//!
+//! @struct flat_forward_list_length_field
+//! @brief Describes field that contains number of entries in a
+//! variable length array that follows the header.
+//! @tparam M - pointer to the member.
+//! @tparam STRIDE - size of an entry in bytes.
+//!
+template <auto M,
+          size_t STRIDE = 1>
+struct flat_forward_list_length_field {
+    //!
+    //! @brief Pointer to the member
+    //!
+    constexpr static auto const member{ M };
+    //!
+    //! @brief Size of an entry in bytes
+    //!
+    constexpr static size_t const stride{ STRIDE };
+};
+
+//!
+//! @struct flat_forward_list_traits_builder_base
+//! @brief Methods that do not depend on the offset to the next element.
+//! @tparam T - element type
+//! @tparam HEADER_SIZE - size of the fixed part of the element in bytes.
+//! It must include all fields described by the builder.
+//! @tparam L - flat_forward_list_length_field for each variable length
+//! array. Arrays follow header one after another.
+//!
+template <typename T,
+          size_t HEADER_SIZE,
+          typename... L>
+struct flat_forward_list_traits_builder_base {
+    //!
+    //! @brief Containers pad elements so next element is aligned.
+    //!
+    constexpr static size_t const alignment{ alignof(T) };
+    //!
+    //! @returns size of the fixed header.
+    //!
+    constexpr static size_t minimum_size() noexcept {
+        return HEADER_SIZE;
+    }
+    //!
+    //! @param e - element.
+    //! @returns size of the header and all arrays, without padding.
+    //!
+    constexpr static size_t get_size(T const &e) noexcept {
+        return (HEADER_SIZE + ... + (static_cast<size_t>(e.*(L::member)) * L::stride));
+    }
+};
+
+//!
+//! @struct flat_forward_list_traits_builder_base<T, HEADER_SIZE>
+//! @brief Element types without variable length arrays have fixed size.
+//! @tparam T - element type
+//! @tparam HEADER_SIZE - size of the element in bytes.
+//!
+template <typename T,
+          size_t HEADER_SIZE>
+struct flat_forward_list_traits_builder_base<T, HEADER_SIZE> {
+    //!
+    //! @brief Containers pad elements so next element is aligned.
+    //!
+    constexpr static size_t const alignment{ alignof(T) };
+    //!
+    //! @brief All elements have the same size. 
+    //!
+    constexpr static size_t const fixed_size{ HEADER_SIZE };
+    //!
+    //! @returns size of the element.
+    //!
+    constexpr static size_t minimum_size() noexcept {
+        return HEADER_SIZE;
+    }
+    //!
+    //! @returns size of the element.
+    //!
+    constexpr static size_t get_size(T const &) noexcept {
+        return HEADER_SIZE;
+    }
+};
+
+//!
+//! @struct flat_forward_list_traits_builder
+//! @brief Generates traits for element type that has offset to
+//! the next element.
+//! @tparam T - element type
+//! @tparam HEADER_SIZE - size of the fixed part of the element in bytes.
+//! @tparam N - flat_forward_list_next_offset_field or
+//! flat_forward_list_no_next_offset.
+//! @tparam L - flat_forward_list_length_field for each variable length
+//! array.
+//! @details Derive flat_forward_list_traits specialization from this
+//! class. Derived class can hide validate to add checks of element data.
+//!
+template <typename T,
+          size_t HEADER_SIZE,
+          typename N,
+          typename... L>
+struct flat_forward_list_traits_builder
+    : public flat_forward_list_traits_builder_base<T, HEADER_SIZE, L...> {
+    //!
+    //! @typedef base
+    //! @brief Type of the base class
+    //!
+    using base = flat_forward_list_traits_builder_base<T, HEADER_SIZE, L...>;
+    //!
+    //! @param e - element.
+    //! @returns offset to the next element, or 0 if this is the
+    //! last element.
+    //!
+    constexpr static size_t get_next_offset(T const &e) noexcept {
+        return static_cast<size_t>(e.*(N::member));
+    }
+    //!
+    //! @brief Sets offset to the next element.
+    //! @param e - element.
+    //! @param size - offset to the next element, or 0 if this is
+    //! the last element.
+    //!
+    constexpr static void set_next_offset(T &e, size_t size) noexcept {
+        using offset_type = std::remove_reference_t<decltype(e.*(N::member))>;
+        FFL_CODDING_ERROR_IF_NOT(size == 0 || size >= base::get_size(e));
+        e.*(N::member) = static_cast<offset_type>(size);
+    }
+    //!
+    //! @brief Checks that element fits in the buffer.
+    //! @param buffer_size - size of the buffer from the start of
+    //! the element to the end of the buffer.
+    //! @param e - element.
+    //! @returns true if element fits in the buffer. For an element
+    //! that is not the last one, it also checks that next element
+    //! starts in the buffer, and does not overlap this element.
+    //! @details Conditions are combined without short-circuiting,
+    //! so there are no branches.
+    //!
+    constexpr static bool validate(size_t buffer_size, T const &e) noexcept {
+        size_t const size{ base::get_size(e) };
+        size_t const next_offset{ get_next_offset(e) };
+        return (size <= buffer_size) &
+               ((0 == next_offset) | ((next_offset <= buffer_size) & (size <= next_offset)));
+    }
+};
+
+//!
+//! @struct flat_forward_list_traits_builder<T, HEADER_SIZE, flat_forward_list_no_next_offset, L...>
+//! @brief Generates traits for element type that does not have offset
+//! to the next element.
+//! @tparam T - element type
+//! @tparam HEADER_SIZE - size of the fixed part of the element in bytes.
+//! @tparam L - flat_forward_list_length_field for each variable length
+//! array.
+//!
+template <typename T,
+          size_t HEADER_SIZE,
+          typename... L>
+struct flat_forward_list_traits_builder<T, HEADER_SIZE, flat_forward_list_no_next_offset, L...>
+    : public flat_forward_list_traits_builder_base<T, HEADER_SIZE, L...> {
+    //!
+    //! @typedef base
+    //! @brief Type of the base class
+    //!
+    using base = flat_forward_list_traits_builder_base<T, HEADER_SIZE, L...>;
+    //!
+    //! @brief Checks that element fits in the buffer.
+    //! @param buffer_size - size of the buffer from the start of
+    //! the element to the end of the buffer.
+    //! @param e - element.
+    //! @returns true if element fits in the buffer.
+    //!
+    constexpr static bool validate(size_t buffer_size, T const &e) noexcept {
+        return base::get_size(e) <= buffer_size;
+    }
+};
+
+} // namespace iffl
@@ -0,0 +1,358 @@
+#pragma once
+
+//!
+//! @file iffl_variant_list.h
+//!
+//! @author Vladimir Petter
+//!
+//! [iffl github](https://github.com/vladp72/iffl)
+//!
+//! @brief This module implements flat_forward_variant_list, a list of
+//!        records of different types that share a common header.
+//!
+//! @details Header contains a tag that tells record type.
+//!          flat_forward_variant_traits find record type by tag, and
+//!          forward get_size and validate to the traits of that record.
+//!          visit calls a function with reference to the record type:
+//!
+//! @code
+//! using record_list = iffl::flat_forward_variant_list<record_header,
+//!                                                     point_record,
+//!                                                     name_record>;
+//! for (auto it = records.begin(); it != records.end(); ++it) {
+//!     visit(it, iffl::overloaded{
+//!         [](point_record &r) { ... },
+//!         [](name_record &r) { ... }
+//!     });
+//! }
+//! @endcode
+//!
+//!          Traits of the header, flat_forward_list_traits<H>,
+//!          define minimum_size, get_tag, and, when header has
+//!          offset to the next element, get_next_offset and
+//!          set_next_offset.
+//!          Traits of each record, flat_forward_list_traits<R>,
+//!          define tag, and usual get_size, minimum_size and validate.
+//!          Record type starts with the header.
+//!
+//!          Dispatch compares tag with tag of each record type in
+//!          order. There is no table of function pointers, so calls
+//!          are inlined, and compiler can replace comparisons with a
+//!          jump table when tags are dense.
+//!
+
+#include <iffl_config.h>
+#include <iffl_common.h>
+#include <iffl_list.h>
+
+//!
+//! @namespace iffl
+//! @brief intrusive flat forward list
+//!
+namespace iffl {
+
+//!
+//! @struct overloaded
+//! @brief Combines several function objects in one overload set.
+//! @tparam F - function objects
+//!
+template <typename... F>
+struct overloaded : F... {
+    using F::operator()...;
+};
+//!
+//! @brief Deduction guide for overloaded
+//!
+template <typename... F>
+overloaded(F...) -> overloaded<F...>;
+
+//!
+//! @brief Checks that every record type has a different tag.
+//! @tparam H - header type
+//! @tparam R - record types
+//! @returns false if two record types have equal tags. Visit
+//! would never call functor for the second of these records.
+//!
+template <typename H,
+          typename... R>
+constexpr bool flat_forward_variant_has_unique_tags() noexcept {
+    using tag_type = std::decay_t<decltype(flat_forward_list_traits<H>::get_tag(std::declval<H const &>()))>;
+    tag_type const tags[]{ static_cast<tag_type>(flat_forward_list_traits<R>::tag)... };
+    for (size_t i = 0; i < sizeof...(R); ++i) {
+        for (size_t j = i + 1; j < sizeof...(R); ++j) {
+            if (tags[i] == tags[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//!
+//! @struct flat_forward_variant_traits_base
+//! @brief Methods that do not depend on the offset to the next element.
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+struct flat_forward_variant_traits_base {
+
+    static_assert(sizeof...(R) > 0, "list must have at least one record type");
+    static_assert(flat_forward_variant_has_unique_tags<H, R...>(), "each record type must have a different tag");
+    //!
+    //! @typedef header_traits
+    //! @brief Traits of the header
+    //!
+    using header_traits = flat_forward_list_traits<H>;
+    //!
+    //! @typedef header_traits_traits
+    //! @brief Helper class that reads header traits
+    //!
+    using header_traits_traits = flat_forward_list_traits_traits<H, header_traits>;
+    //!
+    //! @brief Containers pad elements so next element is aligned
+    //! for the header and for every record type.
+    //!
+    constexpr static size_t const alignment{ std::max({ header_traits_traits::alignment,
+                                                        flat_forward_list_traits_traits<R>::alignment... }) };
+    //!
+    //! @returns size of the header.
+    //!
+    constexpr static size_t minimum_size() noexcept {
+        return header_traits_traits::minimum_size();
+    }
+    //!
+    //! @param e - element header.
+    //! @returns size of the record.
+    //! @details Fails fast if tag does not match any record type.
+    //! Validated list does not have such records.
+    //!
+    static size_t get_size(H const &e) noexcept {
+        return visit(e, [](auto const &record) noexcept -> size_t {
+            using record_type = std::decay_t<decltype(record)>;
+            return flat_forward_list_traits_traits<record_type>::get_size(reinterpret_cast<char const *>(&record)).size;
+        });
+    }
+    //!
+    //! @brief Checks that record fits in the buffer.
+    //! @param buffer_size - size of the buffer from the start of
+    //! the element to the end of the buffer.
+    //! @param e - element header.
+    //! @returns false if tag does not match any record type,
+    //! or record does not fit in the buffer, or record traits
+    //! validate fails.
+    //!
+    static bool validate_record(size_t buffer_size, H const &e) noexcept {
+        return (validate_record_as<R>(buffer_size, e) || ...);
+    }
+    //!
+    //! @brief Calls function with reference to the record type
+    //! that matches tag.
+    //! @tparam U - H or H const
+    //! @tparam F - function type
+    //! @param e - element header
+    //! @param fn - function that can be called with a reference
+    //! to each record type. All calls must return the same type.
+    //! @returns value returned by fn
+    //! @details Fails fast if tag does not match any record type.
+    //!
+    template <typename U,
+              typename F>
+    static decltype(auto) visit(U &e, F &&fn) {
+        static_assert(std::is_same_v<std::remove_const_t<U>, H>,
+                      "visit expects header of this list");
+        return visit_as<U, F, R...>(e, fn);
+    }
+
+private:
+    //!
+    //! @brief Checks tag of the record type S, and if it matches
+    //! validates record.
+    //! @tparam S - record type
+    //! @param buffer_size - size of the buffer
+    //! @param e - element header
+    //! @returns true if tag matches and record is valid.
+    //!
+    template <typename S>
+    static bool validate_record_as(size_t buffer_size, H const &e) noexcept {
+        using record_traits_traits = flat_forward_list_traits_traits<S>;
+        if (header_traits::get_tag(e) != flat_forward_list_traits<S>::tag ||
+            buffer_size < record_traits_traits::minimum_size()) {
+            return false;
+        }
+        S const &record{ reinterpret_cast<S const &>(e) };
+        return record_traits_traits::get_size(reinterpret_cast<char const *>(&record)).size <= buffer_size &&
+               record_traits_traits::validate(buffer_size, record);
+    }
+    //!
+    //! @brief Calls fn if tag matches record type S, or tries
+    //! next record type.
+    //! @tparam U - H or H const
+    //! @tparam F - function type
+    //! @tparam S - record type we are checking
+    //! @tparam SN - remaining record types
+    //! @param e - element header
+    //! @param fn - function
+    //! @returns value returned by fn
+    //!
+    template <typename U,
+              typename F,
+              typename S,
+              typename... SN>
+    static decltype(auto) visit_as(U &e, F &fn) {
+        using record_type = std::conditional_t<std::is_const_v<U>, S const, S>;
+        if (header_traits::get_tag(e) == flat_forward_list_traits<S>::tag) {
+            return fn(reinterpret_cast<record_type &>(e));
+        }
+        if constexpr (sizeof...(SN) > 0) {
+            return visit_as<U, F, SN...>(e, fn);
+        } else {
+            FFL_CRASH_APPLICATION();
+        }
+    }
+};
+
+//!
+//! @struct flat_forward_variant_traits_impl
+//! @brief Traits for a list of records that share header H.
+//! @tparam HAS_NEXT_OFFSET - true if header has offset to the next element
+//! @tparam H - header type
+//! @tparam R - record types
+//! @details This is specialization for header that does not have
+//! offset to the next element. Records follow each other.
+//!
+template <bool HAS_NEXT_OFFSET,
+          typename H,
+          typename... R>
+struct flat_forward_variant_traits_impl
+    : public flat_forward_variant_traits_base<H, R...> {
+    //!
+    //! @typedef base
+    //! @brief Type of the base class
+    //!
+    using base = flat_forward_variant_traits_base<H, R...>;
+    //!
+    //! @brief Checks that record fits in the buffer.
+    //! @param buffer_size - size of the buffer from the start of
+    //! the element to the end of the buffer.
+    //! @param e - element header.
+    //! @returns true if record is valid.
+    //!
+    static bool validate(size_t buffer_size, H const &e) noexcept {
+        return base::validate_record(buffer_size, e);
+    }
+};
+
+//!
+//! @struct flat_forward_variant_traits_impl<true, H, R...>
+//! @brief Traits for a list of records that share header H,
+//! that has offset to the next element.
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+struct flat_forward_variant_traits_impl<true, H, R...>
+    : public flat_forward_variant_traits_base<H, R...> {
+    //!
+    //! @typedef base
+    //! @brief Type of the base class
+    //!
+    using base = flat_forward_variant_traits_base<H, R...>;
+    //!
+    //! @param e - element header.
+    //! @returns offset to the next element, or 0 if this is the
+    //! last element.
+    //!
+    static size_t get_next_offset(H const &e) noexcept {
+        return base::header_traits::get_next_offset(e);
+    }
+    //!
+    //! @brief Sets offset to the next element.
+    //! @param e - element header.
+    //! @param size - offset to the next element, or 0 if this is
+    //! the last element.
+    //!
+    static void set_next_offset(H &e, size_t size) noexcept {
+        base::header_traits::set_next_offset(e, size);
+    }
+    //!
+    //! @brief Checks that record fits in the buffer.
+    //! @param buffer_size - size of the buffer from the start of
+    //! the element to the end of the buffer.
+    //! @param e - element header.
+    //! @returns true if record is valid. For an element that is not
+    //! the last one, it also checks that next element starts in the
+    //! buffer, and does not overlap this element.
+    //!
+    static bool validate(size_t buffer_size, H const &e) noexcept {
+        if (!base::validate_record(buffer_size, e)) {
+            return false;
+        }
+        size_t const next_offset{ get_next_offset(e) };
+        return 0 == next_offset ||
+               (next_offset <= buffer_size && base::get_size(e) <= next_offset);
+    }
+};
+
+//!
+//! @struct flat_forward_variant_traits
+//! @brief Traits for a list of records that share header H.
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+struct flat_forward_variant_traits
+    : public flat_forward_variant_traits_impl<flat_forward_list_traits_traits<H>::has_next_offset_v, H, R...> {
+};
+
+//!
+//! @brief Calls function with reference to the record that
+//! iterator points to.
+//! @tparam T - header type, or const header type
+//! @tparam TT - flat_forward_variant_traits
+//! @tparam F - function type
+//! @param it - iterator that points to an element
+//! @param fn - function that can be called with a reference
+//! to each record type.
+//! @returns value returned by fn
+//!
+template <typename T,
+          typename TT,
+          typename F>
+inline auto visit(flat_forward_list_iterator_t<T, TT> const &it, F &&fn) -> decltype(TT::visit(*it, fn)) {
+    return TT::visit(*it, fn);
+}
+
+//!
+//! @typedef flat_forward_variant_list
+//! @brief List of records that share header H
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+using flat_forward_variant_list = flat_forward_list<H, flat_forward_variant_traits<H, R...>>;
+//!
+//! @typedef pmr_flat_forward_variant_list
+//! @brief List of records that share header H, that uses
+//! polymorphic allocator
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+using pmr_flat_forward_variant_list = pmr_flat_forward_list<H, flat_forward_variant_traits<H, R...>>;
+//!
+//! @typedef flat_forward_variant_list_view
+//! @brief View of records that share header H
+//! @tparam H - header type
+//! @tparam R - record types
+//!
+template <typename H,
+          typename... R>
+using flat_forward_variant_list_view = flat_forward_list_view<H, flat_forward_variant_traits<H, R...>>;
+
+} // namespace iffl
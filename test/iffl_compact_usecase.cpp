@@ -0,0 +1,226 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_list_array.h"
+#include "iffl_compact_usecase.h"
+
+//
+//  This sample demonstrates how to store a list in a compact
+//  representation, that does not have padding and offsets to the
+//  next element.
+//
+//  compact_sorted_eas encodes extended attributes sorted by name,
+//  with and without shared prefix, and decodes them back.
+//
+//  compact_char_arrays encodes a list of elements without offset
+//  to the next element.
+//
+//  reject_corrupted_compact_list checks that decoder fails on
+//  truncated and corrupted input, and on input that asks for a
+//  buffer above the limit, and does not change container.
+//
+
+#include <cstring>
+#include <random>
+#include <string>
+
+using compact_ea_list = iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION>;
+using compact_ea_view = iffl::flat_forward_list_view<FILE_FULL_EA_INFORMATION>;
+
+void fill_compact_eas(compact_ea_list &eas, size_t ea_count) {
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        std::string const name{ "user.attribute." + std::to_string(1000 + idx) };
+        emplace_back_ea(eas,
+                        name.size(),
+                        2,
+                        [&name, idx](char *ea_name) noexcept {
+                            std::memcpy(ea_name, name.data(), name.size());
+                            ea_name[name.size()] = static_cast<char>(idx);
+                            ea_name[name.size() + 1] = static_cast<char>(idx >> 8);
+                        });
+    }
+}
+
+bool compact_eas_equal(compact_ea_list const &lhs, compact_ea_list const &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    auto rhs_it{ rhs.begin() };
+    for (FILE_FULL_EA_INFORMATION const &e : lhs) {
+        size_t const size{ iffl::flat_forward_list_traits<FILE_FULL_EA_INFORMATION>::get_size(e) };
+        if (size != iffl::flat_forward_list_traits<FILE_FULL_EA_INFORMATION>::get_size(*rhs_it) ||
+            0 != std::memcmp(&e.Flags, &rhs_it->Flags, size - offsetof(FILE_FULL_EA_INFORMATION, Flags))) {
+            return false;
+        }
+        ++rhs_it;
+    }
+    return true;
+}
+
+void compact_sorted_eas() {
+    iffl::debug_memory_resource resource;
+    {
+        compact_ea_list eas{ &resource };
+        fill_compact_eas(eas, 500);
+
+        std::vector<char> prefix_blob;
+        iffl::flat_forward_list_compact_encode(compact_ea_view{ eas }, prefix_blob);
+        std::vector<char> plain_blob;
+        iffl::flat_forward_list_compact_encode(compact_ea_view{ eas }, plain_blob, iffl::compact_flags::none);
+        FFL_CODDING_ERROR_IF_NOT(plain_blob.size() < eas.used_capacity());
+        FFL_CODDING_ERROR_IF_NOT(prefix_blob.size() * 3 < plain_blob.size());
+
+        compact_ea_list prefix_decoded{ &resource };
+        FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_compact_decode(prefix_blob.data(),
+                                                                        prefix_blob.data() + prefix_blob.size(),
+                                                                        prefix_decoded));
+        compact_ea_list plain_decoded{ &resource };
+        FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_compact_decode(plain_blob.data(),
+                                                                        plain_blob.data() + plain_blob.size(),
+                                                                        plain_decoded));
+        FFL_CODDING_ERROR_IF_NOT(compact_eas_equal(eas, prefix_decoded));
+        FFL_CODDING_ERROR_IF_NOT(compact_eas_equal(eas, plain_decoded));
+        FFL_CODDING_ERROR_IF_NOT(prefix_decoded.used_capacity() == prefix_decoded.total_capacity());
+        FFL_CODDING_ERROR_IF_NOT(prefix_decoded.used_capacity() == eas.used_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(prefix_decoded.data(), plain_decoded.data(), plain_decoded.used_capacity()));
+        std::printf("Compacted %zu extended attributes from %zu bytes to %zu bytes, and to %zu bytes with shared prefix\n",
+                    eas.size(),
+                    eas.used_capacity(),
+                    plain_blob.size(),
+                    prefix_blob.size());
+
+        compact_ea_list empty_eas{ &resource };
+        std::vector<char> empty_blob;
+        iffl::flat_forward_list_compact_encode(compact_ea_view{ empty_eas }, empty_blob);
+        FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_compact_decode(empty_blob.data(),
+                                                                        empty_blob.data() + empty_blob.size(),
+                                                                        prefix_decoded));
+        FFL_CODDING_ERROR_IF_NOT(prefix_decoded.empty());
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+}
+
+void compact_char_arrays() {
+    char_array_list arrays;
+    for (unsigned short idx = 0; idx < 100; ++idx) {
+        //
+        // Runs of equal elements are encoded as a shared prefix
+        //
+        unsigned short const length{ static_cast<unsigned short>(idx / 10) };
+        arrays.emplace_back(char_array_list_entry::byte_size_to_array_size(length),
+                            [length](char_array_list_entry &e, size_t) noexcept {
+                                e.length = length;
+                                std::fill(e.arr, e.arr + length, static_cast<char>('a' + length));
+                            });
+    }
+    std::vector<char> blob;
+    iffl::flat_forward_list_compact_encode(char_array_list_view{ arrays }, blob);
+    FFL_CODDING_ERROR_IF_NOT(blob.size() < arrays.used_capacity());
+
+    char_array_list decoded;
+    FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_compact_decode(blob.data(), blob.data() + blob.size(), decoded));
+    FFL_CODDING_ERROR_IF_NOT(arrays.size() == decoded.size());
+    FFL_CODDING_ERROR_IF_NOT(std::equal(arrays.begin(),
+                                        arrays.end(),
+                                        decoded.begin(),
+                                        [](char_array_list_entry const &lhs, char_array_list_entry const &rhs) noexcept {
+                                            return lhs.length == rhs.length &&
+                                                   std::equal(lhs.arr, lhs.arr + lhs.length, rhs.arr);
+                                        }));
+    std::printf("Compacted %zu char arrays from %zu bytes to %zu bytes\n",
+                arrays.size(),
+                arrays.used_capacity(),
+                blob.size());
+}
+
+void reject_corrupted_compact_list() {
+    compact_ea_list eas;
+    fill_compact_eas(eas, 20);
+    std::vector<char> blob;
+    iffl::flat_forward_list_compact_encode(compact_ea_view{ eas }, blob);
+
+    compact_ea_list decoded;
+    fill_compact_eas(decoded, 3);
+    //
+    // Every truncated blob is rejected
+    //
+    for (size_t size = 0; size < blob.size(); ++size) {
+        FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(blob.data(), blob.data() + size, decoded));
+    }
+    std::vector<char> corrupted{ blob };
+    corrupted.push_back(0);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), decoded));
+    //
+    // Element count takes 1 byte, buffer size takes 2 bytes, and
+    // flags are in the 4th byte. Shared prefix of the first element
+    // must be 0.
+    //
+    corrupted = blob;
+    corrupted[3] = 7;
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), decoded));
+    corrupted = blob;
+    corrupted[1] = static_cast<char>(corrupted[1] + 1);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), decoded));
+    corrupted = blob;
+    corrupted[4] = 1;
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), decoded));
+    FFL_CODDING_ERROR_IF_NOT(3 == decoded.size());
+    //
+    // Decoded list must fit in the limit passed by the caller
+    //
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(blob.data(), blob.data() + blob.size(), decoded, eas.used_capacity() - 1));
+    FFL_CODDING_ERROR_IF_NOT(3 == decoded.size());
+    //
+    // Each element takes one byte of input, but blob asks for
+    // a buffer where each element is as large as the input.
+    // Decoder rejects it before it allocates the buffer.
+    //
+    std::vector<char> bomb;
+    size_t const bomb_element_count{ 64 * 1024 };
+    iffl::compact_write_varint(bomb, bomb_element_count);
+    iffl::compact_write_varint(bomb, bomb_element_count * bomb_element_count);
+    bomb.push_back(static_cast<char>(iffl::compact_flags::none));
+    bomb.resize(bomb.size() + bomb_element_count, 0);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(bomb.data(), bomb.data() + bomb.size(), decoded));
+    FFL_CODDING_ERROR_IF_NOT(3 == decoded.size());
+    //
+    // Last element of a plain blob ends the blob. Offset to the
+    // next element is its first field, and encoder writes 0.
+    //
+    std::vector<char> plain_blob;
+    iffl::flat_forward_list_compact_encode(compact_ea_view{ eas }, plain_blob, iffl::compact_flags::none);
+    size_t const last_size{ iffl::flat_forward_list_traits<FILE_FULL_EA_INFORMATION>::get_size(*eas.last()) };
+    corrupted = plain_blob;
+    corrupted[corrupted.size() - last_size] = static_cast<char>(last_size);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), decoded));
+    FFL_CODDING_ERROR_IF_NOT(3 == decoded.size());
+    //
+    // Decoder either rejects blob with a random byte changed,
+    // or returns a valid list
+    //
+    std::mt19937 generator{ 50 };
+    std::uniform_int_distribution<size_t> offset_distribution{ 4, blob.size() - 1 };
+    std::uniform_int_distribution<int> byte_distribution{ 0, 255 };
+    size_t valid_count{ 0 };
+    for (size_t iteration = 0; iteration < 1000; ++iteration) {
+        corrupted = 0 == iteration % 2 ? blob : plain_blob;
+        corrupted[offset_distribution(generator) % corrupted.size()] = static_cast<char>(byte_distribution(generator));
+        compact_ea_list fuzzed;
+        fill_compact_eas(fuzzed, 3);
+        if (iffl::flat_forward_list_compact_decode(corrupted.data(), corrupted.data() + corrupted.size(), fuzzed)) {
+            FFL_CODDING_ERROR_IF_NOT(fuzzed.revalidate_data());
+            ++valid_count;
+        } else {
+            FFL_CODDING_ERROR_IF_NOT(3 == fuzzed.size());
+        }
+    }
+
+    FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_compact_decode(blob.data(), blob.data() + blob.size(), decoded, eas.used_capacity()));
+    FFL_CODDING_ERROR_IF_NOT(compact_eas_equal(eas, decoded));
+    std::printf("Decoder rejected truncated and corrupted compact lists, %zu of 1000 corrupted lists are valid\n", valid_count);
+}
+
+void run_ffl_compact_usecase() {
+    compact_sorted_eas();
+    compact_char_arrays();
+    reject_corrupted_compact_list();
+}
@@ -0,0 +1,505 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_concurrent_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_concurrent.h>
+#include <thread>
+#include <chrono>
+#include <numeric>
+
+//
+//  This sample demonstrates how multiple threads can build
+//  a list in a shared buffer without taking a lock.
+//
+//  build_eas_concurrently starts several producers that append
+//  extended attributes until buffer is full, attaches buffer to
+//  a container, and checks that every producer's elements are in the
+//  order producer added them.
+//
+//  build_arrays_concurrently does the same for an element type
+//  that does not have offset to the next element.
+//
+//  measure_concurrent_append prints append throughput for
+//  different number of producers.
+//
+//  concatenate_thread_local_eas has each producer build its own
+//  container, and concatenates containers with one copy per container.
+//
+//  build_eas_in_shards and build_arrays_in_shards have each producer
+//  fill a shard of a single buffer, and stitch shards into one list.
+//  stitch_empty_shards checks lists that start with an empty shard,
+//  and lists where all shards are empty.
+//
+//  scan_snapshots_while_appending has readers scan snapshots of
+//  a list while writer keeps appending to it.
+//
+//  share_input_buffer has threads take turns building a list in
+//  the same caller buffer, and fill_input_buffer_partitions has each
+//  thread fill its own partition of a caller buffer.
+//
+
+size_t concurrent_ea_name_length(size_t seq) noexcept {
+    return seq % 5 + 2;
+}
+
+size_t concurrent_ea_size(size_t seq) noexcept {
+    return FFL_SIZE_THROUGH_FIELD(FILE_FULL_EA_INFORMATION, EaValueLength) +
+           concurrent_ea_name_length(seq) +
+           sizeof(size_t);
+}
+
+void construct_concurrent_ea(FILE_FULL_EA_INFORMATION &e, unsigned char producer, size_t seq) noexcept {
+    e.Flags = producer;
+    e.EaNameLength = static_cast<UCHAR>(concurrent_ea_name_length(seq));
+    e.EaValueLength = static_cast<USHORT>(sizeof(size_t));
+    std::fill(e.EaName, e.EaName + e.EaNameLength, static_cast<char>('a' + producer));
+    iffl::copy_data(e.EaName + e.EaNameLength,
+                    reinterpret_cast<char const *>(&seq),
+                    sizeof(seq));
+}
+
+template <typename B>
+bool append_concurrent_ea(B &builder,
+                          unsigned char producer,
+                          size_t seq) noexcept {
+    //
+    // Request a few bytes more than we need for some of
+    // the elements. Next offset will skip unused bytes.
+    //
+    return builder.try_emplace_back(concurrent_ea_size(seq) + seq % 3,
+                                    [producer, seq](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                        construct_concurrent_ea(e, producer, seq);
+                                    });
+}
+
+size_t concurrent_ea_seq(FILE_FULL_EA_INFORMATION const &e) noexcept {
+    size_t seq{ 0 };
+    iffl::copy_data(reinterpret_cast<char *>(&seq), e.EaName + e.EaNameLength, sizeof(seq));
+    return seq;
+}
+
+template <typename L>
+void validate_sharded_eas(L const &eas, std::vector<size_t> const &appended_count) {
+    //
+    // Elements of each producer are next to each other,
+    // and producers follow in the order of shards
+    //
+    unsigned char prev_producer{ 0 };
+    size_t next_seq{ 0 };
+    size_t element_count{ 0 };
+    for (FILE_FULL_EA_INFORMATION const &e : eas) {
+        if (e.Flags != prev_producer) {
+            FFL_CODDING_ERROR_IF_NOT(next_seq == appended_count[prev_producer]);
+            FFL_CODDING_ERROR_IF_NOT(prev_producer < e.Flags);
+            prev_producer = e.Flags;
+            next_seq = 0;
+        }
+        FFL_CODDING_ERROR_IF_NOT(concurrent_ea_seq(e) == next_seq);
+        ++next_seq;
+        ++element_count;
+    }
+    FFL_CODDING_ERROR_IF_NOT(next_seq == appended_count[prev_producer]);
+    FFL_CODDING_ERROR_IF_NOT(element_count == std::accumulate(appended_count.begin(), appended_count.end(), size_t{ 0 }));
+}
+
+void build_eas_concurrently(unsigned char producer_count) {
+    size_t const buffer_size{ 64 * 1024 };
+    std::allocator<char> allocator;
+    char *buffer{ allocator.allocate(buffer_size) };
+    iffl::concurrent_flat_forward_list_builder<FILE_FULL_EA_INFORMATION> builder{ buffer, buffer_size };
+
+    std::vector<size_t> appended_count(producer_count, 0);
+    std::vector<std::thread> producers;
+    for (unsigned char producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&builder, &appended_count, producer]() noexcept {
+            size_t seq{ 0 };
+            while (append_concurrent_ea(builder, producer, seq)) {
+                ++seq;
+            }
+            appended_count[producer] = seq;
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    auto list_ref{ builder.finalize() };
+    ea_iffl eas;
+    eas.attach(list_ref.data(), list_ref.last().get_ptr(), list_ref.data() + buffer_size);
+    FFL_CODDING_ERROR_IF_NOT(eas.revalidate_data());
+
+    std::vector<size_t> next_seq(producer_count, 0);
+    for (FILE_FULL_EA_INFORMATION const &e : eas) {
+        FFL_CODDING_ERROR_IF_NOT(e.Flags < producer_count);
+        FFL_CODDING_ERROR_IF_NOT(e.EaName[0] == static_cast<char>('a' + e.Flags));
+        FFL_CODDING_ERROR_IF_NOT(concurrent_ea_seq(e) == next_seq[e.Flags]);
+        ++next_seq[e.Flags];
+    }
+    FFL_CODDING_ERROR_IF_NOT(next_seq == appended_count);
+    std::printf("%u producers appended %zu elements, %zu bytes\n",
+                static_cast<unsigned int>(producer_count),
+                eas.size(),
+                eas.used_capacity());
+}
+
+void build_arrays_concurrently(unsigned short producer_count) {
+    size_t const buffer_size{ 16 * 1024 };
+    char_array_list data;
+    data.resize_buffer(buffer_size);
+    iffl::concurrent_flat_forward_list_builder<char_array_list_entry> builder{ data.data(), buffer_size };
+
+    std::vector<std::thread> producers;
+    for (unsigned short producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&builder, producer]() noexcept {
+            for (;;) {
+                bool const added{ builder.try_emplace_back(char_array_list_entry::byte_size_to_array_size(producer + 1),
+                                                           [producer](char_array_list_entry &e, size_t) noexcept {
+                                                               e.length = producer + 1;
+                                                               std::fill(e.arr, e.arr + e.length, static_cast<char>(producer));
+                                                           }) };
+                if (!added) {
+                    break;
+                }
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    auto list_ref{ builder.finalize() };
+    char *buffer_begin{ data.detach().begin };
+    data.attach(buffer_begin, list_ref.last().get_ptr(), buffer_begin + buffer_size);
+    FFL_CODDING_ERROR_IF_NOT(data.revalidate_data());
+    for (char_array_list_entry const &e : data) {
+        FFL_CODDING_ERROR_IF_NOT(e.length > 0 && e.length <= producer_count);
+        FFL_CODDING_ERROR_IF_NOT(std::all_of(e.arr,
+                                             e.arr + e.length,
+                                             [&e](char c) noexcept { return c == static_cast<char>(e.length - 1); }));
+    }
+    std::printf("%hu producers appended %zu arrays, %zu bytes\n",
+                producer_count,
+                data.size(),
+                data.used_capacity());
+}
+
+void measure_concurrent_append(unsigned char producer_count) {
+    size_t const buffer_size{ 16 * 1024 * 1024 };
+    std::unique_ptr<char[]> buffer{ new char[buffer_size] };
+    iffl::concurrent_flat_forward_list_builder<FILE_FULL_EA_INFORMATION> builder{ buffer.get(), buffer_size };
+
+    auto const start{ std::chrono::steady_clock::now() };
+    std::vector<std::thread> producers;
+    for (unsigned char producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&builder, producer]() noexcept {
+            for (size_t seq = 0; append_concurrent_ea(builder, producer, seq); ++seq) {
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    auto const duration{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+
+    size_t const element_count{ builder.finalize().size() };
+    std::printf("%u producers filled %zu bytes with %zu elements in %lld us\n",
+                static_cast<unsigned int>(producer_count),
+                builder.published_size(),
+                element_count,
+                static_cast<long long>(duration.count()));
+}
+
+void concatenate_thread_local_eas(unsigned char producer_count) {
+    std::vector<ea_iffl> lists(producer_count);
+    std::vector<size_t> appended_count(producer_count, 0);
+    std::vector<std::thread> producers;
+    for (unsigned char producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&lists, &appended_count, producer]() {
+            //
+            // One of the producers does not have anything to add
+            //
+            size_t const count{ 1 == producer ? 0 : 50 + producer * 10u };
+            for (size_t seq = 0; seq < count; ++seq) {
+                lists[producer].emplace_back(concurrent_ea_size(seq),
+                                             [producer, seq](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                                 construct_concurrent_ea(e, producer, seq);
+                                             });
+            }
+            appended_count[producer] = count;
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    ea_iffl const eas{ iffl::flat_forward_list_concatenate(lists.begin(), lists.end()) };
+    validate_sharded_eas(eas, appended_count);
+    std::printf("Concatenated %u lists into %zu elements, %zu bytes\n",
+                static_cast<unsigned int>(producer_count),
+                eas.size(),
+                eas.used_capacity());
+}
+
+void build_eas_in_shards(unsigned char producer_count) {
+    iffl::debug_memory_resource dbg_resource;
+    iffl::flat_forward_list_shards<FILE_FULL_EA_INFORMATION,
+                                   iffl::flat_forward_list_traits<FILE_FULL_EA_INFORMATION>,
+                                   FFL_PMR::polymorphic_allocator<char>> shards{ producer_count, 1000, &dbg_resource };
+    std::vector<size_t> appended_count(producer_count, 0);
+    std::vector<std::thread> producers;
+    for (unsigned char producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&shards, &appended_count, producer]() noexcept {
+            size_t seq{ 0 };
+            if (2 != producer) {
+                while (append_concurrent_ea(shards.shard(producer), producer, seq)) {
+                    ++seq;
+                }
+            }
+            appended_count[producer] = seq;
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> eas{ shards.stitch() };
+    FFL_CODDING_ERROR_IF_NOT(0 == shards.shard_count());
+    FFL_CODDING_ERROR_IF_NOT(eas.revalidate_data());
+    validate_sharded_eas(eas, appended_count);
+    std::printf("Stitched %u shards into %zu elements, %zu bytes\n",
+                static_cast<unsigned int>(producer_count),
+                eas.size(),
+                eas.used_capacity());
+}
+
+void stitch_empty_shards() {
+    std::vector<size_t> appended_count{ 0, 1, 0, 2 };
+    iffl::flat_forward_list_shards<FILE_FULL_EA_INFORMATION> shards{ appended_count.size(), 256 };
+    for (unsigned char producer = 0; producer < appended_count.size(); ++producer) {
+        for (size_t seq = 0; seq < appended_count[producer]; ++seq) {
+            FFL_CODDING_ERROR_IF_NOT(append_concurrent_ea(shards.shard(producer), producer, seq));
+        }
+    }
+    iffl::flat_forward_list<FILE_FULL_EA_INFORMATION> eas{ shards.stitch() };
+    FFL_CODDING_ERROR_IF_NOT(3 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(eas.revalidate_data());
+    FFL_CODDING_ERROR_IF_NOT(3 == eas.size());
+    validate_sharded_eas(eas, appended_count);
+
+    iffl::flat_forward_list_shards<FILE_FULL_EA_INFORMATION> empty_shards{ 3, 256 };
+    iffl::flat_forward_list<FILE_FULL_EA_INFORMATION> empty_eas{ empty_shards.stitch() };
+    FFL_CODDING_ERROR_IF_NOT(empty_eas.empty());
+    std::printf("Stitched shards with empty leading and middle shards into %zu elements\n", eas.size());
+}
+
+void build_arrays_in_shards(unsigned short producer_count) {
+    iffl::flat_forward_list_shards<char_array_list_entry> shards{ producer_count, 101 };
+    std::vector<std::thread> producers;
+    for (unsigned short producer = 0; producer < producer_count; ++producer) {
+        producers.emplace_back([&shards, producer]() noexcept {
+            for (;;) {
+                bool const added{ shards.shard(producer).try_emplace_back(char_array_list_entry::byte_size_to_array_size(producer + 1),
+                                                                          [producer](char_array_list_entry &e, size_t) noexcept {
+                                                                              e.length = producer + 1;
+                                                                              std::fill(e.arr, e.arr + e.length, static_cast<char>(producer));
+                                                                          }) };
+                if (!added) {
+                    break;
+                }
+            }
+        });
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    //
+    // This element type does not have offset to the next element, so
+    // stitch moves shards to close gaps
+    //
+    iffl::flat_forward_list<char_array_list_entry> data{ shards.stitch() };
+    FFL_CODDING_ERROR_IF_NOT(data.revalidate_data(data.used_capacity()));
+    unsigned short prev_length{ 1 };
+    for (char_array_list_entry const &e : data) {
+        FFL_CODDING_ERROR_IF_NOT(prev_length <= e.length && e.length <= producer_count);
+        FFL_CODDING_ERROR_IF_NOT(std::all_of(e.arr,
+                                             e.arr + e.length,
+                                             [&e](char c) noexcept { return c == static_cast<char>(e.length - 1); }));
+        prev_length = e.length;
+    }
+    FFL_CODDING_ERROR_IF_NOT(prev_length == producer_count);
+    std::printf("Stitched %hu shards into %zu arrays, %zu bytes\n",
+                producer_count,
+                data.size(),
+                data.used_capacity());
+}
+
+size_t validate_snapshot_eas(iffl::flat_forward_list_view<FILE_FULL_EA_INFORMATION> const &view) noexcept {
+    size_t seq{ 0 };
+    for (FILE_FULL_EA_INFORMATION const &e : view) {
+        FFL_CODDING_ERROR_IF_NOT(concurrent_ea_seq(e) == seq);
+        ++seq;
+    }
+    return seq;
+}
+
+void scan_snapshots_while_appending(unsigned char reader_count) {
+    size_t const ea_count{ 5000 };
+    iffl::snapshot_flat_forward_list<FILE_FULL_EA_INFORMATION> eas;
+    std::atomic<bool> done{ false };
+
+    std::vector<size_t> snapshot_count(reader_count, 0);
+    std::vector<std::thread> readers;
+    for (unsigned char reader = 0; reader < reader_count; ++reader) {
+        readers.emplace_back([&eas, &done, &snapshot_count, reader]() {
+            size_t prev_element_count{ 0 };
+            for (bool last_pass = false; !last_pass;) {
+                last_pass = done.load();
+                auto const snapshot{ eas.get_snapshot() };
+                size_t const element_count{ validate_snapshot_eas(snapshot.view()) };
+                FFL_CODDING_ERROR_IF(element_count < prev_element_count);
+                prev_element_count = element_count;
+                ++snapshot_count[reader];
+            }
+        });
+    }
+
+    for (size_t seq = 0; seq < ea_count; ++seq) {
+        eas.emplace_back(concurrent_ea_size(seq),
+                         [seq](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                             construct_concurrent_ea(e, 0, seq);
+                         });
+        //
+        // Let readers run on a machine with a single core
+        //
+        if (0 == seq % 250) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    {
+        auto const snapshot{ eas.get_snapshot() };
+        FFL_CODDING_ERROR_IF_NOT(ea_count == validate_snapshot_eas(snapshot.view()));
+        //
+        // Copy resets offset of the last element
+        //
+        ea_iffl const copy{ snapshot.view().cbegin(), snapshot.view().clast() };
+        FFL_CODDING_ERROR_IF_NOT(ea_count == copy.size());
+        FFL_CODDING_ERROR_IF_NOT(0 == copy.clast()->NextEntryOffset);
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == eas.reclaim());
+    std::printf("%u readers took %zu snapshots while writer appended %zu elements, %zu bytes\n",
+                static_cast<unsigned int>(reader_count),
+                std::accumulate(snapshot_count.begin(), snapshot_count.end(), size_t{ 0 }),
+                eas.size(),
+                eas.used_capacity());
+}
+
+void share_input_buffer(unsigned char thread_count) {
+    char buffer[256];
+    iffl::concurrent_input_buffer_memory_resource buffer_resource{ buffer, sizeof(buffer) };
+    size_t const turns_per_thread{ 100 };
+    std::atomic<size_t> failed_allocations{ 0 };
+    std::vector<std::thread> threads;
+    for (unsigned char thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        threads.emplace_back([&buffer_resource, &failed_allocations, thread_idx]() {
+            for (size_t turn = 0; turn < turns_per_thread;) {
+                iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> eas{ &buffer_resource };
+                try {
+                    eas.resize_buffer(sizeof(buffer));
+                } catch (std::bad_alloc const &) {
+                    //
+                    // Another thread owns the buffer
+                    //
+                    ++failed_allocations;
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t seq = 0; append_concurrent_ea(eas, thread_idx, seq); ++seq) {
+                }
+                std::vector<size_t> appended_count(thread_idx + 1, 0);
+                appended_count[thread_idx] = eas.size();
+                validate_sharded_eas(eas, appended_count);
+                ++turn;
+            }
+        });
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+    buffer_resource.validate_no_busy_blocks();
+    std::printf("%u threads took %zu turns on a shared buffer, %zu allocations failed\n",
+                static_cast<unsigned int>(thread_count),
+                turns_per_thread * thread_count,
+                failed_allocations.load());
+}
+
+void fill_input_buffer_partitions(unsigned char thread_count) {
+    std::vector<char> buffer(4000);
+    iffl::concurrent_input_buffer_memory_resource buffer_resource{ buffer.data(), buffer.size(), thread_count };
+    std::vector<size_t> appended_count(thread_count, 0);
+    std::vector<size_t> used_capacity(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (unsigned char thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        threads.emplace_back([&buffer_resource, &appended_count, &used_capacity, thread_idx]() {
+            iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> eas{ &buffer_resource };
+            eas.resize_buffer(buffer_resource.partition_size());
+            size_t seq{ 0 };
+            while (append_concurrent_ea(eas, thread_idx, seq)) {
+                ++seq;
+            }
+            //
+            // Threads can get partitions in any order
+            //
+            size_t const partition_idx{ static_cast<size_t>(eas.data() - buffer_resource.partition(0)) / buffer_resource.partition_size() };
+            appended_count[partition_idx] = seq;
+            used_capacity[partition_idx] = eas.used_capacity();
+            //
+            // Detach, so container does not free partition
+            // while other threads are running
+            //
+            eas.detach();
+        });
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+    FFL_CODDING_ERROR_IF_NOT(thread_count == buffer_resource.get_busy_blocks_count());
+
+    size_t element_count{ 0 };
+    for (size_t idx = 0; idx < thread_count; ++idx) {
+        char *partition{ buffer_resource.partition(idx) };
+        auto const [is_valid, view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(partition,
+                                                                                                 partition + used_capacity[idx]);
+        FFL_CODDING_ERROR_IF_NOT(is_valid);
+        FFL_CODDING_ERROR_IF_NOT(appended_count[idx] == view.size());
+        element_count += view.size();
+        buffer_resource.deallocate(partition, buffer_resource.partition_size());
+    }
+    buffer_resource.validate_no_busy_blocks();
+    std::printf("%u threads filled %zu partitions of %zu bytes with %zu elements\n",
+                static_cast<unsigned int>(thread_count),
+                buffer_resource.partition_count(),
+                buffer_resource.partition_size(),
+                element_count);
+}
+
+void run_ffl_concurrent_usecase() {
+    build_eas_concurrently(1);
+    build_eas_concurrently(4);
+    build_arrays_concurrently(4);
+    for (unsigned char producer_count = 1; producer_count <= 8; producer_count *= 2) {
+        measure_concurrent_append(producer_count);
+    }
+    concatenate_thread_local_eas(4);
+    build_eas_in_shards(4);
+    stitch_empty_shards();
+    build_arrays_in_shards(3);
+    scan_snapshots_while_appending(3);
+    share_input_buffer(4);
+    fill_input_buffer_partitions(4);
+}
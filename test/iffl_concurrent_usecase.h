@@ -0,0 +1,3 @@
+#pragma once
+
+void run_ffl_concurrent_usecase();
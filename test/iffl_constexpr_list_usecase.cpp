@@ -0,0 +1,141 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_list_array.h"
+#include "iffl_constexpr_list_usecase.h"
+#include <iffl_constexpr_list.h>
+
+//
+//  This sample demonstrates how to build static tables
+//  at compile time.
+//
+//  constexpr_ea_table is a list of extended attributes that have
+//  offset to the next element. It uses traits generated by
+//  flat_forward_list_traits_builder, because their methods are
+//  constexpr.
+//
+//  constexpr_char_array_table is a list of arrays that do not
+//  have offset to the next element. Hand-written traits from
+//  iffl_list_array.h use FFL_FIELD_OFFSET, which is not a constant
+//  expression, so it also uses generated traits.
+//
+//  compare_constexpr_ea_table and compare_constexpr_char_array_table
+//  check that tables have the same elements as lists built at
+//  run time.
+//
+
+#if defined(FFL_HAS_CONSTEXPR_LIST)
+
+#include <cstddef>
+#include <cstring>
+
+struct constexpr_ea_traits
+    : public iffl::flat_forward_list_traits_builder<FILE_FULL_EA_INFORMATION,
+                                                    offsetof(FILE_FULL_EA_INFORMATION, EaName),
+                                                    iffl::flat_forward_list_next_offset_field<&FILE_FULL_EA_INFORMATION::NextEntryOffset>,
+                                                    iffl::flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaNameLength>,
+                                                    iffl::flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaValueLength>> {
+};
+
+struct constexpr_char_array_traits
+    : public iffl::flat_forward_list_traits_builder<char_array_list_entry,
+                                                    offsetof(char_array_list_entry, arr),
+                                                    iffl::flat_forward_list_no_next_offset,
+                                                    iffl::flat_forward_list_length_field<&char_array_list_entry::length>> {
+};
+
+//
+// Name is followed by value
+//
+constexpr auto constexpr_ea_table{
+    iffl::make_constexpr_flat_forward_list<FILE_FULL_EA_INFORMATION, constexpr_ea_traits>(
+        iffl::make_constexpr_flat_forward_list_element(FILE_FULL_EA_INFORMATION{ 0, 0, 4, 5, {} }, "namevalue"),
+        iffl::make_constexpr_flat_forward_list_element(FILE_FULL_EA_INFORMATION{ 0, 0, 1, 0, {} }, "a"),
+        iffl::make_constexpr_flat_forward_list_element(FILE_FULL_EA_INFORMATION{ 0, 0, 3, 2, {} }, "abcxy"))
+};
+
+static_assert(constexpr_ea_table.validate());
+static_assert(3 == constexpr_ea_table.size());
+//
+// 8 bytes of header, 10 bytes of payload padded to 20,
+// 2 bytes of payload padded to 12, and 6 bytes of payload.
+// Payload includes terminating zero.
+//
+static_assert(20 + 12 + 14 == constexpr_ea_table.used_capacity());
+static_assert(32 == constexpr_ea_table.last_offset());
+
+constexpr auto constexpr_char_array_table{
+    iffl::make_constexpr_flat_forward_list<char_array_list_entry, constexpr_char_array_traits>(
+        iffl::make_constexpr_flat_forward_list_element(char_array_list_entry{ 6, {} }, "first"),
+        iffl::make_constexpr_flat_forward_list_element(char_array_list_entry{ 0, {} }),
+        iffl::make_constexpr_flat_forward_list_element(char_array_list_entry{ 4, {} }, "abc"))
+};
+
+static_assert(constexpr_char_array_table.validate());
+static_assert(3 == constexpr_char_array_table.size());
+static_assert(8 + 2 + 6 == constexpr_char_array_table.used_capacity());
+
+void compare_constexpr_ea_table() {
+    iffl::flat_forward_list<FILE_FULL_EA_INFORMATION, constexpr_ea_traits> eas;
+    for (FILE_FULL_EA_INFORMATION const &e : constexpr_ea_table.view()) {
+        eas.push_back(constexpr_ea_traits::get_size(e), reinterpret_cast<char const *>(&e));
+    }
+    FFL_CODDING_ERROR_IF_NOT(3 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(eas.revalidate_data());
+
+    auto const view{ constexpr_ea_table.view() };
+    FFL_CODDING_ERROR_IF_NOT(3 == view.size());
+    FFL_CODDING_ERROR_IF_NOT(0 == reinterpret_cast<uintptr_t>(view.data()) % alignof(FILE_FULL_EA_INFORMATION));
+    auto const [is_valid, validated_view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION, constexpr_ea_traits>(view.data(),
+                                                                                                                             view.data() + view.used_capacity());
+    FFL_CODDING_ERROR_IF_NOT(is_valid);
+    FFL_CODDING_ERROR_IF_NOT(3 == validated_view.size());
+    auto table_it{ view.begin() };
+    for (auto it{ eas.begin() }; it != eas.end(); ++it, ++table_it) {
+        FFL_CODDING_ERROR_IF_NOT(it->EaNameLength == table_it->EaNameLength);
+        FFL_CODDING_ERROR_IF_NOT(it->EaValueLength == table_it->EaValueLength);
+        FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(it->EaName,
+                                                  table_it->EaName,
+                                                  it->EaNameLength + it->EaValueLength));
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == std::strcmp("abcxy", view.last()->EaName));
+    std::printf("Constexpr table has the same extended attributes as the list built at run time\n");
+}
+
+void compare_constexpr_char_array_table() {
+    iffl::flat_forward_list<char_array_list_entry, constexpr_char_array_traits> arrays;
+    arrays.emplace_back(char_array_list_entry::byte_size_to_array_size(6),
+                        [](char_array_list_entry &e, size_t) noexcept {
+                            e.length = 6;
+                            std::memcpy(e.arr, "first", 6);
+                        });
+    arrays.emplace_back(char_array_list_entry::byte_size_to_array_size(0),
+                        [](char_array_list_entry &e, size_t) noexcept {
+                            e.length = 0;
+                        });
+    arrays.emplace_back(char_array_list_entry::byte_size_to_array_size(4),
+                        [](char_array_list_entry &e, size_t) noexcept {
+                            e.length = 4;
+                            std::memcpy(e.arr, "abc", 4);
+                        });
+    //
+    // Elements are back to back, so buffers are the same
+    //
+    auto const view{ constexpr_char_array_table.view() };
+    FFL_CODDING_ERROR_IF_NOT(arrays.used_capacity() == view.used_capacity());
+    FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(arrays.data(), view.data(), view.used_capacity()));
+    FFL_CODDING_ERROR_IF_NOT(3 == view.size());
+    std::printf("Constexpr table has the same arrays as the list built at run time\n");
+}
+
+void run_ffl_constexpr_list_usecase() {
+    compare_constexpr_ea_table();
+    compare_constexpr_char_array_table();
+}
+
+#else
+
+void run_ffl_constexpr_list_usecase() {
+    std::printf("Constexpr list is not supported\n");
+}
+
+#endif
@@ -0,0 +1,275 @@
+#include "iffl.h"
+#include "iffl_coroutine_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_coroutine.h>
+#include <iffl_io.h>
+#include <iffl_shm_ring.h>
+
+//
+//  This sample demonstrates how to connect stages of a pipeline
+//  with coroutines.
+//
+//  run_array_pipeline reads arrays from a stream in small batches,
+//  filters long arrays into a list that reuses its buffer, and sums
+//  them in the last stage. Frames of the filter and of the last stage
+//  are allocated from a memory resource.
+//
+//  propagate_stage_exception checks that exception raised by a
+//  producer reaches consumer.
+//
+//  drain_ring_with_coroutine reads arrays from a ring. Producer of the
+//  ring adds more arrays each time consumer finds ring empty.
+//  release_ring_on_destroy checks that ring gets back the batch
+//  consumer was holding when it stopped early.
+//
+
+#if defined(FFL_HAS_COROUTINE) && defined(FFL_HAS_FD_IO)
+
+#include <sstream>
+
+using coroutine_array_generator = iffl::flat_forward_list_batch_generator<char_array_list_view>;
+
+class counting_memory_resource : public FFL_PMR::memory_resource {
+public:
+    size_t allocation_count{ 0 };
+    size_t outstanding_count{ 0 };
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        ++allocation_count;
+        ++outstanding_count;
+        return FFL_PMR::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        --outstanding_count;
+        FFL_PMR::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(FFL_PMR::memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void emplace_coroutine_array(char_array_list &data, unsigned short array_size) {
+    data.emplace_back(char_array_list_entry::byte_size_to_array_size(array_size),
+                      [array_size](char_array_list_entry &e, size_t) noexcept {
+                          e.length = array_size;
+                          std::fill(e.arr, e.arr + e.length, static_cast<char>(array_size));
+                      });
+}
+
+coroutine_array_generator filter_long_arrays(std::allocator_arg_t,
+                                             FFL_PMR::memory_resource *,
+                                             coroutine_array_generator &upstream,
+                                             char_array_list &filtered) {
+    while (char_array_list_view const *batch = co_await upstream.next()) {
+        //
+        // Keeps buffer, so after first few batches
+        // filter does not allocate
+        //
+        filtered.erase_all();
+        for (char_array_list_entry const &e : *batch) {
+            if (8 < e.length) {
+                filtered.push_back(char_array_list_entry::byte_size_to_array_size(e.length),
+                                   reinterpret_cast<char const *>(&e));
+            }
+        }
+        if (!filtered.empty()) {
+            co_yield char_array_list_view{ filtered };
+        }
+    }
+}
+
+iffl::flat_forward_list_task sum_arrays(std::allocator_arg_t,
+                                        FFL_PMR::memory_resource *,
+                                        coroutine_array_generator &upstream,
+                                        size_t &array_count,
+                                        size_t &length_sum) {
+    while (char_array_list_view const *batch = co_await upstream.next()) {
+        for (char_array_list_entry const &e : *batch) {
+            ++array_count;
+            length_sum += e.length;
+        }
+    }
+}
+
+void run_array_pipeline() {
+    char_array_list data;
+    size_t expected_count{ 0 };
+    size_t expected_sum{ 0 };
+    for (unsigned short idx = 0; idx < 1000; ++idx) {
+        unsigned short const array_size{ static_cast<unsigned short>(idx % 17) };
+        emplace_coroutine_array(data, array_size);
+        if (8 < array_size) {
+            ++expected_count;
+            expected_sum += array_size;
+        }
+    }
+    std::istringstream stream{ std::string{ data.data(), data.data() + data.used_capacity() } };
+
+    counting_memory_resource frames;
+    FFL_PMR::unsynchronized_pool_resource filtered_pool;
+    char_array_list filtered{ &filtered_pool };
+    iffl::flat_forward_list_reader<char_array_list_entry> reader{ 128 };
+    size_t array_count{ 0 };
+    size_t length_sum{ 0 };
+    {
+        coroutine_array_generator read_stage{ iffl::reader_batches(reader, iffl::istream_source{ stream }) };
+        coroutine_array_generator filter_stage{ filter_long_arrays(std::allocator_arg, &frames, read_stage, filtered) };
+        iffl::flat_forward_list_task sum_stage{ sum_arrays(std::allocator_arg, &frames, filter_stage, array_count, length_sum) };
+        FFL_CODDING_ERROR_IF_NOT(sum_stage.run());
+        FFL_CODDING_ERROR_IF_NOT(read_stage.done() && filter_stage.done());
+        FFL_CODDING_ERROR_IF_NOT(2 == frames.allocation_count);
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == frames.outstanding_count);
+    FFL_CODDING_ERROR_IF_NOT(reader.eof() && !reader.is_corrupted());
+    FFL_CODDING_ERROR_IF_NOT(expected_count == array_count);
+    FFL_CODDING_ERROR_IF_NOT(expected_sum == length_sum);
+    std::printf("Pipeline passed %zu of %zu arrays, length sum %zu\n",
+                array_count,
+                data.size(),
+                length_sum);
+}
+
+coroutine_array_generator fail_after_first_batch(char_array_list const &data) {
+    co_yield char_array_list_view{ data };
+    throw std::runtime_error{ "producer failed" };
+}
+
+iffl::flat_forward_list_task count_until_failure(coroutine_array_generator &upstream,
+                                                 size_t &batch_count) {
+    while (char_array_list_view const *batch = co_await upstream.next()) {
+        FFL_CODDING_ERROR_IF(batch->empty());
+        ++batch_count;
+    }
+}
+
+void propagate_stage_exception() {
+    char_array_list data;
+    emplace_coroutine_array(data, 3);
+    coroutine_array_generator producer{ fail_after_first_batch(data) };
+    size_t batch_count{ 0 };
+    iffl::flat_forward_list_task consumer{ count_until_failure(producer, batch_count) };
+    bool raised{ false };
+    try {
+        consumer.run();
+    } catch (std::runtime_error const &) {
+        raised = true;
+    }
+    FFL_CODDING_ERROR_IF_NOT(raised && consumer.done());
+    FFL_CODDING_ERROR_IF_NOT(1 == batch_count);
+    std::printf("Consumer received %zu batch before producer failed\n", batch_count);
+}
+
+#if defined(FFL_HAS_SHM_RING)
+
+iffl::flat_forward_list_task check_ring_arrays(coroutine_array_generator &upstream,
+                                               unsigned short &next_consumed,
+                                               size_t &batch_count) {
+    while (char_array_list_view const *batch = co_await upstream.next()) {
+        for (char_array_list_entry const &e : *batch) {
+            FFL_CODDING_ERROR_IF_NOT(e.length == next_consumed % 29);
+            ++next_consumed;
+        }
+        ++batch_count;
+    }
+}
+
+void drain_ring_with_coroutine() {
+    char ring_name[64];
+    std::snprintf(ring_name, sizeof(ring_name), "/iffl_ring_%ld_coroutine", static_cast<long>(getpid()));
+    using ring_type = iffl::shm_flat_forward_list_ring<char_array_list_entry>;
+    ring_type producer{ ring_name, 256 };
+    ring_type consumer{ ring_name };
+    FFL_CODDING_ERROR_IF_NOT(0 == ring_type::remove(ring_name));
+
+    unsigned short next_produced{ 0 };
+    unsigned short next_consumed{ 0 };
+    size_t batch_count{ 0 };
+    auto const produce{ [&producer, &next_produced]() noexcept -> bool {
+        //
+        // Called when ring is empty. Stop once
+        // we have produced all arrays
+        //
+        if (500 <= next_produced) {
+            return false;
+        }
+        while (next_produced < 500) {
+            unsigned short const array_size{ static_cast<unsigned short>(next_produced % 29) };
+            if (!producer.try_emplace_back(char_array_list_entry::byte_size_to_array_size(array_size),
+                                           [array_size](char_array_list_entry &e, size_t) noexcept {
+                                               e.length = array_size;
+                                               std::fill(e.arr, e.arr + e.length, static_cast<char>(array_size));
+                                           })) {
+                break;
+            }
+            ++next_produced;
+        }
+        return true;
+    } };
+    coroutine_array_generator read_stage{ iffl::ring_batches(consumer, produce) };
+    iffl::flat_forward_list_task check_stage{ check_ring_arrays(read_stage, next_consumed, batch_count) };
+    FFL_CODDING_ERROR_IF_NOT(check_stage.run());
+    FFL_CODDING_ERROR_IF_NOT(500 == next_consumed);
+    std::printf("Coroutine drained %hu arrays from ring in %zu batches\n",
+                next_consumed,
+                batch_count);
+}
+
+iffl::flat_forward_list_task take_first_batch(coroutine_array_generator &upstream,
+                                              size_t &array_count) {
+    if (char_array_list_view const *batch = co_await upstream.next()) {
+        array_count = batch->size();
+    }
+}
+
+void release_ring_on_destroy() {
+    char ring_name[64];
+    std::snprintf(ring_name, sizeof(ring_name), "/iffl_ring_%ld_coroutine_destroy", static_cast<long>(getpid()));
+    using ring_type = iffl::shm_flat_forward_list_ring<char_array_list_entry>;
+    ring_type producer{ ring_name, 256 };
+    ring_type consumer{ ring_name };
+    FFL_CODDING_ERROR_IF_NOT(0 == ring_type::remove(ring_name));
+
+    for (unsigned short idx = 0; idx < 4; ++idx) {
+        FFL_CODDING_ERROR_IF_NOT(producer.try_emplace_back(char_array_list_entry::byte_size_to_array_size(idx),
+                                                           [idx](char_array_list_entry &e, size_t) noexcept {
+                                                               e.length = idx;
+                                                               std::fill(e.arr, e.arr + e.length, static_cast<char>(idx));
+                                                           }));
+    }
+    size_t array_count{ 0 };
+    {
+        coroutine_array_generator read_stage{ iffl::ring_batches(consumer, []() noexcept { return false; }) };
+        iffl::flat_forward_list_task first_batch_stage{ take_first_batch(read_stage, array_count) };
+        FFL_CODDING_ERROR_IF_NOT(first_batch_stage.run());
+        //
+        // Consumer stopped while producer is suspended
+        // at co_yield holding the batch
+        //
+        FFL_CODDING_ERROR_IF(read_stage.done());
+    }
+    FFL_CODDING_ERROR_IF_NOT(4 == array_count);
+    FFL_CODDING_ERROR_IF_NOT(consumer.try_read().empty());
+    std::printf("Destroyed coroutine released %zu arrays to the ring\n", array_count);
+}
+
+#endif
+
+void run_ffl_coroutine_usecase() {
+    run_array_pipeline();
+    propagate_stage_exception();
+#if defined(FFL_HAS_SHM_RING)
+    drain_ring_with_coroutine();
+    release_ring_on_destroy();
+#endif
+}
+
+#else
+
+void run_ffl_coroutine_usecase() {
+    std::printf("Coroutines are not supported by this compiler\n");
+}
+
+#endif
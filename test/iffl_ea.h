@@ -27,6 +27,8 @@
 #include <windows.h>
 #endif
 
+#include <numeric>
+
 #if !defined(_WINDOWS_)
 using ULONG = unsigned int;
 using USHORT = unsigned short;
@@ -176,3 +178,81 @@ inline void print_ea(size_t idx,
     }
 }
 
+//
+// Size of extended attribute with name and value of given lengths
+//
+inline size_t ea_size(size_t name_length, size_t value_length) noexcept {
+    return FFL_SIZE_THROUGH_FIELD(FILE_FULL_EA_INFORMATION, EaValueLength) +
+           name_length +
+           value_length;
+}
+
+//
+// Helper function that sets EA header, and calls fill with
+// pointer to the name. Value follows the name.
+//
+template <typename F>
+void construct_ea(FILE_FULL_EA_INFORMATION &e,
+                  size_t name_length,
+                  size_t value_length,
+                  F const &fill) noexcept {
+    e.Flags = 0;
+    e.EaNameLength = static_cast<UCHAR>(name_length);
+    e.EaValueLength = static_cast<USHORT>(value_length);
+    fill(e.EaName);
+}
+
+//
+// Helper functions that append EA to any container
+// of FILE_FULL_EA_INFORMATION
+//
+template <typename L,
+          typename F>
+void emplace_back_ea(L &eas,
+                     size_t name_length,
+                     size_t value_length,
+                     F const &fill) {
+    eas.emplace_back(ea_size(name_length, value_length),
+                     [name_length, value_length, &fill](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                         construct_ea(e, name_length, value_length, fill);
+                     });
+}
+
+template <typename L,
+          typename F>
+[[nodiscard]] bool try_emplace_back_ea(L &eas,
+                                       size_t name_length,
+                                       size_t value_length,
+                                       F const &fill) {
+    return eas.try_emplace_back(ea_size(name_length, value_length),
+                                [name_length, value_length, &fill](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                    construct_ea(e, name_length, value_length, fill);
+                                });
+}
+
+//
+// Helper function that calculates checksum of EA value
+//
+inline size_t ea_checksum(FILE_FULL_EA_INFORMATION const &e) noexcept {
+    char const *value{ e.EaName + e.EaNameLength };
+    return std::accumulate(value,
+                           value + e.EaValueLength,
+                           size_t{ e.EaNameLength },
+                           [](size_t sum, char c) noexcept {
+                               return sum * 31 + static_cast<unsigned char>(c);
+                           });
+}
+
+//
+// Helper function that calculates checksum of all EAs in the
+// container. Checksum depends on the order of EAs.
+//
+template <typename L>
+size_t ea_list_checksum(L const &eas) noexcept {
+    return std::accumulate(eas.begin(),
+                           eas.end(),
+                           size_t{ 0 },
+                           [](size_t sum, FILE_FULL_EA_INFORMATION const &e) noexcept {
+                               return sum * 31 + ea_checksum(e);
+                           });
+}
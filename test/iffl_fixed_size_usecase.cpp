@@ -0,0 +1,150 @@
+#include "iffl.h"
+#include "iffl_fixed_size_usecase.h"
+
+//
+//  This sample demonstrates list of records that all have the same
+//  size, and do not have offset to the next element.
+//
+//  Traits declare fixed_size, so element N starts at N * stride,
+//  and containers calculate size, find elements at position, 
+//  advance iterators, and validate buffers without walking the list.
+//
+//  fixed_size_record_traits are generated with 
+//  flat_forward_list_traits_builder, and add a check of record data.
+//  variable_size_record_traits describe same records without 
+//  fixed_size, and are used to check that both paths agree.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct fixed_size_record {
+    uint32_t key;
+    uint16_t value;
+};
+
+constexpr uint16_t const fixed_size_invalid_value{ 0xFFFF };
+
+struct fixed_size_record_traits
+    : public iffl::flat_forward_list_traits_builder<fixed_size_record,
+                                                    offsetof(fixed_size_record, value) + sizeof(uint16_t),
+                                                    iffl::flat_forward_list_no_next_offset> {
+    constexpr static bool validate(size_t buffer_size, fixed_size_record const &e) noexcept {
+        return (fixed_size <= buffer_size) & (fixed_size_invalid_value != e.value);
+    }
+};
+
+struct variable_size_record_traits {
+    constexpr static size_t const alignment{ alignof(fixed_size_record) };
+    constexpr static size_t minimum_size() noexcept {
+        return fixed_size_record_traits::fixed_size;
+    }
+    constexpr static size_t get_size(fixed_size_record const &) noexcept {
+        return fixed_size_record_traits::fixed_size;
+    }
+    constexpr static bool validate(size_t buffer_size, fixed_size_record const &e) noexcept {
+        return fixed_size_record_traits::validate(buffer_size, e);
+    }
+};
+
+using fixed_size_traits_traits = iffl::flat_forward_list_traits_traits<fixed_size_record, fixed_size_record_traits>;
+using variable_size_traits_traits = iffl::flat_forward_list_traits_traits<fixed_size_record, variable_size_record_traits>;
+
+static_assert(fixed_size_traits_traits::has_fixed_stride_v);
+static_assert(!variable_size_traits_traits::has_fixed_stride_v);
+static_assert(6 == fixed_size_traits_traits::fixed_size);
+static_assert(8 == fixed_size_traits_traits::element_stride());
+
+using fixed_size_record_list = iffl::pmr_flat_forward_list<fixed_size_record, fixed_size_record_traits>;
+
+void fill_fixed_size_records(fixed_size_record_list &records, size_t record_count) {
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<uint32_t> key_distribution{ 0, 1000 };
+    for (size_t idx = 0; idx < record_count; ++idx) {
+        uint32_t const key{ key_distribution(generator) };
+        records.emplace_back(fixed_size_traits_traits::fixed_size,
+                             [key, idx](fixed_size_record &e, size_t) noexcept {
+                                 e.key = key;
+                                 e.value = static_cast<uint16_t>(idx);
+                             });
+    }
+}
+
+void find_fixed_size_records() {
+    fixed_size_record_list records;
+    fill_fixed_size_records(records, 1000);
+    FFL_CODDING_ERROR_IF_NOT(1000 == records.size());
+    FFL_CODDING_ERROR_IF_NOT(1000 == std::distance(records.begin(), records.end()));
+    FFL_CODDING_ERROR_IF_NOT(999 * 8 + 6 == records.used_capacity());
+
+    size_t idx{ 0 };
+    for (auto it = records.cbegin(); it != records.cend(); ++it, ++idx) {
+        FFL_CODDING_ERROR_IF_NOT(records.cbegin() + static_cast<unsigned int>(idx) == it);
+        FFL_CODDING_ERROR_IF_NOT(idx == it->value);
+    }
+
+    for (size_t position = 0; position < records.used_capacity() + 16; ++position) {
+        auto const it{ records.find_element_at(position) };
+        if (position < records.used_capacity()) {
+            FFL_CODDING_ERROR_IF_NOT(position / 8 == it->value);
+            FFL_CODDING_ERROR_IF_NOT(records.contains(it, position));
+        } else {
+            FFL_CODDING_ERROR_IF_NOT(records.cend() == it);
+        }
+        auto const before_it{ records.find_element_before(position) };
+        if (position < 6) {
+            FFL_CODDING_ERROR_IF_NOT(records.cend() == before_it);
+        } else {
+            size_t const expected_idx{ std::min<size_t>((position - 6) / 8, 999) };
+            FFL_CODDING_ERROR_IF_NOT(expected_idx == before_it->value);
+        }
+    }
+
+    iffl::flat_forward_list_view<fixed_size_record, fixed_size_record_traits> const ref{ records };
+    FFL_CODDING_ERROR_IF_NOT(1000 == ref.size());
+    FFL_CODDING_ERROR_IF_NOT(500 == ref.find_element_at(500 * 8 + 3)->value);
+
+    records.sort([](fixed_size_record const &lhs, fixed_size_record const &rhs) noexcept {
+        return lhs.key < rhs.key;
+    });
+    FFL_CODDING_ERROR_IF_NOT(1000 == records.size());
+    FFL_CODDING_ERROR_IF_NOT(std::is_sorted(records.begin(),
+                                            records.end(),
+                                            [](fixed_size_record const &lhs, fixed_size_record const &rhs) noexcept {
+                                                return lhs.key < rhs.key;
+                                            }));
+    std::printf("Found and sorted %zu fixed size records\n", records.size());
+}
+
+void validate_fixed_size_records() {
+    fixed_size_record_list records;
+    fill_fixed_size_records(records, 300);
+
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<size_t> record_distribution{ 0, records.size() - 1 };
+    size_t valid_count{ 0 };
+    for (size_t iteration = 0; iteration < 1000; ++iteration) {
+        std::vector<char> buffer{ records.data(), records.data() + records.used_capacity() };
+        if (0 == iteration % 2) {
+            fixed_size_record *const e{ reinterpret_cast<fixed_size_record *>(buffer.data() + record_distribution(generator) * 8) };
+            e->value = fixed_size_invalid_value;
+        }
+        size_t const buffer_size{ buffer.size() - iteration % 11 };
+        auto const [is_valid, ref] = iffl::flat_forward_list_validate<fixed_size_record, fixed_size_record_traits>(buffer.data(),
+                                                                                                                   buffer.data() + buffer_size);
+        auto const [expected_valid, expected_ref] = iffl::flat_forward_list_validate<fixed_size_record, variable_size_record_traits>(buffer.data(),
+                                                                                                                                     buffer.data() + buffer_size);
+        FFL_CODDING_ERROR_IF_NOT(expected_valid == is_valid);
+        FFL_CODDING_ERROR_IF_NOT(expected_ref.size() == ref.size());
+        FFL_CODDING_ERROR_IF_NOT(expected_ref.used_capacity() == ref.used_capacity());
+        valid_count += is_valid ? 1 : 0;
+    }
+    std::printf("Fixed stride and generic validation agree on 1000 buffers, %zu are valid\n", valid_count);
+}
+
+void run_ffl_fixed_size_usecase() {
+    find_fixed_size_records();
+    validate_fixed_size_records();
+}
@@ -0,0 +1,336 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_io_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_io.h>
+#include <sstream>
+
+//
+//  This sample demonstrates how to stream a flat forward list
+//  to a file and read it back.
+//
+//  write_eas_to_file appends extended attributes to the file using
+//  flat_forward_list_writer with a small staging buffer, so the list is
+//  written in many segments.
+//
+//  read_file reads the file back and validate_file_eas checks
+//  that segments were linked into one valid list.
+//
+//  read_eas_in_batches reads the list back using flat_forward_list_reader
+//  with a buffer that is smaller than the file, and some of the elements.
+//  read_corrupted_element_size checks that reader does not trust element
+//  size from the stream to grow its buffer.
+//
+//  send_eas_subrange sends part of a list with writev, and
+//  send_arrays_without_padding sends a list with padding stripped.
+//
+//  load_ea_files loads lists from several files with
+//  flat_forward_list_loader, and attaches each file buffer to a container.
+//
+
+#if defined(FFL_HAS_FD_IO)
+
+size_t const npos_io_ea_count{ iffl::npos };
+
+size_t io_ea_name_length(size_t idx) noexcept {
+    return idx % 16 + 1;
+}
+
+size_t io_ea_value_length(size_t idx) noexcept {
+    //
+    // One element does not fit reader buffer
+    //
+    return idx % 7 + (50 == idx ? 100 : 0);
+}
+
+size_t io_ea_size(size_t idx) noexcept {
+    return ea_size(io_ea_name_length(idx), io_ea_value_length(idx));
+}
+
+void construct_io_ea(FILE_FULL_EA_INFORMATION &e, size_t idx) noexcept {
+    size_t const name_length{ io_ea_name_length(idx) };
+    size_t const value_length{ io_ea_value_length(idx) };
+    construct_ea(e,
+                 name_length,
+                 value_length,
+                 [idx, name_length, value_length](char *name) noexcept {
+                     std::fill(name, name + name_length, static_cast<char>('a' + idx % 26));
+                     std::fill(name + name_length, name + name_length + value_length, static_cast<char>(idx));
+                 });
+}
+
+bool is_expected_io_ea(FILE_FULL_EA_INFORMATION const &e, size_t idx) noexcept {
+    char const *value{ e.EaName + e.EaNameLength };
+    return e.EaNameLength == io_ea_name_length(idx) &&
+           e.EaValueLength == io_ea_value_length(idx) &&
+           std::all_of(e.EaName, value, [idx](char c) noexcept { return c == static_cast<char>('a' + idx % 26); }) &&
+           std::all_of(value, value + e.EaValueLength, [idx](char c) noexcept { return c == static_cast<char>(idx); });
+}
+
+std::vector<char> read_file(int fd) {
+    std::vector<char> buffer;
+    char chunk[256];
+    size_t offset{ 0 };
+    for (;;) {
+        ssize_t const result{ pread(fd, chunk, sizeof(chunk), static_cast<off_t>(offset)) };
+        FFL_CODDING_ERROR_IF(result < 0);
+        if (0 == result) {
+            break;
+        }
+        buffer.insert(buffer.end(), chunk, chunk + result);
+        offset += static_cast<size_t>(result);
+    }
+    return buffer;
+}
+
+void validate_file_eas(int fd, size_t expected_count) {
+    std::vector<char> buffer{ read_file(fd) };
+    auto [is_valid, view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(buffer.data(),
+                                                                                      buffer.data() + buffer.size());
+    FFL_CODDING_ERROR_IF_NOT(is_valid);
+    size_t idx{ 0 };
+    for (auto const &e : view) {
+        FFL_CODDING_ERROR_IF_NOT(is_expected_io_ea(e, idx));
+        ++idx;
+    }
+    FFL_CODDING_ERROR_IF_NOT(idx == expected_count);
+}
+
+void write_eas_to_file(int fd, size_t ea_count) {
+    iffl::debug_memory_resource dbg_resource;
+    iffl::pmr_flat_forward_list_writer<FILE_FULL_EA_INFORMATION> writer{ fd, 64, 0, &dbg_resource };
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        writer.emplace_back(io_ea_size(idx),
+                            [idx](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                construct_io_ea(e, idx);
+                            });
+        //
+        // Every write leaves a valid list in the file
+        //
+        if (0 == idx % 10) {
+            writer.flush();
+            validate_file_eas(fd, idx + 1);
+        }
+    }
+    //
+    // Element larger than staging buffer grows buffer
+    //
+    writer.emplace_back(io_ea_size(ea_count) + 200,
+                        [ea_count](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                            construct_io_ea(e, ea_count);
+                        });
+    writer.flush();
+    std::printf("Writer produced list of %zu bytes, last segment at offset %zu\n",
+                writer.file_size(),
+                writer.segment_offset());
+}
+
+template <typename R>
+size_t read_eas_in_batches(R const &source) {
+    iffl::debug_memory_resource dbg_resource;
+    iffl::pmr_flat_forward_list_reader<FILE_FULL_EA_INFORMATION> reader{ 48, &dbg_resource };
+    size_t idx{ 0 };
+    size_t batch_count{ 0 };
+    for (auto view{ reader.read_next(source) }; !view.empty(); view = reader.read_next(source)) {
+        ++batch_count;
+        for (auto const &e : view) {
+            FFL_CODDING_ERROR_IF_NOT(is_expected_io_ea(e, idx));
+            ++idx;
+        }
+    }
+    FFL_CODDING_ERROR_IF(reader.is_corrupted());
+    std::printf("Reader returned %zu elements in %zu batches, buffer size %zu, pending %zu bytes\n",
+                idx,
+                batch_count,
+                reader.buffer_size(),
+                reader.pending_size());
+    return reader.pending_size() ? npos_io_ea_count : idx;
+}
+
+void read_corrupted_element_size(std::vector<char> file_data) {
+    //
+    // Find element in the middle of the list, and make its
+    // next entry offset point far past the end of the stream
+    //
+    size_t const corrupted_idx{ 10 };
+    auto [is_valid, view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(file_data.data(),
+                                                                                      file_data.data() + file_data.size());
+    FFL_CODDING_ERROR_IF_NOT(is_valid);
+    std::next(view.begin(), corrupted_idx)->NextEntryOffset = 0x7fff0000;
+    //
+    // Reader does not grow buffer to the size from the stream,
+    // and reports element as corruption
+    //
+    for (size_t max_buffer_size : { size_t{ 4096 }, iffl::reader_default_max_buffer_size }) {
+        std::istringstream corrupted_stream{ std::string{ file_data.begin(), file_data.end() } };
+        iffl::debug_memory_resource dbg_resource;
+        iffl::pmr_flat_forward_list_reader<FILE_FULL_EA_INFORMATION> reader{ 48, &dbg_resource, max_buffer_size };
+        iffl::istream_source source{ corrupted_stream };
+        size_t idx{ 0 };
+        for (auto batch{ reader.read_next(source) }; !batch.empty(); batch = reader.read_next(source)) {
+            for (auto const &element : batch) {
+                FFL_CODDING_ERROR_IF_NOT(is_expected_io_ea(element, idx));
+                ++idx;
+            }
+        }
+        FFL_CODDING_ERROR_IF_NOT(reader.is_corrupted());
+        FFL_CODDING_ERROR_IF_NOT(corrupted_idx == idx);
+        FFL_CODDING_ERROR_IF(reader.buffer_size() > max_buffer_size);
+    }
+}
+
+void send_eas_subrange(size_t first_idx, size_t end_idx) {
+    char file_name[] = "/tmp/iffl_iovec_XXXXXX";
+    int const fd{ mkstemp(file_name) };
+    FFL_CODDING_ERROR_IF(fd < 0);
+    unlink(file_name);
+
+    ea_iffl eas;
+    for (size_t idx = 0; idx < 20; ++idx) {
+        eas.emplace_back(io_ea_size(idx),
+                         [idx](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                             construct_io_ea(e, idx);
+                         });
+    }
+    //
+    // Elements are padded, but adjacent, so only the last element
+    // that we copy to set its next offset to 0 needs a separate iovec
+    //
+    iffl::flat_forward_list_iovec<FILE_FULL_EA_INFORMATION> iov{ eas.cbegin() + first_idx,
+                                                                 eas.cbegin() + end_idx };
+    FFL_CODDING_ERROR_IF_NOT(iov.size() == (end_idx == 20 ? 1 : 2));
+    FFL_CODDING_ERROR_IF_NOT(0 == iov.write_to(fd));
+
+    std::vector<char> buffer{ read_file(fd) };
+    FFL_CODDING_ERROR_IF_NOT(buffer.size() == iov.total_size());
+    auto [is_valid, view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(buffer.data(),
+                                                                                      buffer.data() + buffer.size());
+    FFL_CODDING_ERROR_IF_NOT(is_valid);
+    size_t idx{ first_idx };
+    for (auto const &e : view) {
+        FFL_CODDING_ERROR_IF_NOT(is_expected_io_ea(e, idx));
+        ++idx;
+    }
+    FFL_CODDING_ERROR_IF_NOT(idx == end_idx);
+    std::printf("Sent elements [%zu, %zu) in %zu iovecs, %zu bytes\n",
+                first_idx,
+                end_idx,
+                iov.size(),
+                iov.total_size());
+    close(fd);
+}
+
+void send_arrays_without_padding() {
+    char_array_list data;
+    size_t data_size{ 0 };
+    for (unsigned short idx = 0; idx < 10; ++idx) {
+        size_t const element_size{ char_array_list_entry::byte_size_to_array_size(idx) };
+        data_size += element_size;
+        data.emplace_back(element_size,
+                          [idx](char_array_list_entry &e, size_t) noexcept {
+                              e.length = idx;
+                              std::fill(e.arr, e.arr + e.length, static_cast<char>(idx));
+                          });
+    }
+
+    iffl::flat_forward_list_iovec<char_array_list_entry> iov{ char_array_list_view{ data },
+                                                              iffl::iovec_padding::exclude };
+    FFL_CODDING_ERROR_IF_NOT(iov.total_size() == data_size);
+    FFL_CODDING_ERROR_IF_NOT(iov.total_size() < data.used_capacity());
+    std::printf("Sent %zu bytes of %zu bytes list in %zu iovecs\n",
+                iov.total_size(),
+                data.used_capacity(),
+                iov.size());
+}
+
+void load_ea_files() {
+    //
+    // Files with many elements, single element, no elements,
+    // and a file that ends in the middle of an element
+    //
+    size_t const ea_counts[]{ 30, 1, 0, 10 };
+    constexpr size_t file_count{ std::size(ea_counts) };
+    int fds[file_count];
+    for (size_t file_idx = 0; file_idx < file_count; ++file_idx) {
+        char file_name[] = "/tmp/iffl_loader_XXXXXX";
+        fds[file_idx] = mkstemp(file_name);
+        FFL_CODDING_ERROR_IF(fds[file_idx] < 0);
+        unlink(file_name);
+
+        ea_iffl eas;
+        for (size_t idx = 0; idx < ea_counts[file_idx]; ++idx) {
+            eas.emplace_back(io_ea_size(idx),
+                             [idx](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                 construct_io_ea(e, idx);
+                             });
+        }
+        size_t const bytes_to_write{ 3 == file_idx ? eas.used_capacity() - 3 : eas.used_capacity() };
+        FFL_CODDING_ERROR_IF_NOT(0 == iffl::write_to_fd(fds[file_idx], eas.data(), bytes_to_write, 0));
+    }
+
+    iffl::debug_memory_resource dbg_resource;
+    iffl::pmr_flat_forward_list_loader<FILE_FULL_EA_INFORMATION> loader{ 2, &dbg_resource };
+    size_t load_count{ 0 };
+    loader.load(fds,
+                file_count,
+                [&ea_counts, &load_count](size_t file_idx, int error, bool is_valid, auto &list) {
+                    FFL_CODDING_ERROR_IF_NOT(0 == error);
+                    FFL_CODDING_ERROR_IF_NOT(is_valid == (3 != file_idx));
+                    size_t idx{ 0 };
+                    for (auto const &e : list) {
+                        FFL_CODDING_ERROR_IF_NOT(is_expected_io_ea(e, idx));
+                        ++idx;
+                    }
+                    FFL_CODDING_ERROR_IF_NOT(idx == (is_valid ? ea_counts[file_idx] : 0));
+                    ++load_count;
+                });
+    FFL_CODDING_ERROR_IF_NOT(file_count == load_count);
+    std::printf("Loaded %zu files, io_uring %s\n",
+                load_count,
+                loader.uses_io_uring() ? "used" : "not used");
+
+    for (int fd : fds) {
+        close(fd);
+    }
+}
+
+void run_ffl_io_usecase() {
+    char file_name[] = "/tmp/iffl_io_XXXXXX";
+    int const fd{ mkstemp(file_name) };
+    FFL_CODDING_ERROR_IF(fd < 0);
+    unlink(file_name);
+
+    size_t const ea_count{ 100 };
+    write_eas_to_file(fd, ea_count);
+    validate_file_eas(fd, ea_count + 1);
+
+    FFL_CODDING_ERROR_IF_NOT(ea_count + 1 == read_eas_in_batches(iffl::fd_source{ fd }));
+
+    std::vector<char> const file_data{ read_file(fd) };
+    std::istringstream file_stream{ std::string{ file_data.begin(), file_data.end() } };
+    FFL_CODDING_ERROR_IF_NOT(ea_count + 1 == read_eas_in_batches(iffl::istream_source{ file_stream }));
+    //
+    // Stream that ends in the middle of an element
+    //
+    std::istringstream truncated_stream{ std::string{ file_data.begin(), file_data.end() - 3 } };
+    FFL_CODDING_ERROR_IF_NOT(npos_io_ea_count == read_eas_in_batches(iffl::istream_source{ truncated_stream }));
+    //
+    // Stream with an element that claims to be larger than buffer limit
+    //
+    read_corrupted_element_size(file_data);
+
+    send_eas_subrange(2, 10);
+    send_eas_subrange(5, 20);
+    send_arrays_without_padding();
+    load_ea_files();
+
+    close(fd);
+}
+
+#else
+
+void run_ffl_io_usecase() {
+    std::printf("File descriptor helpers are not supported on this platform\n");
+}
+
+#endif
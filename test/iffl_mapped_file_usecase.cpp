@@ -0,0 +1,116 @@
+#include "iffl.h"
+#include "iffl_mapped_file_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_mapped_file.h>
+
+#if defined(FFL_HAS_MAPPED_FILE)
+#include <fcntl.h>
+#endif
+
+//
+//  This sample demonstrates how to keep container buffer in a file
+//  mapping, so changes to the list are persisted without rewriting
+//  entire file.
+//
+//  append_to_mapped_file opens list stored in the file, appends elements
+//  to the end, inserts an element to the front, and flushes changes.
+//
+//  verify_mapped_file opens the file again and checks that it contains
+//  all elements.
+//
+
+#if defined(FFL_HAS_MAPPED_FILE)
+
+void emplace_mapped_file_element(char_array_list &data,
+                                 char_array_list::iterator const &it,
+                                 unsigned short array_size) {
+    data.emplace(it,
+                 char_array_list_entry::byte_size_to_array_size(array_size),
+                 [array_size](char_array_list_entry &e,
+                              size_t element_size) noexcept {
+                     e.length = array_size;
+                     std::fill(e.arr, e.arr + e.length, static_cast<char>(array_size));
+                 });
+}
+
+void append_to_mapped_file(int fd, unsigned short first_array_size, unsigned short last_array_size) {
+    iffl::mapped_file_memory_resource file_resource{ fd };
+    {
+        char_array_list data{ &file_resource };
+        size_t const file_size{ file_resource.file_size() };
+        if (file_size) {
+            bool const is_valid{ data.attach(static_cast<char *>(file_resource.allocate(file_size)), file_size) };
+            FFL_CODDING_ERROR_IF_NOT(is_valid);
+        }
+        FFL_CODDING_ERROR_IF_NOT(0 == file_size || file_resource.is_file_backed());
+        //
+        // Elements that fit unused capacity are constructed
+        // directly in the file pages. Other elements reallocate
+        // buffer, and resource moves new buffer to the file.
+        //
+        data.resize_buffer(data.total_capacity() + 64);
+        FFL_CODDING_ERROR_IF_NOT(file_resource.is_file_backed());
+        for (unsigned short array_size = first_array_size; array_size < last_array_size; ++array_size) {
+            emplace_mapped_file_element(data, data.end(), array_size);
+            FFL_CODDING_ERROR_IF_NOT(file_resource.is_file_backed());
+        }
+        //
+        // Inserting in the middle shifts elements in the
+        // staging buffer
+        //
+        emplace_mapped_file_element(data, data.begin(), last_array_size);
+        FFL_CODDING_ERROR_IF_NOT(file_resource.is_file_backed());
+        //
+        // This element type does not have next element offset
+        // so trim unused capacity from the file
+        //
+        data.shrink_to_fit();
+        FFL_CODDING_ERROR_IF_NOT(file_resource.file_size() == data.total_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == file_resource.flush(data.data(), data.used_capacity()));
+        FFL_CODDING_ERROR_IF_NOT(0 == file_resource.get_last_error());
+        std::printf("Mapped file contains %zu elements, %zu bytes\n",
+                    data.size(),
+                    data.used_capacity());
+    }
+    file_resource.validate_no_busy_blocks();
+}
+
+void verify_mapped_file(int fd, size_t expected_size) {
+    iffl::mapped_file_memory_resource file_resource{ fd };
+    size_t const file_size{ file_resource.file_size() };
+    char_array_list data{ iffl::attach_buffer{},
+                          static_cast<char *>(file_resource.allocate(file_size)),
+                          file_size,
+                          &file_resource };
+    FFL_CODDING_ERROR_IF_NOT(data.size() == expected_size);
+    for (auto const &e : data) {
+        print(e);
+        FFL_CODDING_ERROR_IF_NOT(std::all_of(e.arr,
+                                             e.arr + e.length,
+                                             [&e](char c) noexcept {
+                                                 return c == static_cast<char>(e.length);
+                                             }));
+    }
+}
+
+void run_ffl_mapped_file_usecase() {
+    char file_name[] = "/tmp/iffl_mapped_file_XXXXXX";
+    int const fd{ mkstemp(file_name) };
+    FFL_CODDING_ERROR_IF(fd < 0);
+    unlink(file_name);
+
+    append_to_mapped_file(fd, 1, 6);
+    verify_mapped_file(fd, 6);
+    append_to_mapped_file(fd, 7, 20);
+    verify_mapped_file(fd, 20);
+
+    close(fd);
+}
+
+#else
+
+void run_ffl_mapped_file_usecase() {
+    std::printf("mapped_file_memory_resource is not supported on this platform\n");
+}
+
+#endif
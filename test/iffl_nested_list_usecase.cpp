@@ -0,0 +1,238 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_nested_list_usecase.h"
+
+//
+//  This sample demonstrates list of directory entries where each
+//  entry contains a list of extended attributes.
+//
+//  validate_nested_lists checks that validation of the directory
+//  entries also validates extended attributes, and that corrupted
+//  extended attribute invalidates directory entry that contains it.
+//
+//  iterate_nested_lists uses nested views to walk extended
+//  attributes of each entry without validating them again.
+//
+//  reject_self_nested_lists checks that an element that contains
+//  list of its own type cannot describe itself, and that validation
+//  stops at flat_forward_list_max_nesting_depth.
+//
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct nested_dir_entry {
+    uint32_t next_offset;
+    uint32_t ea_offset;
+    uint32_t ea_length;
+    uint16_t name_length;
+    char name[1];
+};
+
+namespace iffl {
+    template <>
+    struct flat_forward_list_traits<nested_dir_entry> {
+        using nested_lists = std::tuple<flat_forward_list_nested_field<&nested_dir_entry::ea_offset,
+                                                                       &nested_dir_entry::ea_length,
+                                                                       FILE_FULL_EA_INFORMATION>>;
+
+        constexpr static size_t const alignment{ alignof(nested_dir_entry) };
+        constexpr static size_t minimum_size() noexcept {
+            return offsetof(nested_dir_entry, name);
+        }
+        constexpr static size_t get_size(nested_dir_entry const &e) noexcept {
+            return std::max(offsetof(nested_dir_entry, name) + e.name_length,
+                            static_cast<size_t>(e.ea_offset) + e.ea_length);
+        }
+        constexpr static size_t get_next_offset(nested_dir_entry const &e) noexcept {
+            return e.next_offset;
+        }
+        constexpr static void set_next_offset(nested_dir_entry &e, size_t size) noexcept {
+            e.next_offset = static_cast<uint32_t>(size);
+        }
+        constexpr static bool validate(size_t buffer_size, nested_dir_entry const &e) noexcept {
+            if (0 == e.next_offset) {
+                return get_size(e) <= buffer_size;
+            }
+            return e.next_offset <= buffer_size && get_size(e) <= e.next_offset;
+        }
+    };
+}
+
+struct nested_tree_entry {
+    uint32_t next_offset;
+    uint16_t children_offset;
+    uint16_t children_length;
+};
+
+namespace iffl {
+    template <>
+    struct flat_forward_list_traits<nested_tree_entry> {
+        using nested_lists = std::tuple<flat_forward_list_nested_field<&nested_tree_entry::children_offset,
+                                                                       &nested_tree_entry::children_length,
+                                                                       nested_tree_entry>>;
+
+        constexpr static size_t const alignment{ alignof(nested_tree_entry) };
+        constexpr static size_t minimum_size() noexcept {
+            return sizeof(nested_tree_entry);
+        }
+        constexpr static size_t get_size(nested_tree_entry const &e) noexcept {
+            return std::max(sizeof(nested_tree_entry),
+                            static_cast<size_t>(e.children_offset) + e.children_length);
+        }
+        constexpr static size_t get_next_offset(nested_tree_entry const &e) noexcept {
+            return e.next_offset;
+        }
+        constexpr static void set_next_offset(nested_tree_entry &e, size_t size) noexcept {
+            e.next_offset = static_cast<uint32_t>(size);
+        }
+        constexpr static bool validate(size_t buffer_size, nested_tree_entry const &e) noexcept {
+            if (0 == e.next_offset) {
+                return get_size(e) <= buffer_size;
+            }
+            return e.next_offset <= buffer_size && get_size(e) <= e.next_offset;
+        }
+    };
+}
+
+using nested_dir_list = iffl::pmr_flat_forward_list<nested_dir_entry>;
+
+static_assert(nested_dir_list::traits_traits::has_nested_lists_v);
+static_assert(!iffl::flat_forward_list_traits_traits<FILE_FULL_EA_INFORMATION>::has_nested_lists_v);
+
+void append_nested_dir_entry(nested_dir_list &entries, char const *name, size_t ea_count) {
+    ea_iffl eas;
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        std::string const ea_name{ std::string{ name } + "." + std::to_string(idx) };
+        emplace_back_ea(eas,
+                        ea_name.size() + 1,
+                        0,
+                        [&ea_name](char *name) noexcept {
+                            std::memcpy(name, ea_name.c_str(), ea_name.size() + 1);
+                        });
+    }
+    size_t const name_length{ std::strlen(name) + 1 };
+    size_t const ea_offset{ iffl::roundup_size_to_alignment<FILE_FULL_EA_INFORMATION>(offsetof(nested_dir_entry, name) + name_length) };
+    size_t const ea_length{ eas.used_capacity() };
+    entries.emplace_back(ea_offset + ea_length,
+                         [&eas, name, name_length, ea_offset, ea_length](nested_dir_entry &e, size_t) noexcept {
+                             e.name_length = static_cast<uint16_t>(name_length);
+                             std::memcpy(e.name, name, name_length);
+                             e.ea_offset = static_cast<uint32_t>(ea_length ? ea_offset : 0);
+                             e.ea_length = static_cast<uint32_t>(ea_length);
+                             if (ea_length) {
+                                 std::memcpy(reinterpret_cast<char *>(&e) + ea_offset, eas.data(), ea_length);
+                             }
+                         });
+}
+
+void fill_nested_dir_list(nested_dir_list &entries) {
+    append_nested_dir_entry(entries, "dir", 3);
+    append_nested_dir_entry(entries, "file.txt", 1);
+    append_nested_dir_entry(entries, "empty", 0);
+    append_nested_dir_entry(entries, "readme.md", 5);
+    append_nested_dir_entry(entries, "last", 2);
+}
+
+void validate_nested_lists() {
+    nested_dir_list entries;
+    fill_nested_dir_list(entries);
+    FFL_CODDING_ERROR_IF_NOT(5 == entries.size());
+
+    auto [is_valid, view] = iffl::flat_forward_list_validate<nested_dir_entry>(entries.data(),
+                                                                              entries.data() + entries.used_capacity());
+    FFL_CODDING_ERROR_IF_NOT(is_valid);
+    FFL_CODDING_ERROR_IF_NOT(5 == view.size());
+    //
+    // Corrupt second extended attribute of the fourth entry
+    //
+    auto it{ entries.begin() };
+    std::advance(it, 3);
+    FILE_FULL_EA_INFORMATION &ea{ *(++iffl::nested_ref<0>(it).begin()) };
+    ea.EaNameLength = 200;
+    auto [is_corrupted_valid, corrupted_view] = iffl::flat_forward_list_validate<nested_dir_entry>(entries.data(),
+                                                                                                  entries.data() + entries.used_capacity());
+    FFL_CODDING_ERROR_IF(is_corrupted_valid);
+    FFL_CODDING_ERROR_IF_NOT(3 == corrupted_view.size());
+    FFL_CODDING_ERROR_IF(entries.revalidate_data());
+
+    std::printf("Corrupted extended attribute invalidated directory entry\n");
+}
+
+void iterate_nested_lists() {
+    nested_dir_list entries;
+    fill_nested_dir_list(entries);
+    FFL_CODDING_ERROR_IF_NOT(entries.revalidate_data());
+
+    size_t ea_count{ 0 };
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        auto const eas{ iffl::nested_view<0>(it) };
+        size_t idx{ 0 };
+        for (FILE_FULL_EA_INFORMATION const &ea : eas) {
+            std::string const ea_name{ std::string{ it->name } + "." + std::to_string(idx) };
+            FFL_CODDING_ERROR_IF_NOT(ea_name == ea.EaName);
+            ++idx;
+        }
+        FFL_CODDING_ERROR_IF_NOT(idx == eas.size());
+        ea_count += idx;
+    }
+    FFL_CODDING_ERROR_IF_NOT(11 == ea_count);
+    FFL_CODDING_ERROR_IF_NOT(iffl::nested_view<0>(std::next(entries.cbegin(), 2)).empty());
+
+    std::printf("Found %zu extended attributes in %zu directory entries\n", ea_count, entries.size());
+}
+
+//
+// Each entry contains a list with the next entry, so
+// depth of the last entry is depth - 1
+//
+std::vector<char> make_nested_tree(size_t depth) {
+    std::vector<char> buffer(depth * sizeof(nested_tree_entry));
+    for (size_t level = 0; level < depth; ++level) {
+        size_t const children_length{ (depth - level - 1) * sizeof(nested_tree_entry) };
+        nested_tree_entry const e{ 0,
+                                   static_cast<uint16_t>(0 == children_length ? 0 : sizeof(nested_tree_entry)),
+                                   static_cast<uint16_t>(children_length) };
+        std::memcpy(buffer.data() + level * sizeof(nested_tree_entry), &e, sizeof(e));
+    }
+    return buffer;
+}
+
+void reject_self_nested_lists() {
+    //
+    // Entry claims that its children list is the entry itself
+    //
+    std::vector<char> buffer(16);
+    nested_tree_entry const self{ 0, 0, 16 };
+    std::memcpy(buffer.data(), &self, sizeof(self));
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_validate<nested_tree_entry>(buffer.data(),
+                                                                              buffer.data() + buffer.size()).first);
+    //
+    // Children list overlaps entry header
+    //
+    nested_tree_entry const overlap{ 0, 4, 12 };
+    std::memcpy(buffer.data(), &overlap, sizeof(overlap));
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_validate<nested_tree_entry>(buffer.data(),
+                                                                              buffer.data() + buffer.size()).first);
+
+    std::vector<char> tree{ make_nested_tree(iffl::flat_forward_list_max_nesting_depth + 1) };
+    FFL_CODDING_ERROR_IF_NOT(iffl::flat_forward_list_validate<nested_tree_entry>(tree.data(),
+                                                                                  tree.data() + tree.size()).first);
+    tree = make_nested_tree(iffl::flat_forward_list_max_nesting_depth + 2);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_validate<nested_tree_entry>(tree.data(),
+                                                                              tree.data() + tree.size()).first);
+    tree = make_nested_tree(4096);
+    FFL_CODDING_ERROR_IF(iffl::flat_forward_list_validate<nested_tree_entry>(tree.data(),
+                                                                              tree.data() + tree.size()).first);
+
+    std::printf("Self nested entries were rejected, trees up to %zu levels were accepted\n",
+                iffl::flat_forward_list_max_nesting_depth + 1);
+}
+
+void run_ffl_nested_list_usecase() {
+    validate_nested_lists();
+    iterate_nested_lists();
+    reject_self_nested_lists();
+}
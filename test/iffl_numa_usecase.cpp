@@ -0,0 +1,161 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_numa_usecase.h"
+#include <iffl_numa.h>
+
+//
+//  This sample demonstrates how to keep list pages on chosen NUMA
+//  nodes, and process list on threads running on these nodes.
+//
+//  allocate_on_numa_nodes builds lists in memory bound to a node
+//  and interleaved between all nodes, and checks where pages landed.
+//
+//  scan_numa_eas checksums extended attributes and validates buffers
+//  with NUMA aware algorithms, and compares results with algorithms
+//  that ignore NUMA. It runs on the topology of this machine, and on
+//  an emulated topology where every other page belongs to another node.
+//
+
+#if defined(FFL_HAS_NUMA)
+
+void fill_numa_eas(iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> &eas, size_t ea_count) {
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        size_t const value_length{ idx % 53 };
+        emplace_back_ea(eas,
+                        1,
+                        value_length,
+                        [idx, value_length](char *name) noexcept {
+                            name[0] = 'n';
+                            for (size_t i = 0; i < value_length; ++i) {
+                                name[1 + i] = static_cast<char>(idx * 7 + i);
+                            }
+                        });
+    }
+}
+
+void allocate_on_numa_nodes(iffl::numa_topology const &topology) {
+    std::vector<int> all_nodes;
+    for (size_t node = 0; node < topology.node_count(); ++node) {
+        all_nodes.push_back(topology.node_id(node));
+    }
+    size_t const last_node{ topology.node_count() - 1 };
+    iffl::numa_memory_resource bound{ iffl::numa_policy::bind, { topology.node_id(last_node) } };
+    iffl::numa_memory_resource interleaved{ iffl::numa_policy::interleave, all_nodes };
+    //
+    // Preferred policy uses the first given node,
+    // and not the lowest one
+    //
+    iffl::numa_memory_resource preferred{ iffl::numa_policy::preferred, { all_nodes.rbegin(), all_nodes.rend() } };
+    {
+        iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> bound_eas{ &bound };
+        fill_numa_eas(bound_eas, 10000);
+        FFL_CODDING_ERROR_IF_NOT(1 == bound.get_busy_blocks_count());
+        FFL_CODDING_ERROR_IF_NOT(last_node == topology.node_of(bound_eas.data()));
+        FFL_CODDING_ERROR_IF_NOT(last_node == topology.node_of(bound_eas.data() + bound_eas.used_capacity() - 1));
+
+        iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> preferred_eas{ &preferred };
+        fill_numa_eas(preferred_eas, 10000);
+        FFL_CODDING_ERROR_IF_NOT(last_node == topology.node_of(preferred_eas.data()));
+
+        iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> interleaved_eas{ &interleaved };
+        fill_numa_eas(interleaved_eas, 10000);
+        std::vector<size_t> node_pages(topology.node_count());
+        for (size_t offset = 0; offset < interleaved_eas.used_capacity(); offset += 4096) {
+            ++node_pages[topology.node_of(interleaved_eas.data() + offset)];
+        }
+        std::printf("Interleaved %zu bytes between %zu nodes, node 0 owns %zu pages\n",
+                    interleaved_eas.used_capacity(),
+                    topology.node_count(),
+                    node_pages[0]);
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == bound.get_busy_blocks_count());
+    FFL_CODDING_ERROR_IF_NOT(0 == interleaved.get_busy_blocks_count());
+    FFL_CODDING_ERROR_IF_NOT(0 == preferred.get_busy_blocks_count());
+}
+
+void scan_numa_eas(iffl::numa_topology const &topology, unsigned int concurrency) {
+    iffl::numa_memory_resource interleaved{ iffl::numa_policy::interleave, { topology.node_id(0) } };
+    iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> eas{ &interleaved };
+    fill_numa_eas(eas, 20000);
+
+    size_t expected_checksum{ 0 };
+    for (FILE_FULL_EA_INFORMATION const &e : eas) {
+        expected_checksum += ea_checksum(e);
+    }
+    size_t const checksum{ iffl::numa_parallel_transform_reduce(eas.cbegin(),
+                                                                eas.cend(),
+                                                                size_t{ 0 },
+                                                                std::plus<size_t>{},
+                                                                ea_checksum,
+                                                                topology,
+                                                                concurrency) };
+    FFL_CODDING_ERROR_IF_NOT(expected_checksum == checksum);
+
+    std::atomic<size_t> for_each_checksum{ 0 };
+    iffl::numa_parallel_for_each(eas,
+                                 [&for_each_checksum](FILE_FULL_EA_INFORMATION const &e) noexcept {
+                                     for_each_checksum += ea_checksum(e);
+                                 },
+                                 topology,
+                                 concurrency);
+    FFL_CODDING_ERROR_IF_NOT(expected_checksum == for_each_checksum);
+
+    //
+    // Validate each 100 elements as a separate buffer
+    //
+    std::vector<iffl::flat_forward_list_buffer> buffers;
+    char const *buffer_begin{ eas.data() };
+    size_t idx{ 0 };
+    for (auto it = eas.cbegin(); it != eas.cend(); ++it, ++idx) {
+        if (0 == (idx + 1) % 100) {
+            char const *const buffer_end{ std::next(it).get_ptr() };
+            buffers.push_back(iffl::flat_forward_list_buffer{ buffer_begin, static_cast<size_t>(buffer_end - buffer_begin) });
+            buffer_begin = buffer_end;
+        }
+    }
+    std::vector<iffl::flat_forward_list_validation_result<FILE_FULL_EA_INFORMATION>> results(buffers.size());
+    iffl::numa_flat_forward_list_validate_batch(buffers.data(),
+                                                buffers.size(),
+                                                results.data(),
+                                                topology,
+                                                concurrency);
+    auto const expected_results{ iffl::flat_forward_list_validate_batch<FILE_FULL_EA_INFORMATION>(buffers, 1) };
+    for (size_t buffer = 0; buffer < buffers.size(); ++buffer) {
+        FFL_CODDING_ERROR_IF_NOT(expected_results[buffer].is_valid == results[buffer].is_valid);
+        FFL_CODDING_ERROR_IF_NOT(expected_results[buffer].view.size() == results[buffer].view.size());
+    }
+
+    std::printf("Checksum of %zu elements on %zu nodes and %u threads is %zu, validated %zu buffers\n",
+                eas.size(),
+                topology.node_count(),
+                concurrency,
+                checksum,
+                buffers.size());
+}
+
+void run_ffl_numa_usecase() {
+    iffl::numa_topology const &topology{ iffl::numa_topology::system() };
+    FFL_CODDING_ERROR_IF_NOT(std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }) == iffl::numa_parse_list("0-3,8,10-11\n"));
+    allocate_on_numa_nodes(topology);
+    for (unsigned int concurrency : { 1u, 4u, 0u }) {
+        scan_numa_eas(topology, concurrency);
+    }
+    //
+    // Emulate two nodes that share CPUs of the first node
+    //
+    iffl::numa_topology const emulated{ { topology.node_cpus(0), topology.node_cpus(0) },
+                                        [](void const *ptr) noexcept -> size_t {
+                                            return reinterpret_cast<uintptr_t>(ptr) / 4096 % 2;
+                                        } };
+    for (unsigned int concurrency : { 1u, 3u, 0u }) {
+        scan_numa_eas(emulated, concurrency);
+    }
+}
+
+#else
+
+void run_ffl_numa_usecase() {
+    std::printf("NUMA helpers are not supported on this platform\n");
+}
+
+#endif
@@ -0,0 +1,249 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_parallel_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_parallel.h>
+#include <numeric>
+
+//
+//  This sample demonstrates how to process elements of a list
+//  on multiple threads.
+//
+//  split_eas checks that list is split into chunks that cover
+//  every element exactly once.
+//
+//  checksum_eas calculates checksum of extended attributes with
+//  parallel_transform_reduce and parallel_for_each, and compares it
+//  with checksum calculated on a single thread.
+//
+//  count_arrays counts elements of a view that match a filter
+//  with parallel_count_if.
+//
+//  checksum_ea_batches processes a collection of lists of very
+//  different sizes with parallel_for_each_in_lists and
+//  parallel_for_each_view_in_lists, and checks that every element
+//  of every list was visited exactly once.
+//
+//  validate_ea_buffers validates many small buffers, some of them
+//  truncated, with flat_forward_list_validate_batch, and compares
+//  results with flat_forward_list_validate called on each buffer.
+//
+
+ea_iffl make_parallel_eas(size_t ea_count) {
+    ea_iffl eas;
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        //
+        // Some elements are much larger than others
+        //
+        size_t const value_length{ 0 == idx % 100 ? 1000 : idx % 13 };
+        emplace_back_ea(eas,
+                        1,
+                        value_length,
+                        [idx, value_length](char *name) noexcept {
+                            name[0] = 'a';
+                            for (size_t i = 0; i < value_length; ++i) {
+                                name[1 + i] = static_cast<char>(idx + i);
+                            }
+                        });
+    }
+    return eas;
+}
+
+void split_eas(ea_iffl const &eas, size_t chunk_count) {
+    auto const boundaries{ iffl::flat_forward_list_split(eas.cbegin(), eas.cend(), chunk_count) };
+    FFL_CODDING_ERROR_IF(eas.empty() != boundaries.empty());
+    if (eas.empty()) {
+        return;
+    }
+    FFL_CODDING_ERROR_IF_NOT(boundaries.size() <= chunk_count + 1);
+    FFL_CODDING_ERROR_IF_NOT(boundaries.front() == eas.cbegin());
+    FFL_CODDING_ERROR_IF_NOT(boundaries.back() == eas.cend());
+    size_t element_count{ 0 };
+    for (size_t chunk = 0; chunk + 1 < boundaries.size(); ++chunk) {
+        size_t const chunk_element_count{ static_cast<size_t>(std::distance(boundaries[chunk], boundaries[chunk + 1])) };
+        FFL_CODDING_ERROR_IF(0 == chunk_element_count);
+        element_count += chunk_element_count;
+    }
+    FFL_CODDING_ERROR_IF_NOT(eas.size() == element_count);
+}
+
+void checksum_eas(ea_iffl const &eas, unsigned int concurrency) {
+    size_t expected_checksum{ 0 };
+    for (FILE_FULL_EA_INFORMATION const &e : eas) {
+        expected_checksum += ea_checksum(e);
+    }
+
+    size_t const checksum{ iffl::parallel_transform_reduce(eas,
+                                                           size_t{ 0 },
+                                                           std::plus<size_t>{},
+                                                           ea_checksum,
+                                                           concurrency) };
+    FFL_CODDING_ERROR_IF_NOT(expected_checksum == checksum);
+
+    std::atomic<size_t> for_each_checksum{ 0 };
+    std::atomic<size_t> for_each_count{ 0 };
+    iffl::parallel_for_each(eas,
+                            [&for_each_checksum, &for_each_count](FILE_FULL_EA_INFORMATION const &e) noexcept {
+                                for_each_checksum += ea_checksum(e);
+                                ++for_each_count;
+                            },
+                            concurrency);
+    FFL_CODDING_ERROR_IF_NOT(expected_checksum == for_each_checksum);
+    FFL_CODDING_ERROR_IF_NOT(eas.size() == for_each_count);
+
+    std::printf("Checksum of %zu elements on %u threads is %zu\n",
+                eas.size(),
+                concurrency,
+                checksum);
+}
+
+void count_arrays(unsigned int concurrency) {
+    char_array_list data;
+    for (unsigned short idx = 0; idx < 500; ++idx) {
+        unsigned short const array_size{ static_cast<unsigned short>(idx % 17) };
+        data.emplace_back(char_array_list_entry::byte_size_to_array_size(array_size),
+                          [array_size](char_array_list_entry &e, size_t) noexcept {
+                              e.length = array_size;
+                              std::fill(e.arr, e.arr + e.length, static_cast<char>(array_size));
+                          });
+    }
+    //
+    // Skip first few elements
+    //
+    char_array_list_view const view{ std::next(data.cbegin(), 10), data.clast() };
+    auto const is_long{ [](char_array_list_entry const &e) noexcept {
+        return 8 < e.length;
+    } };
+    size_t const count{ iffl::parallel_count_if(view, is_long, concurrency) };
+    FFL_CODDING_ERROR_IF_NOT(static_cast<size_t>(std::count_if(view.begin(), view.end(), is_long)) == count);
+    std::printf("%zu of %zu arrays are longer than 8\n",
+                count,
+                view.size());
+}
+
+void checksum_ea_batches(std::vector<ea_iffl> const &batches, unsigned int concurrency) {
+    std::vector<size_t> expected_checksums;
+    std::vector<size_t> expected_counts;
+    for (ea_iffl const &eas : batches) {
+        size_t checksum{ 0 };
+        for (FILE_FULL_EA_INFORMATION const &e : eas) {
+            checksum += ea_checksum(e);
+        }
+        expected_checksums.push_back(checksum);
+        expected_counts.push_back(eas.size());
+    }
+
+    auto const tasks{ iffl::flat_forward_list_split_lists(batches.begin(),
+                                                          batches.end(),
+                                                          16) };
+    size_t segment_elements{ 0 };
+    for (auto const &segment : tasks.segments) {
+        FFL_CODDING_ERROR_IF(segment.view.empty());
+        FFL_CODDING_ERROR_IF_NOT(segment.list_index < batches.size());
+        segment_elements += segment.view.size();
+    }
+    FFL_CODDING_ERROR_IF_NOT(std::accumulate(expected_counts.begin(), expected_counts.end(), size_t{ 0 }) ==
+                             segment_elements);
+
+    std::vector<std::atomic<size_t>> checksums(batches.size());
+    std::vector<std::atomic<size_t>> counts(batches.size());
+    iffl::parallel_for_each_in_lists(batches,
+                                     [&checksums, &counts](size_t list_index,
+                                                           FILE_FULL_EA_INFORMATION const &e) noexcept {
+                                         checksums[list_index] += ea_checksum(e);
+                                         ++counts[list_index];
+                                     },
+                                     concurrency);
+    std::vector<std::atomic<size_t>> view_counts(batches.size());
+    iffl::parallel_for_each_view_in_lists(batches,
+                                          [&view_counts](size_t list_index,
+                                                         iffl::parallel_list_view_t<ea_iffl> const &view) noexcept {
+                                              view_counts[list_index] += view.size();
+                                          },
+                                          concurrency);
+    for (size_t idx = 0; idx < batches.size(); ++idx) {
+        FFL_CODDING_ERROR_IF_NOT(expected_checksums[idx] == checksums[idx]);
+        FFL_CODDING_ERROR_IF_NOT(expected_counts[idx] == counts[idx]);
+        FFL_CODDING_ERROR_IF_NOT(expected_counts[idx] == view_counts[idx]);
+    }
+
+    std::printf("Processed %zu batches split into %zu tasks on %u threads\n",
+                batches.size(),
+                tasks.task_count(),
+                concurrency);
+}
+
+void validate_ea_buffers(std::vector<ea_iffl> const &batches, unsigned int concurrency) {
+    std::vector<iffl::flat_forward_list_buffer> buffers;
+    for (size_t idx = 0; idx < batches.size(); ++idx) {
+        ea_iffl const &eas{ batches[idx] };
+        size_t size{ eas.used_capacity() };
+        //
+        // Cut every third non-empty buffer in the
+        // middle of the last element
+        //
+        if (0 == idx % 3 && 3 < size) {
+            size -= 3;
+        }
+        buffers.push_back(iffl::flat_forward_list_buffer{ eas.data(), size });
+    }
+
+    auto const results{ iffl::flat_forward_list_validate_batch<FILE_FULL_EA_INFORMATION>(buffers, concurrency) };
+    FFL_CODDING_ERROR_IF_NOT(results.size() == buffers.size());
+    size_t valid_count{ 0 };
+    for (size_t idx = 0; idx < buffers.size(); ++idx) {
+        auto const [is_valid, view] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(buffers[idx].begin,
+                                                                                                 buffers[idx].begin + buffers[idx].size);
+        FFL_CODDING_ERROR_IF_NOT(is_valid == results[idx].is_valid);
+        FFL_CODDING_ERROR_IF_NOT(view.data() == results[idx].view.data());
+        FFL_CODDING_ERROR_IF_NOT(view.size() == results[idx].view.size());
+        valid_count += is_valid ? 1 : 0;
+    }
+    std::printf("Validated %zu buffers on %u threads, %zu are valid\n",
+                buffers.size(),
+                concurrency,
+                valid_count);
+}
+
+void run_ffl_parallel_usecase() {
+    ea_iffl const eas{ make_parallel_eas(5000) };
+    split_eas(eas, 1);
+    split_eas(eas, 16);
+    split_eas(eas, 10000);
+    split_eas(ea_iffl{}, 4);
+
+    for (unsigned int concurrency : { 1u, 4u, 7u, 0u }) {
+        checksum_eas(eas, concurrency);
+    }
+    checksum_eas(ea_iffl{}, 4);
+    count_arrays(3);
+
+    //
+    // Batches of very uneven sizes, including
+    // empty batches, and one batch that is
+    // larger than all others together
+    //
+    std::vector<ea_iffl> batches;
+    for (size_t idx = 0; idx < 200; ++idx) {
+        batches.push_back(make_parallel_eas(0 == idx % 10 ? 0 : idx % 7));
+    }
+    batches.push_back(make_parallel_eas(3000));
+    batches.push_back(ea_iffl{});
+    for (unsigned int concurrency : { 1u, 4u, 7u, 0u }) {
+        checksum_ea_batches(batches, concurrency);
+    }
+    checksum_ea_batches(std::vector<ea_iffl>{}, 4);
+
+    for (unsigned int concurrency : { 1u, 4u, 0u }) {
+        validate_ea_buffers(batches, concurrency);
+    }
+    //
+    // Large enough batch to be validated on several threads
+    //
+    std::vector<ea_iffl> large_batches;
+    for (size_t idx = 0; idx < 64; ++idx) {
+        large_batches.push_back(make_parallel_eas(200 + idx));
+    }
+    validate_ea_buffers(large_batches, 4);
+    validate_ea_buffers(std::vector<ea_iffl>{}, 4);
+}
@@ -0,0 +1,176 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_shm_ring_usecase.h"
+#include "iffl_list_array.h"
+#include <iffl_shm_ring.h>
+
+#if defined(FFL_HAS_SHM_RING)
+#include <sys/wait.h>
+#include <chrono>
+#include <thread>
+#endif
+
+//
+//  This sample demonstrates how to pass elements between
+//  processes through a ring in shared memory.
+//
+//  wrap_ring_of_arrays fills a small ring, and drains it in steps
+//  so elements wrap around the end of the ring many times.
+//
+//  measure_shm_ring_throughput starts a consumer process that reads
+//  extended attributes from the ring, and checks every element, while
+//  this process produces them.
+//
+
+#if defined(FFL_HAS_SHM_RING)
+
+void make_shm_ring_name(char *name, size_t name_size, char const *suffix) noexcept {
+    std::snprintf(name, name_size, "/iffl_ring_%ld_%s", static_cast<long>(getpid()), suffix);
+}
+
+void wrap_ring_of_arrays() {
+    char ring_name[64];
+    make_shm_ring_name(ring_name, sizeof(ring_name), "arrays");
+    iffl::shm_flat_forward_list_ring<char_array_list_entry> producer{ ring_name, 100 };
+    iffl::shm_flat_forward_list_ring<char_array_list_entry> consumer{ ring_name };
+    FFL_CODDING_ERROR_IF_NOT(0 == iffl::shm_flat_forward_list_ring<char_array_list_entry>::remove(ring_name));
+
+    unsigned short next_produced{ 0 };
+    unsigned short next_consumed{ 0 };
+    size_t view_count{ 0 };
+    while (next_consumed < 500) {
+        //
+        // Fill the ring
+        //
+        while (next_produced < 500) {
+            unsigned short const array_size{ static_cast<unsigned short>(next_produced % 29) };
+            bool const added{ producer.try_emplace_back(char_array_list_entry::byte_size_to_array_size(array_size),
+                                                        [array_size](char_array_list_entry &e, size_t) noexcept {
+                                                            e.length = array_size;
+                                                            std::fill(e.arr, e.arr + e.length, static_cast<char>(array_size));
+                                                        }) };
+            if (!added) {
+                break;
+            }
+            ++next_produced;
+        }
+        //
+        // Views never cross end of the ring, so it might
+        // take two reads to drain it
+        //
+        for (size_t idx = 0; idx < 2; ++idx) {
+            char_array_list_view const view{ consumer.try_read() };
+            for (char_array_list_entry const &e : view) {
+                FFL_CODDING_ERROR_IF_NOT(e.length == next_consumed % 29);
+                FFL_CODDING_ERROR_IF_NOT(std::all_of(e.arr,
+                                                     e.arr + e.length,
+                                                     [&e](char c) noexcept { return c == static_cast<char>(e.length); }));
+                ++next_consumed;
+            }
+            view_count += view.empty() ? 0 : 1;
+            consumer.release();
+        }
+        FFL_CODDING_ERROR_IF_NOT(next_produced == next_consumed);
+    }
+    FFL_CODDING_ERROR_IF_NOT(consumer.try_read().empty());
+    std::printf("Passed %hu arrays through ring of %zu bytes in %zu views\n",
+                next_consumed,
+                consumer.capacity(),
+                view_count);
+}
+
+size_t shm_ea_value_length(size_t seq) noexcept {
+    return seq % 64;
+}
+
+int consume_shm_eas(char const *ring_name, size_t ea_count) noexcept {
+    try {
+        iffl::shm_flat_forward_list_ring<FILE_FULL_EA_INFORMATION> ring{ ring_name };
+        for (size_t seq = 0; seq < ea_count;) {
+            auto const view{ ring.try_read() };
+            if (view.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (FILE_FULL_EA_INFORMATION const &e : view) {
+                if (e.EaValueLength != shm_ea_value_length(seq) ||
+                    0 != std::memcmp(e.EaName, &seq, sizeof(seq))) {
+                    return 1;
+                }
+                ++seq;
+            }
+            ring.release();
+        }
+    } catch (...) {
+        return 2;
+    }
+    return 0;
+}
+
+void measure_shm_ring_throughput(size_t ea_count) {
+    char ring_name[64];
+    make_shm_ring_name(ring_name, sizeof(ring_name), "eas");
+    iffl::shm_flat_forward_list_ring<FILE_FULL_EA_INFORMATION> ring{ ring_name, 256 * 1024 };
+
+    auto const start{ std::chrono::steady_clock::now() };
+    pid_t const consumer_pid{ fork() };
+    FFL_CODDING_ERROR_IF(consumer_pid < 0);
+    if (0 == consumer_pid) {
+        _exit(consume_shm_eas(ring_name, ea_count));
+    }
+
+    int status{ 0 };
+    size_t bytes_sent{ 0 };
+    for (size_t seq = 0; seq < ea_count;) {
+        size_t const value_length{ shm_ea_value_length(seq) };
+        size_t const element_size{ ea_size(sizeof(seq), value_length) };
+        bool const added{ try_emplace_back_ea(ring,
+                                              sizeof(seq),
+                                              value_length,
+                                              [seq, value_length](char *name) noexcept {
+                                                  iffl::copy_data(name, reinterpret_cast<char const *>(&seq), sizeof(seq));
+                                                  std::fill(name + sizeof(seq),
+                                                            name + sizeof(seq) + value_length,
+                                                            static_cast<char>(seq));
+                                              }) };
+        if (!added) {
+            //
+            // Consumer that failed a check exits, and ring
+            // stays full. Fail instead of waiting forever.
+            //
+            if (consumer_pid == waitpid(consumer_pid, &status, WNOHANG)) {
+                iffl::shm_flat_forward_list_ring<FILE_FULL_EA_INFORMATION>::remove(ring_name);
+                std::printf("Consumer exited with status %d after %zu elements\n", status, seq);
+                std::fflush(stdout);
+                FFL_CRASH_APPLICATION();
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        bytes_sent += element_size;
+        ++seq;
+    }
+
+    FFL_CODDING_ERROR_IF_NOT(consumer_pid == waitpid(consumer_pid, &status, 0));
+    auto const duration{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+    FFL_CODDING_ERROR_IF_NOT(0 == iffl::shm_flat_forward_list_ring<FILE_FULL_EA_INFORMATION>::remove(ring_name));
+    FFL_CODDING_ERROR_IF_NOT(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+    std::printf("Passed %zu elements, %zu bytes to another process in %lld us, %.1f MB/s\n",
+                ea_count,
+                bytes_sent,
+                static_cast<long long>(duration.count()),
+                duration.count() ? static_cast<double>(bytes_sent) / static_cast<double>(duration.count()) : 0.0);
+}
+
+void run_ffl_shm_ring_usecase() {
+    wrap_ring_of_arrays();
+    measure_shm_ring_throughput(1000000);
+}
+
+#else
+
+void run_ffl_shm_ring_usecase() {
+    std::printf("Shared memory ring is not supported on this platform\n");
+}
+
+#endif
@@ -0,0 +1,207 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_small_list_usecase.h"
+
+//
+//  This sample demonstrates list that keeps short lists of
+//  extended attributes in the inline buffer, and allocates
+//  buffer only when extended attributes do not fit.
+//
+//  grow_and_shrink_small_list checks when container allocates, 
+//  and when it moves elements back to the inline buffer.
+//
+//  move_and_detach_small_list checks that copy, move, swap, and detach
+//  work for elements in the inline buffer and in the heap buffer.
+//
+//  sort_and_merge_small_list checks that methods that rebuild the
+//  list keep elements in the inline buffer.
+//
+
+#include <algorithm>
+
+using small_ea_list = iffl::pmr_small_flat_forward_list<FILE_FULL_EA_INFORMATION, 256>;
+
+void append_small_list_eas(small_ea_list &eas, size_t first_idx, size_t ea_count) {
+    for (size_t idx = first_idx; idx < first_idx + ea_count; ++idx) {
+        emplace_back_ea(eas,
+                        1,
+                        8,
+                        [idx](char *name) noexcept {
+                            name[0] = 'n';
+                            std::fill(name + 1, name + 1 + 8, static_cast<char>(idx));
+                        });
+    }
+}
+
+void grow_and_shrink_small_list() {
+    iffl::debug_memory_resource resource;
+    {
+        small_ea_list eas{ &resource };
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(eas.empty());
+        FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+        //
+        // Each element takes 20 bytes with padding, so 12 elements fit
+        //
+        append_small_list_eas(eas, 0, 12);
+        FFL_CODDING_ERROR_IF_NOT(12 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+
+        append_small_list_eas(eas, 12, 20);
+        FFL_CODDING_ERROR_IF_NOT(32 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(!eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+        size_t const checksum{ ea_list_checksum(eas) };
+
+        eas.sort([](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+            return lhs.EaName[1] > rhs.EaName[1];
+        });
+        FFL_CODDING_ERROR_IF_NOT(31 == eas.begin()->EaName[1]);
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+        eas.sort([](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+            return lhs.EaName[1] < rhs.EaName[1];
+        });
+        FFL_CODDING_ERROR_IF_NOT(checksum == ea_list_checksum(eas));
+
+        while (eas.size() > 10) {
+            eas.pop_back();
+        }
+        FFL_CODDING_ERROR_IF_NOT(!eas.is_inline());
+        eas.shrink_to_fit();
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+        FFL_CODDING_ERROR_IF_NOT(10 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+
+        eas.resize_buffer(100);
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(5 == eas.size());
+        eas.resize_buffer(1000);
+        FFL_CODDING_ERROR_IF_NOT(!eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(5 == eas.size());
+        eas.clear();
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+    }
+    std::printf("Small list allocated only when elements did not fit inline buffer\n");
+}
+
+void move_and_detach_small_list() {
+    iffl::debug_memory_resource resource;
+    {
+        small_ea_list inline_eas{ &resource };
+        append_small_list_eas(inline_eas, 0, 5);
+        small_ea_list heap_eas{ &resource };
+        append_small_list_eas(heap_eas, 100, 50);
+        size_t const inline_checksum{ ea_list_checksum(inline_eas) };
+        size_t const heap_checksum{ ea_list_checksum(heap_eas) };
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+
+        //
+        // Copies use allocator returned by select_on_container_copy_construction
+        //
+        small_ea_list const inline_copy{ inline_eas };
+        small_ea_list const heap_copy{ heap_eas };
+        FFL_CODDING_ERROR_IF_NOT(inline_copy.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(!heap_copy.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(inline_checksum == ea_list_checksum(inline_copy));
+        FFL_CODDING_ERROR_IF_NOT(heap_checksum == ea_list_checksum(heap_copy));
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+
+        char const *const heap_buffer{ heap_eas.data() };
+        small_ea_list moved_heap{ std::move(heap_eas) };
+        FFL_CODDING_ERROR_IF_NOT(heap_buffer == moved_heap.data());
+        FFL_CODDING_ERROR_IF_NOT(heap_eas.empty() && heap_eas.is_inline());
+
+        small_ea_list moved_inline{ std::move(inline_eas) };
+        FFL_CODDING_ERROR_IF_NOT(moved_inline.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(inline_checksum == ea_list_checksum(moved_inline));
+        FFL_CODDING_ERROR_IF_NOT(inline_eas.empty());
+
+        swap(moved_inline, moved_heap);
+        FFL_CODDING_ERROR_IF_NOT(moved_heap.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(inline_checksum == ea_list_checksum(moved_heap));
+        FFL_CODDING_ERROR_IF_NOT(heap_buffer == moved_inline.data());
+        FFL_CODDING_ERROR_IF_NOT(heap_checksum == ea_list_checksum(moved_inline));
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+
+        inline_eas = moved_heap;
+        FFL_CODDING_ERROR_IF_NOT(inline_eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(inline_checksum == ea_list_checksum(inline_eas));
+
+        //
+        // Detach copies elements from inline buffer
+        //
+        iffl::buffer_ref const detached{ moved_heap.detach() };
+        FFL_CODDING_ERROR_IF_NOT(moved_heap.empty() && moved_heap.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(2 == resource.get_busy_blocks_count());
+        iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION> attached{ iffl::attach_buffer{},
+                                                                        detached.begin,
+                                                                        detached.last,
+                                                                        detached.end,
+                                                                        &resource };
+        FFL_CODDING_ERROR_IF_NOT(5 == attached.size());
+        FFL_CODDING_ERROR_IF_NOT(5 == inline_eas.size());
+    }
+    std::printf("Small list copied, moved, swapped and detached inline and heap buffers\n");
+}
+
+void sort_and_merge_small_list() {
+    iffl::debug_memory_resource resource;
+    {
+        small_ea_list eas{ &resource };
+        append_small_list_eas(eas, 0, 3);
+        size_t const checksum{ ea_list_checksum(eas) };
+
+        eas.sort([](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+            return lhs.EaName[1] > rhs.EaName[1];
+        });
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+        FFL_CODDING_ERROR_IF_NOT(2 == eas.begin()->EaName[1]);
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+
+        eas.assign(eas.cbegin(), eas.clast());
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(3 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+
+        eas.sort([](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+            return lhs.EaName[1] < rhs.EaName[1];
+        });
+        FFL_CODDING_ERROR_IF_NOT(checksum == ea_list_checksum(eas));
+
+        small_ea_list other_eas{ &resource };
+        append_small_list_eas(other_eas, 3, 3);
+        eas.merge(other_eas,
+                  [](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+                      return lhs.EaName[1] < rhs.EaName[1];
+                  });
+        FFL_CODDING_ERROR_IF_NOT(6 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(other_eas.empty() && other_eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(256 == other_eas.total_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == resource.get_busy_blocks_count());
+
+        //
+        // Merged list that does not fit stays in the heap buffer
+        //
+        append_small_list_eas(other_eas, 6, 10);
+        eas.merge(other_eas,
+                  [](FILE_FULL_EA_INFORMATION const &lhs, FILE_FULL_EA_INFORMATION const &rhs) noexcept {
+                      return lhs.EaName[1] < rhs.EaName[1];
+                  });
+        FFL_CODDING_ERROR_IF_NOT(16 == eas.size());
+        FFL_CODDING_ERROR_IF_NOT(!eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(other_eas.is_inline());
+        FFL_CODDING_ERROR_IF_NOT(1 == resource.get_busy_blocks_count());
+    }
+    std::printf("Small list kept sorted and merged elements in the inline buffer\n");
+}
+
+void run_ffl_small_list_usecase() {
+    grow_and_shrink_small_list();
+    move_and_detach_small_list();
+    sort_and_merge_small_list();
+}
@@ -0,0 +1,125 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_static_list_usecase.h"
+
+//
+//  This sample demonstrates list with a fixed buffer that
+//  is a part of the container.
+//
+//  fill_static_list checks that try_* methods fail when
+//  element does not fit, and container is not changed.
+//
+//  copy_static_list checks that copy, swap, and try_assign
+//  copy elements between buffers.
+//
+
+#include <algorithm>
+
+using static_ea_list = iffl::static_flat_forward_list<FILE_FULL_EA_INFORMATION, 256>;
+
+//
+// Metadata is three pointers, and there is no allocator
+//
+static_assert(sizeof(static_ea_list) - static_ea_list::static_capacity <= 64);
+
+bool try_append_static_list_ea(static_ea_list &eas, size_t idx) noexcept {
+    return try_emplace_back_ea(eas,
+                               1,
+                               8,
+                               [idx](char *name) noexcept {
+                                   name[0] = 's';
+                                   std::fill(name + 1, name + 1 + 8, static_cast<char>(idx));
+                               });
+}
+
+void fill_static_list() {
+    static_ea_list eas;
+    FFL_CODDING_ERROR_IF_NOT(eas.empty());
+    FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+    FFL_CODDING_ERROR_IF_NOT(0 == reinterpret_cast<uintptr_t>(eas.data()) % alignof(FILE_FULL_EA_INFORMATION));
+    //
+    // Each element takes 20 bytes with padding, and last element
+    // does not need padding, so 12 elements fit
+    //
+    size_t idx{ 0 };
+    while (try_append_static_list_ea(eas, idx)) {
+        ++idx;
+    }
+    FFL_CODDING_ERROR_IF_NOT(12 == idx);
+    FFL_CODDING_ERROR_IF_NOT(12 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+    size_t const checksum{ ea_list_checksum(eas) };
+    //
+    // Failed insert does not change container
+    //
+    FFL_CODDING_ERROR_IF(eas.try_push_front(eas.remaining_capacity() + 1));
+    FFL_CODDING_ERROR_IF_NOT(checksum == ea_list_checksum(eas));
+
+    eas.pop_front();
+    eas.pop_back();
+    FFL_CODDING_ERROR_IF_NOT(10 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(1 == eas.begin()->EaName[1]);
+    FFL_CODDING_ERROR_IF_NOT(10 == eas.last()->EaName[1]);
+
+    eas.remove_if([](FILE_FULL_EA_INFORMATION const &e) noexcept {
+        return 0 != e.EaName[1] % 2;
+    });
+    FFL_CODDING_ERROR_IF_NOT(5 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(try_append_static_list_ea(eas, 100));
+    FFL_CODDING_ERROR_IF_NOT(6 == eas.size());
+
+    eas.clear();
+    FFL_CODDING_ERROR_IF_NOT(eas.empty());
+    FFL_CODDING_ERROR_IF_NOT(256 == eas.total_capacity());
+
+    std::printf("Static list added elements until buffer was full\n");
+}
+
+void copy_static_list() {
+    static_ea_list eas;
+    for (size_t idx = 0; idx < 7; ++idx) {
+        FFL_CODDING_ERROR_IF_NOT(try_append_static_list_ea(eas, idx));
+    }
+    size_t const checksum{ ea_list_checksum(eas) };
+
+    static_ea_list copy{ eas };
+    FFL_CODDING_ERROR_IF(copy.data() == eas.data());
+    FFL_CODDING_ERROR_IF_NOT(checksum == ea_list_checksum(copy));
+
+    static_ea_list other;
+    FFL_CODDING_ERROR_IF_NOT(try_append_static_list_ea(other, 50));
+    swap(copy, other);
+    FFL_CODDING_ERROR_IF_NOT(1 == copy.size());
+    FFL_CODDING_ERROR_IF_NOT(checksum == ea_list_checksum(other));
+    //
+    // Copy elements from a heap list when they fit
+    //
+    iffl::flat_forward_list<FILE_FULL_EA_INFORMATION> heap_eas;
+    for (size_t idx = 0; idx < 4; ++idx) {
+        heap_eas.emplace_back(FFL_SIZE_THROUGH_FIELD(FILE_FULL_EA_INFORMATION, EaValueLength) + 1 + 8,
+                              [idx](FILE_FULL_EA_INFORMATION &e, size_t) noexcept {
+                                  e.Flags = 0;
+                                  e.EaNameLength = 1;
+                                  e.EaValueLength = 8;
+                                  e.EaName[0] = 'h';
+                                  e.EaName[1] = static_cast<char>(idx);
+                              });
+    }
+    FFL_CODDING_ERROR_IF_NOT(copy.try_assign(iffl::flat_forward_list_view<FILE_FULL_EA_INFORMATION>{ heap_eas.cbegin(), heap_eas.clast() }));
+    FFL_CODDING_ERROR_IF_NOT(4 == copy.size());
+    FFL_CODDING_ERROR_IF_NOT('h' == copy.begin()->EaName[0]);
+
+    heap_eas.resize_buffer(1024);
+    for (size_t idx = 4; idx < 20; ++idx) {
+        heap_eas.push_back(heap_eas.required_size(heap_eas.begin()), reinterpret_cast<char const *>(&*heap_eas.begin()));
+    }
+    FFL_CODDING_ERROR_IF(copy.try_assign(iffl::flat_forward_list_view<FILE_FULL_EA_INFORMATION>{ heap_eas.cbegin(), heap_eas.clast() }));
+    FFL_CODDING_ERROR_IF_NOT(4 == copy.size());
+
+    std::printf("Static list copied elements between buffers\n");
+}
+
+void run_ffl_static_list_usecase() {
+    fill_static_list();
+    copy_static_list();
+}
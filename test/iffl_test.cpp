@@ -4,6 +4,21 @@
 #include "iffl_c_api_usecase2.h"
 #include "iffl_views.h"
 #include "iffl_unaligned.h"
+#include "iffl_mapped_file_usecase.h"
+#include "iffl_io_usecase.h"
+#include "iffl_concurrent_usecase.h"
+#include "iffl_parallel_usecase.h"
+#include "iffl_shm_ring_usecase.h"
+#include "iffl_coroutine_usecase.h"
+#include "iffl_numa_usecase.h"
+#include "iffl_traits_builder_usecase.h"
+#include "iffl_fixed_size_usecase.h"
+#include "iffl_small_list_usecase.h"
+#include "iffl_static_list_usecase.h"
+#include "iffl_constexpr_list_usecase.h"
+#include "iffl_variant_list_usecase.h"
+#include "iffl_nested_list_usecase.h"
+#include "iffl_compact_usecase.h"
 
 #include <cstdio>
 
@@ -21,6 +36,36 @@ int main() {
     run_ffl_views();
     std::printf("\n--- Starting unaligned use-case ----\n\n");
     run_ffl_unaligned();
+    std::printf("\n--- Starting mapped file use-case --\n\n");
+    run_ffl_mapped_file_usecase();
+    std::printf("\n------ Starting file IO use-case ---\n\n");
+    run_ffl_io_usecase();
+    std::printf("\n----- Starting concurrent use-case -\n\n");
+    run_ffl_concurrent_usecase();
+    std::printf("\n------ Starting parallel use-case --\n\n");
+    run_ffl_parallel_usecase();
+    std::printf("\n---- Starting shared memory use-case \n\n");
+    run_ffl_shm_ring_usecase();
+    std::printf("\n----- Starting coroutine use-case --\n\n");
+    run_ffl_coroutine_usecase();
+    std::printf("\n-------- Starting NUMA use-case ----\n\n");
+    run_ffl_numa_usecase();
+    std::printf("\n--- Starting traits builder use-case\n\n");
+    run_ffl_traits_builder_usecase();
+    std::printf("\n------ Starting fixed size use-case\n\n");
+    run_ffl_fixed_size_usecase();
+    std::printf("\n------ Starting small list use-case\n\n");
+    run_ffl_small_list_usecase();
+    std::printf("\n------ Starting static list use-case\n\n");
+    run_ffl_static_list_usecase();
+    std::printf("\n--- Starting constexpr list use-case\n\n");
+    run_ffl_constexpr_list_usecase();
+    std::printf("\n---- Starting variant list use-case \n\n");
+    run_ffl_variant_list_usecase();
+    std::printf("\n----- Starting nested list use-case \n\n");
+    run_ffl_nested_list_usecase();
+    std::printf("\n---------- Starting compact use-case\n\n");
+    run_ffl_compact_usecase();
     std::printf("\n--------- Tests Complete -----------\n\n");
     return 0;
 }
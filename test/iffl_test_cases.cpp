@@ -579,6 +579,25 @@ void flat_forward_list_detach_attach_test3() {
     FFL_CODDING_ERROR_IF_NOT(element_count == ffl2.size());
 }
 
+void flat_forward_list_detach_attach_test4() {
+
+    iffl::debug_memory_resource dbg_memory_resource1;
+    iffl::pmr_flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl1{ &dbg_memory_resource1 };
+    //
+    // In a single element list first element is also the last element
+    //
+    ffl1.push_back(sizeof(FLAT_FORWARD_LIST_TEST));
+
+    iffl::pmr_flat_forward_list<FLAT_FORWARD_LIST_TEST> ffl2{ &dbg_memory_resource1 };
+
+    iffl::buffer_ref buff{ ffl1.detach() };
+    FFL_CODDING_ERROR_IF_NOT(buff.begin == buff.last);
+
+    FFL_CODDING_ERROR_IF_NOT(ffl2.attach(buff.begin, buff.size()));
+
+    FFL_CODDING_ERROR_IF_NOT(1 == ffl2.size());
+}
+
 void flat_forward_list_resize_elements_test1() {
 
     iffl::debug_memory_resource dbg_memory_resource;
@@ -843,11 +862,18 @@ void flat_forward_list_erase_range_test1() {
     auto element1_it = element0_it + 1;
     auto const element2_it = element1_it + 1;
     [[maybe_unused]] auto const last_it = ffl.last();
+    //
+    // Elements after erased range must be moved with
+    // all their data
+    //
+    size_t const last_element_size{ ffl.required_size(last_it) };
+    std::vector<char> const last_element{ last_it.get_ptr(), last_it.get_ptr() + last_element_size };
 
     ffl.erase(element1_it, element2_it);
 
     elements_count = ffl.size();
     FFL_CODDING_ERROR_IF_NOT(elements_count == prev_elements_count - 1);
+    FFL_CODDING_ERROR_IF_NOT(std::equal(last_element.begin(), last_element.end(), ffl.last().get_ptr()));
     prev_elements_count = elements_count;
 
     element1_it = element0_it + 1;
@@ -1265,6 +1291,7 @@ void run_all_flat_forward_list_tests() {
     flat_forward_list_detach_attach_test1();
     flat_forward_list_detach_attach_test2();
     flat_forward_list_detach_attach_test3();
+    flat_forward_list_detach_attach_test4();
     flat_forward_list_resize_elements_test1();
     flat_forward_list_find_by_offset_test1();
     flat_forward_list_erase_range_test1();
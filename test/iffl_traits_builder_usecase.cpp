@@ -0,0 +1,131 @@
+#include "iffl.h"
+#include "iffl_ea.h"
+#include "iffl_list_array.h"
+#include "iffl_traits_builder_usecase.h"
+
+//
+//  This sample demonstrates how to generate traits from pointers
+//  to members instead of writing them by hand.
+//
+//  builder_ea_traits describes FILE_FULL_EA_INFORMATION, and
+//  builder_char_array_traits describes char_array_list_entry that
+//  does not have offset to the next element. Both are passed to
+//  containers explicitly, so hand-written traits from iffl_ea.h and
+//  iffl_list_array.h stay default for these types.
+//
+//  compare_ea_validation and compare_char_array_validation corrupt
+//  buffers, and check that generated and hand-written traits agree
+//  on every buffer.
+//
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+struct builder_ea_traits
+    : public iffl::flat_forward_list_traits_builder<FILE_FULL_EA_INFORMATION,
+                                                    offsetof(FILE_FULL_EA_INFORMATION, EaName),
+                                                    iffl::flat_forward_list_next_offset_field<&FILE_FULL_EA_INFORMATION::NextEntryOffset>,
+                                                    iffl::flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaNameLength>,
+                                                    iffl::flat_forward_list_length_field<&FILE_FULL_EA_INFORMATION::EaValueLength>> {
+};
+
+struct builder_char_array_traits
+    : public iffl::flat_forward_list_traits_builder<char_array_list_entry,
+                                                    offsetof(char_array_list_entry, arr),
+                                                    iffl::flat_forward_list_no_next_offset,
+                                                    iffl::flat_forward_list_length_field<&char_array_list_entry::length, sizeof(char)>> {
+};
+
+using builder_ea_traits_traits = iffl::flat_forward_list_traits_traits<FILE_FULL_EA_INFORMATION, builder_ea_traits>;
+using builder_char_array_traits_traits = iffl::flat_forward_list_traits_traits<char_array_list_entry, builder_char_array_traits>;
+
+static_assert(builder_ea_traits_traits::has_next_offset_v);
+static_assert(builder_ea_traits_traits::has_get_size_v);
+static_assert(!builder_char_array_traits_traits::has_next_offset_v);
+
+constexpr FILE_FULL_EA_INFORMATION builder_constexpr_ea{ 16, 0, 3, 4, { 'n' } };
+static_assert(builder_ea_traits::minimum_size() == 8);
+static_assert(builder_ea_traits::get_size(builder_constexpr_ea) == 15);
+static_assert(builder_ea_traits::validate(16, builder_constexpr_ea));
+static_assert(!builder_ea_traits::validate(15, builder_constexpr_ea));
+
+using builder_ea_list = iffl::pmr_flat_forward_list<FILE_FULL_EA_INFORMATION, builder_ea_traits>;
+using builder_char_array_list = iffl::pmr_flat_forward_list<char_array_list_entry, builder_char_array_traits>;
+
+void fill_builder_eas(builder_ea_list &eas, size_t ea_count) {
+    for (size_t idx = 0; idx < ea_count; ++idx) {
+        size_t const name_length{ 1 + idx % 5 };
+        size_t const value_length{ idx % 23 };
+        emplace_back_ea(eas,
+                        name_length,
+                        value_length,
+                        [idx, name_length, value_length](char *name) noexcept {
+                            for (size_t i = 0; i < name_length + value_length; ++i) {
+                                name[i] = static_cast<char>(idx + i);
+                            }
+                        });
+    }
+}
+
+void compare_ea_validation() {
+    builder_ea_list eas;
+    fill_builder_eas(eas, 200);
+    FFL_CODDING_ERROR_IF_NOT(200 == eas.size());
+    FFL_CODDING_ERROR_IF_NOT(eas.revalidate_data());
+
+    std::mt19937 generator{ 41 };
+    std::uniform_int_distribution<size_t> offset_distribution{ 0, eas.used_capacity() - 1 };
+    std::uniform_int_distribution<int> byte_distribution{ 0, 255 };
+    size_t valid_count{ 0 };
+    for (size_t iteration = 0; iteration < 1000; ++iteration) {
+        std::vector<char> buffer{ eas.data(), eas.data() + eas.used_capacity() };
+        if (0 != iteration) {
+            buffer[offset_distribution(generator)] = static_cast<char>(byte_distribution(generator));
+        }
+        size_t const buffer_size{ buffer.size() - iteration % 3 };
+        auto const [expected_valid, expected_ref] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION>(buffer.data(),
+                                                                                                                buffer.data() + buffer_size);
+        auto const [is_valid, ref] = iffl::flat_forward_list_validate<FILE_FULL_EA_INFORMATION, builder_ea_traits>(buffer.data(),
+                                                                                                                    buffer.data() + buffer_size);
+        FFL_CODDING_ERROR_IF_NOT(expected_valid == is_valid);
+        FFL_CODDING_ERROR_IF_NOT(expected_ref.size() == ref.size());
+        valid_count += is_valid ? 1 : 0;
+    }
+    std::printf("Generated and hand-written EA traits agree on 1000 buffers, %zu are valid\n", valid_count);
+}
+
+void compare_char_array_validation() {
+    builder_char_array_list arrays;
+    for (unsigned short length = 0; length < 100; ++length) {
+        arrays.emplace_back(builder_char_array_traits::minimum_size() + length,
+                            [length](char_array_list_entry &e, size_t) noexcept {
+                                e.length = length;
+                                for (unsigned short i = 0; i < length; ++i) {
+                                    e.arr[i] = static_cast<char>(i);
+                                }
+                            });
+    }
+    FFL_CODDING_ERROR_IF_NOT(100 == arrays.size());
+    FFL_CODDING_ERROR_IF_NOT(arrays.revalidate_data());
+
+    std::mt19937 generator{ 41 };
+    std::uniform_int_distribution<size_t> offset_distribution{ 0, arrays.used_capacity() - 1 };
+    std::uniform_int_distribution<int> byte_distribution{ 0, 255 };
+    for (size_t iteration = 0; iteration < 1000; ++iteration) {
+        std::vector<char> buffer{ arrays.data(), arrays.data() + arrays.used_capacity() };
+        buffer[offset_distribution(generator)] = static_cast<char>(byte_distribution(generator));
+        auto const [expected_valid, expected_ref] = iffl::flat_forward_list_validate<char_array_list_entry>(buffer.data(),
+                                                                                                             buffer.data() + buffer.size());
+        auto const [is_valid, ref] = iffl::flat_forward_list_validate<char_array_list_entry, builder_char_array_traits>(buffer.data(),
+                                                                                                                         buffer.data() + buffer.size());
+        FFL_CODDING_ERROR_IF_NOT(expected_valid == is_valid);
+        FFL_CODDING_ERROR_IF_NOT(expected_ref.size() == ref.size());
+    }
+    std::printf("Generated and hand-written array traits agree on 1000 buffers\n");
+}
+
+void run_ffl_traits_builder_usecase() {
+    compare_ea_validation();
+    compare_char_array_validation();
+}
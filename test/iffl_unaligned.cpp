@@ -18,6 +18,14 @@
 //  process_unaligned_view iterates over list and prints info about every 
 //  element that is not properly aligned.
 //
+//  process_aligned_copies iterates over the same list using
+//  flat_forward_list_aligned_view, which copies elements that are not
+//  aligned, so loop can access fields without unaligned pointers.
+//
+//  realign_unaligned_list copies list to a container with default traits,
+//  that pad elements to alignment, using flat_forward_list_realign, and
+//  using parallel_realign.
+//
 
 template <typename T>
 struct flat_forward_list_traits_unaligned {
@@ -124,9 +132,98 @@ void process_unaligned_view(unaligned_char_array_list_view const &data) {
     }
 }
 
+void process_aligned_copies(unaligned_char_array_list_view const &data) {
+    iffl::debug_memory_resource dbg_resource;
+    {
+        //
+        // Elements up to 16 bytes are copied to the iterator,
+        // larger elements are copied to the scratch buffer
+        //
+        iffl::flat_forward_list_aligned_view<char_array_list_entry,
+                                             flat_forward_list_traits_unaligned<char_array_list_entry::type>,
+                                             16> aligned{ data, &dbg_resource };
+        size_t element_count{ 0 };
+        size_t copy_count{ 0 };
+        for (auto cur{ aligned.begin() }; cur != aligned.end(); ++cur) {
+            char_array_list_entry const &e{ *cur };
+            FFL_CODDING_ERROR_IF_NOT(iffl::roundup_ptr_to_alignment<char_array_list_entry>(&e) == &e);
+            FFL_CODDING_ERROR_IF_NOT(element_count == e.length);
+            for (size_t idx = 0; idx < e.length; ++idx) {
+                FFL_CODDING_ERROR_IF_NOT(static_cast<char>(e.length + 1) == e.arr[idx]);
+            }
+            unaligned_char_array_list_entry_const_ptr unaligned_e_ptr{ &*cur.base() };
+            FFL_CODDING_ERROR_IF_NOT(cur.is_copy() == (static_cast<void const *>(unaligned_e_ptr) != &e));
+            if (cur.is_copy()) {
+                ++copy_count;
+            }
+            ++element_count;
+        }
+        FFL_CODDING_ERROR_IF_NOT(data.size() == element_count);
+        FFL_CODDING_ERROR_IF_NOT(0 < copy_count);
+        FFL_CODDING_ERROR_IF_NOT(0 < aligned.scratch_capacity());
+        FFL_CODDING_ERROR_IF_NOT(1 == dbg_resource.get_busy_blocks_count());
+        std::printf("Aligned view copied %zu of %zu elements, scratch buffer is %zu bytes\n",
+                    copy_count,
+                    element_count,
+                    aligned.scratch_capacity());
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == dbg_resource.get_busy_blocks_count());
+}
+
+void realign_unaligned_list(unaligned_char_array_list_view const &data) {
+    iffl::debug_memory_resource dbg_resource;
+    {
+        char_array_list aligned{ iffl::flat_forward_list_realign(data, char_array_list::allocator_type{ &dbg_resource }) };
+        FFL_CODDING_ERROR_IF_NOT(data.size() == aligned.size());
+        FFL_CODDING_ERROR_IF_NOT(aligned.used_capacity() == aligned.total_capacity());
+        auto cur{ data.cbegin() };
+        for (char_array_list_entry const &e : aligned) {
+            FFL_CODDING_ERROR_IF_NOT(iffl::roundup_ptr_to_alignment<char_array_list_entry>(&e) == &e);
+            unaligned_char_array_list_entry_const_ptr unaligned_e_ptr{ &*cur };
+            FFL_CODDING_ERROR_IF_NOT(unaligned_e_ptr->length == e.length);
+            FFL_CODDING_ERROR_IF_NOT(std::equal(e.arr, e.arr + e.length, unaligned_e_ptr->arr));
+            ++cur;
+        }
+        //
+        // Parallel version places elements at the same offsets
+        //
+        char_array_list parallel_aligned{ iffl::parallel_realign(data, char_array_list::allocator_type{ &dbg_resource }) };
+        FFL_CODDING_ERROR_IF_NOT(aligned.used_capacity() == parallel_aligned.used_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(aligned.data(), parallel_aligned.data(), aligned.used_capacity()));
+        std::printf("Realigned list of %zu elements from %zu to %zu bytes\n",
+                    aligned.size(),
+                    data.used_capacity(),
+                    aligned.used_capacity());
+        //
+        // Default allocator matches default allocator of the container
+        //
+        iffl::flat_forward_list<char_array_list_entry> default_aligned{ iffl::flat_forward_list_realign(data) };
+        iffl::flat_forward_list<char_array_list_entry> default_parallel_aligned{ iffl::parallel_realign(data) };
+        FFL_CODDING_ERROR_IF_NOT(aligned.used_capacity() == default_aligned.used_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(aligned.data(), default_aligned.data(), aligned.used_capacity()));
+        FFL_CODDING_ERROR_IF_NOT(aligned.used_capacity() == default_parallel_aligned.used_capacity());
+        FFL_CODDING_ERROR_IF_NOT(0 == std::memcmp(aligned.data(), default_parallel_aligned.data(), aligned.used_capacity()));
+    }
+    FFL_CODDING_ERROR_IF_NOT(0 == dbg_resource.get_busy_blocks_count());
+}
+
 void run_ffl_unaligned() {
     iffl::debug_memory_resource dbg_resource;
     unaligned_char_array_list data{ &dbg_resource };
     populate_container_of_unaligned_elements(data, 30);
     process_unaligned_view(unaligned_char_array_list_view{ data });
+    process_aligned_copies(unaligned_char_array_list_view{ data });
+    realign_unaligned_list(unaligned_char_array_list_view{ data });
+
+    unaligned_char_array_list large_data{ &dbg_resource };
+    for (size_t idx = 0; idx < 20000; ++idx) {
+        unsigned short const length{ static_cast<unsigned short>(idx % 40) };
+        large_data.emplace_back(unaligned_char_array_list::traits::minimum_size() + length,
+                                [length](char_array_list_entry &e, size_t) noexcept {
+                                    unaligned_char_array_list_entry_ptr unaligned_e_ptr{ &e };
+                                    unaligned_e_ptr->length = length;
+                                    std::fill(unaligned_e_ptr->arr, unaligned_e_ptr->arr + length, static_cast<char>(length));
+                                });
+    }
+    realign_unaligned_list(unaligned_char_array_list_view{ large_data });
 }
@@ -0,0 +1,206 @@
+#include "iffl.h"
+#include "iffl_variant_list_usecase.h"
+
+//
+//  This sample demonstrates list of records of different types
+//  that share a common header with a tag.
+//
+//  build_variant_list adds points and names to the list, and uses
+//  visit to process each record by its type.
+//
+//  validate_variant_list checks that records with unknown tag and
+//  records that do not pass validation of their type are rejected.
+//
+
+#include <cstddef>
+#include <cstring>
+
+struct variant_record_header {
+    uint32_t next_offset;
+    uint16_t tag;
+    uint16_t reserved;
+};
+
+enum variant_record_tag : uint16_t {
+    variant_point_tag = 1,
+    variant_name_tag = 2,
+};
+
+struct variant_point_record {
+    variant_record_header header;
+    int32_t x;
+    int32_t y;
+};
+
+struct variant_name_record {
+    variant_record_header header;
+    uint16_t length;
+    char name[1];
+};
+
+namespace iffl {
+    template <>
+    struct flat_forward_list_traits<variant_record_header> {
+        constexpr static size_t const alignment{ alignof(variant_record_header) };
+        constexpr static size_t minimum_size() noexcept {
+            return sizeof(variant_record_header);
+        }
+        constexpr static uint16_t get_tag(variant_record_header const &e) noexcept {
+            return e.tag;
+        }
+        constexpr static size_t get_next_offset(variant_record_header const &e) noexcept {
+            return e.next_offset;
+        }
+        constexpr static void set_next_offset(variant_record_header &e, size_t size) noexcept {
+            e.next_offset = static_cast<uint32_t>(size);
+        }
+    };
+
+    template <>
+    struct flat_forward_list_traits<variant_point_record> {
+        constexpr static uint16_t const tag{ variant_point_tag };
+        constexpr static size_t const alignment{ alignof(variant_point_record) };
+        constexpr static size_t const fixed_size{ sizeof(variant_point_record) };
+        constexpr static size_t minimum_size() noexcept {
+            return sizeof(variant_point_record);
+        }
+    };
+
+    template <>
+    struct flat_forward_list_traits<variant_name_record> {
+        constexpr static uint16_t const tag{ variant_name_tag };
+        constexpr static size_t const alignment{ alignof(variant_name_record) };
+        constexpr static size_t minimum_size() noexcept {
+            return offsetof(variant_name_record, name);
+        }
+        constexpr static size_t get_size(variant_name_record const &e) noexcept {
+            return offsetof(variant_name_record, name) + e.length;
+        }
+        //
+        // Name must be zero terminated
+        //
+        static bool validate(size_t buffer_size, variant_name_record const &e) noexcept {
+            return 0 < e.length &&
+                   get_size(e) <= buffer_size &&
+                   '\0' == e.name[e.length - 1];
+        }
+    };
+}
+
+using variant_record_list = iffl::pmr_flat_forward_variant_list<variant_record_header,
+                                                                variant_point_record,
+                                                                variant_name_record>;
+
+static_assert(variant_record_list::traits_traits::has_next_offset_v);
+static_assert(iffl::flat_forward_variant_has_unique_tags<variant_record_header, variant_point_record, variant_name_record>());
+static_assert(!iffl::flat_forward_variant_has_unique_tags<variant_record_header, variant_point_record, variant_point_record>());
+static_assert(4 == variant_record_list::traits_traits::alignment);
+static_assert(sizeof(variant_record_header) == variant_record_list::traits_traits::minimum_size());
+
+void append_variant_point(variant_record_list &records, int32_t x, int32_t y) {
+    records.emplace_back(sizeof(variant_point_record),
+                         [x, y](variant_record_header &e, size_t) noexcept {
+                             variant_point_record &point{ reinterpret_cast<variant_point_record &>(e) };
+                             point.header.tag = variant_point_tag;
+                             point.header.reserved = 0;
+                             point.x = x;
+                             point.y = y;
+                         });
+}
+
+void append_variant_name(variant_record_list &records, char const *name) {
+    size_t const length{ std::strlen(name) + 1 };
+    records.emplace_back(offsetof(variant_name_record, name) + length,
+                         [name, length](variant_record_header &e, size_t) noexcept {
+                             variant_name_record &record{ reinterpret_cast<variant_name_record &>(e) };
+                             record.header.tag = variant_name_tag;
+                             record.header.reserved = 0;
+                             record.length = static_cast<uint16_t>(length);
+                             std::memcpy(record.name, name, length);
+                         });
+}
+
+void fill_variant_list(variant_record_list &records) {
+    append_variant_point(records, 1, 2);
+    append_variant_name(records, "first");
+    append_variant_point(records, 3, 4);
+    append_variant_name(records, "second");
+    append_variant_name(records, "third");
+    append_variant_point(records, 5, 6);
+}
+
+void build_variant_list() {
+    variant_record_list records;
+    fill_variant_list(records);
+    FFL_CODDING_ERROR_IF_NOT(6 == records.size());
+    FFL_CODDING_ERROR_IF_NOT(records.revalidate_data());
+
+    int32_t coordinates_sum{ 0 };
+    size_t names_length{ 0 };
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        visit(it, iffl::overloaded{
+            [&coordinates_sum](variant_point_record &point) noexcept {
+                coordinates_sum += point.x + point.y;
+                point.x = -point.x;
+            },
+            [&names_length](variant_name_record &record) noexcept {
+                names_length += std::strlen(record.name);
+            }
+        });
+    }
+    FFL_CODDING_ERROR_IF_NOT(21 == coordinates_sum);
+    FFL_CODDING_ERROR_IF_NOT(16 == names_length);
+    //
+    // Visiting const elements, and returning a value
+    //
+    int32_t x_sum{ 0 };
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        x_sum += visit(it, iffl::overloaded{
+            [](variant_point_record const &point) noexcept {
+                return point.x;
+            },
+            [](variant_name_record const &) noexcept {
+                return int32_t{ 0 };
+            }
+        });
+    }
+    FFL_CODDING_ERROR_IF_NOT(-9 == x_sum);
+    //
+    // Element sizes come from traits of each record type
+    //
+    FFL_CODDING_ERROR_IF_NOT(sizeof(variant_point_record) == records.required_size(records.begin()));
+    FFL_CODDING_ERROR_IF_NOT(offsetof(variant_name_record, name) + 6 == records.required_size(records.last()));
+    std::printf("Visited %zu records of different types\n", records.size());
+}
+
+void validate_variant_list() {
+    variant_record_list records;
+    fill_variant_list(records);
+    //
+    // Unknown tag
+    //
+    auto it{ records.begin() };
+    ++it;
+    ++it;
+    it->tag = 7;
+    FFL_CODDING_ERROR_IF(records.revalidate_data());
+    //
+    // Name that is not zero terminated
+    //
+    variant_record_list names;
+    append_variant_name(names, "abc");
+    append_variant_name(names, "def");
+    variant_name_record *record{ reinterpret_cast<variant_name_record *>(names.data()) };
+    record->name[record->length - 1] = 'x';
+    FFL_CODDING_ERROR_IF(names.revalidate_data());
+    record->name[record->length - 1] = '\0';
+    FFL_CODDING_ERROR_IF_NOT(names.revalidate_data());
+    FFL_CODDING_ERROR_IF_NOT(2 == names.size());
+
+    std::printf("Records with unknown tag and invalid records were rejected\n");
+}
+
+void run_ffl_variant_list_usecase() {
+    build_variant_list();
+    validate_variant_list();
+}